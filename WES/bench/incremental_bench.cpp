@@ -0,0 +1,142 @@
+/**
+ * @brief Per-iteration latency of the INCREMENTAL solver against the SPARSE rebuild
+ *
+ * Usage: incremental_bench [stock_file] [iterations] [backlog] [arrivals] [N] [seed]
+ * Both pipelines start from the same backlog and receive the same arrivals every
+ * iteration; assigned orders leave the backlog as they would after completion.
+ */
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <unordered_set>
+#include "order.h"
+#include "stock.h"
+#include "shelf_selection.h"
+
+namespace {
+
+class OrderStream {
+public:
+    OrderStream(const SS::StockManager& stock, int seed) : rng_(seed) {
+        for (SS::ItemIdx item = 0; item < stock.get_item_ids().size(); item++) {
+            if (!stock.get_item_locations(item).empty()) {
+                items_.push_back(item);
+            }
+        }
+    }
+
+    std::vector<SS::Order> next(int count) {
+        static const int priorities[] = {1, 10, 50, 100};
+        std::uniform_int_distribution<size_t> item_dist(0, items_.size() - 1);
+        std::uniform_int_distribution<int> priority_dist(0, 3);
+        std::vector<SS::Order> orders;
+        for (int i = 0; i < count; i++) {
+            SS::Order order{"ORD_" + std::to_string(next_id_), "", 1, SS::TimePoint(), SS::TimePoint(),
+                            priorities[priority_dist(rng_)]};
+            order.order_idx = next_id_++;
+            order.item_idx = items_[item_dist(rng_)];
+            orders.push_back(order);
+        }
+        return orders;
+    }
+
+private:
+    std::mt19937 rng_;
+    std::vector<SS::ItemIdx> items_;
+    SS::OrderIdx next_id_ = 0;
+};
+
+struct Pipeline {
+    SS::StockManager stock;
+    SS::ShelfSelection selector;
+    std::vector<SS::Order> backlog;
+    std::vector<double> latencies;
+
+    Pipeline(const SS::StockManager& base, SS::SolverMode mode)
+        : stock(base), selector(stock, mode) {}
+
+    void tick(const std::vector<SS::Order>& arrivals, int N) {
+        for (const auto& order : arrivals) {
+            backlog.push_back(order); // Order has const members, so no range insert
+        }
+
+        SS::Taskpool pending;
+        SS::Taskpool taskpool = selector.run(backlog, pending, N);
+        const SS::MCFStats& stats = selector.get_last_stats();
+        latencies.push_back(stats.build_ms + stats.solve_ms);
+
+        // Assigned orders are completed
+        std::unordered_set<SS::OrderIdx> assigned;
+        for (const auto& [rack, faces] : taskpool) {
+            for (const auto& [face, orders] : faces) {
+                assigned.insert(orders.begin(), orders.end());
+            }
+        }
+        std::vector<SS::Order> remaining;
+        for (const auto& order : backlog) {
+            if (!assigned.count(order.order_idx)) {
+                remaining.push_back(order);
+            }
+        }
+        backlog.swap(remaining);
+    }
+};
+
+double percentile(std::vector<double> values, double p) {
+    std::sort(values.begin(), values.end());
+    return values[static_cast<size_t>(p * (values.size() - 1))];
+}
+
+}
+
+int main(int argc, char** argv) {
+    const std::string stock_file = argc > 1 ? argv[1] : "data/raw/stock.json";
+    const int iterations = argc > 2 ? std::stoi(argv[2]) : 50;
+    const int initial_backlog = argc > 3 ? std::stoi(argv[3]) : 5000;
+    const int arrivals = argc > 4 ? std::stoi(argv[4]) : 1500;
+    const int N = argc > 5 ? std::stoi(argv[5]) : 1500;
+    const int seed = argc > 6 ? std::stoi(argv[6]) : 28;
+
+    try {
+        const SS::StockManager base_stock(stock_file);
+        OrderStream stream(base_stock, seed);
+
+        Pipeline rebuild(base_stock, SS::SolverMode::SPARSE);
+        Pipeline incremental(base_stock, SS::SolverMode::INCREMENTAL);
+
+        std::cout << std::setw(6) << "iter"
+                  << std::setw(10) << "backlog"
+                  << std::setw(14) << "rebuild_ms"
+                  << std::setw(14) << "incr_ms"
+                  << std::setw(12) << "rebuilt"
+                  << std::setw(12) << "components" << std::endl;
+
+        for (int i = 0; i < iterations; i++) {
+            std::vector<SS::Order> new_orders = stream.next(i == 0 ? initial_backlog : arrivals);
+            rebuild.tick(new_orders, N);
+            incremental.tick(new_orders, N);
+
+            const SS::MCFStats& stats = incremental.selector.get_last_stats();
+            std::cout << std::setw(6) << i + 1
+                      << std::setw(10) << incremental.backlog.size()
+                      << std::fixed << std::setprecision(2)
+                      << std::setw(14) << rebuild.latencies.back()
+                      << std::setw(14) << incremental.latencies.back()
+                      << std::setw(12) << stats.rebuilt_components
+                      << std::setw(12) << stats.components << std::endl;
+        }
+
+        std::cout << "p50 latency: rebuild " << percentile(rebuild.latencies, 0.5)
+                  << " ms, incremental " << percentile(incremental.latencies, 0.5) << " ms" << std::endl;
+        std::cout << "p95 latency: rebuild " << percentile(rebuild.latencies, 0.95)
+                  << " ms, incremental " << percentile(incremental.latencies, 0.95) << " ms" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
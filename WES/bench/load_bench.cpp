@@ -0,0 +1,197 @@
+/**
+ * @brief Compares the DOM, SAX and simdjson loaders of stock.json and backlog.json
+ *
+ * Usage: load_bench [stock_file] [backlog_file] [runs]
+ * Each load runs in a forked child, so the peak RSS reported by wait4 belongs to that
+ * parser alone. The children send back a checksum of what they loaded, every parser
+ * must produce the same StockManager indices and the same orders as the DOM one.
+ */
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "json_parser.h"
+#include "order.h"
+#include "stock.h"
+
+namespace {
+
+struct Result {
+    bool ok = false;
+    double ms = 0;
+    long peak_rss_kb = 0;
+    uint64_t checksum = 0;
+    size_t count = 0;
+};
+
+struct Report {
+    double ms;
+    uint64_t checksum;
+    size_t count;
+};
+
+uint64_t mix(uint64_t hash, const std::string& value) {
+    for (unsigned char c : value) {
+        hash = (hash ^ c) * 1099511628211ULL;
+    }
+    return (hash ^ 0xff) * 1099511628211ULL;
+}
+
+uint64_t mix(uint64_t hash, int64_t value) {
+    return mix(hash, std::to_string(value));
+}
+
+// Names in index order plus every item location, so a different intern order shows up
+uint64_t stock_checksum(const SS::StockManager& stock) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (SS::RackIdx rack = 0; rack < stock.num_racks(); rack++) {
+        hash = mix(hash, stock.get_rack_ids().name(rack));
+    }
+    for (SS::FaceIdx face = 0; face < stock.num_faces(); face++) {
+        hash = mix(hash, stock.get_face_ids().name(face));
+    }
+    for (SS::ItemIdx item = 0; item < stock.get_item_ids().size(); item++) {
+        hash = mix(hash, stock.get_item_ids().name(item));
+        for (const auto& location : stock.get_item_locations(item)) {
+            hash = mix(hash, location.rack);
+            hash = mix(hash, location.face);
+            hash = mix(hash, stock.get_item_quantity(location.rack, location.face, item));
+        }
+    }
+    return hash;
+}
+
+uint64_t orders_checksum(const std::vector<SS::Order>& orders) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (const auto& order : orders) {
+        hash = mix(hash, order.order_id);
+        hash = mix(hash, order.item_id);
+        hash = mix(hash, order.quantity);
+        hash = mix(hash, order.creation_date.time_since_epoch().count());
+        hash = mix(hash, order.due_date.time_since_epoch().count());
+    }
+    return hash;
+}
+
+Report load(bool stock_file, const std::string& path, SS::JsonParser parser) {
+    auto start = std::chrono::steady_clock::now();
+    if (stock_file) {
+        SS::StockManager stock(path, SS::StockBackend::FLAT, parser);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return {ms, stock_checksum(stock), stock.get_item_ids().size()};
+    }
+    std::vector<SS::Order> orders = SS::read_orders_json(path, parser);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return {ms, orders_checksum(orders), orders.size()};
+}
+
+// Load in a child process and collect its time, checksum and peak RSS
+Result run_child(bool stock_file, const std::string& path, SS::JsonParser parser) {
+    Result result;
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return result;
+    }
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return result;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        int status = 0;
+        try {
+            Report report = load(stock_file, path, parser);
+            status = write(fds[1], &report, sizeof(report)) == sizeof(report) ? 0 : 1;
+        } catch (const std::exception& e) {
+            std::cerr << "Error (" << SS::to_string(parser) << "): " << e.what() << std::endl;
+            status = 1;
+        }
+        close(fds[1]);
+        _exit(status);
+    }
+
+    close(fds[1]);
+    Report report{};
+    bool received = read(fds[0], &report, sizeof(report)) == sizeof(report);
+    close(fds[0]);
+    int status = 0;
+    struct rusage usage {};
+    wait4(pid, &status, 0, &usage);
+    result.ok = received && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    result.ms = report.ms;
+    result.checksum = report.checksum;
+    result.count = report.count;
+    result.peak_rss_kb = usage.ru_maxrss;
+    return result;
+}
+
+bool bench_file(bool stock_file, const std::string& path, int runs) {
+    std::cout << "\n" << (stock_file ? "Stock: " : "Backlog: ") << path << std::endl;
+    std::cout << std::left << std::setw(8) << "parser"
+              << std::right << std::setw(10) << (stock_file ? "items" : "orders")
+              << std::setw(12) << "best ms"
+              << std::setw(14) << "peak RSS MB"
+              << std::setw(8) << "match" << std::endl;
+
+    bool all_match = true;
+    uint64_t reference = 0;
+    bool have_reference = false;
+    for (SS::JsonParser parser : {SS::JsonParser::DOM, SS::JsonParser::SAX, SS::JsonParser::SIMD}) {
+        if (!SS::has_json_parser(parser)) {
+            std::cout << std::left << std::setw(8) << SS::to_string(parser) << "  not compiled in" << std::endl;
+            continue;
+        }
+        Result best;
+        for (int run = 0; run < runs; run++) {
+            Result result = run_child(stock_file, path, parser);
+            if (!result.ok) {
+                best = result;
+                break;
+            }
+            if (run == 0 || result.ms < best.ms) {
+                best = result;
+            }
+        }
+        if (!best.ok) {
+            std::cout << std::left << std::setw(8) << SS::to_string(parser) << "  failed" << std::endl;
+            all_match = false;
+            continue;
+        }
+        if (!have_reference) {
+            reference = best.checksum;
+            have_reference = true;
+        }
+        bool match = best.checksum == reference;
+        all_match = all_match && match;
+        std::cout << std::left << std::setw(8) << SS::to_string(parser)
+                  << std::right << std::setw(10) << best.count
+                  << std::setw(12) << std::fixed << std::setprecision(2) << best.ms
+                  << std::setw(14) << std::setprecision(1) << best.peak_rss_kb / 1024.0
+                  << std::setw(8) << (match ? "yes" : "NO") << std::endl;
+    }
+    return all_match;
+}
+
+}
+
+int main(int argc, char** argv) {
+    const std::string stock_file = argc > 1 ? argv[1] : "data/raw/stock.json";
+    const std::string backlog_file = argc > 2 ? argv[2] : "data/raw/backlog.json";
+    const int runs = argc > 3 ? std::stoi(argv[3]) : 3;
+
+    std::cout << "Default parser: " << SS::to_string(SS::default_json_parser()) << std::endl;
+    bool ok = bench_file(true, stock_file, runs);
+    ok = bench_file(false, backlog_file, runs) && ok;
+    if (!ok) {
+        std::cerr << "Parsers disagree or failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
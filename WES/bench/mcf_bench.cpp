@@ -0,0 +1,151 @@
+/**
+ * @brief Compares the solver modes of ShelfSelection::solve_mcf on one backlog
+ *
+ * Usage: mcf_bench [stock_file] [num_orders] [limit] [seed] [max_quantity]
+ * Orders are generated from the items present in the stock file, with quantities
+ * drawn from 1..max_quantity (1 unless set); limit counts units.
+ * FIXED_CHARGE runs with the default TripCosts and also reports the racks it saved.
+ */
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+#include "order.h"
+#include "stock.h"
+#include "shelf_selection.h"
+
+namespace {
+
+std::vector<SS::Order> make_orders(const SS::StockManager& stock, int num_orders, int seed, int max_quantity) {
+    std::vector<SS::ItemIdx> items;
+    for (SS::ItemIdx item = 0; item < stock.get_item_ids().size(); item++) {
+        for (size_t i = 0; i < stock.get_item_locations(item).size(); i++) {
+            items.push_back(item);
+        }
+    }
+
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<size_t> item_dist(0, items.size() - 1);
+    const int priorities[] = {1, 10, 50, 100};
+    std::uniform_int_distribution<int> priority_dist(0, 3);
+    std::uniform_int_distribution<int> quantity_dist(1, std::max(1, max_quantity));
+
+    std::vector<SS::Order> orders;
+    orders.reserve(num_orders);
+    for (int i = 0; i < num_orders; i++) {
+        SS::ItemIdx item = items[item_dist(rng)];
+        SS::Order order{
+            "ORD_" + std::to_string(i),
+            stock.get_item_ids().name(item),
+            max_quantity > 1 ? quantity_dist(rng) : 1,
+            SS::TimePoint(),
+            SS::TimePoint(),
+            priorities[priority_dist(rng)]
+        };
+        order.order_idx = i;
+        order.item_idx = item;
+        orders.push_back(order);
+    }
+    return orders;
+}
+
+void print_stats(const char* name, const SS::MCFStats& stats) {
+    std::cout << std::left << std::setw(8) << name
+              << std::right << std::setw(10) << stats.num_nodes
+              << std::setw(12) << stats.num_arcs
+              << std::setw(12) << std::fixed << std::setprecision(2) << stats.build_ms
+              << std::setw(12) << stats.solve_ms
+              << std::setw(14) << stats.optimal_cost
+              << std::setw(10) << stats.assigned_orders
+              << std::setw(8) << stats.assigned_units
+              << std::setw(8) << stats.split_orders
+              << std::setw(8) << stats.racks_opened << std::endl;
+}
+
+}
+
+int main(int argc, char** argv) {
+    const std::string stock_file = argc > 1 ? argv[1] : "data/raw/stock.json";
+    const int num_orders = argc > 2 ? std::stoi(argv[2]) : 5000;
+    const int limit = argc > 3 ? std::stoi(argv[3]) : 1500;
+    const int seed = argc > 4 ? std::stoi(argv[4]) : 28;
+    const int max_quantity = argc > 5 ? std::stoi(argv[5]) : 1;
+
+    try {
+        const SS::StockManager base_stock(stock_file);
+        std::vector<SS::Order> orders = make_orders(base_stock, num_orders, seed, max_quantity);
+        std::cout << "Racks: " << base_stock.num_racks()
+                  << ", orders: " << orders.size() << ", limit: " << limit << std::endl;
+
+        std::cout << std::left << std::setw(8) << "mode"
+                  << std::right << std::setw(10) << "nodes"
+                  << std::setw(12) << "arcs"
+                  << std::setw(12) << "build_ms"
+                  << std::setw(12) << "solve_ms"
+                  << std::setw(14) << "cost"
+                  << std::setw(10) << "assigned"
+                  << std::setw(8) << "units"
+                  << std::setw(8) << "splits"
+                  << std::setw(8) << "racks" << std::endl;
+
+        SS::StockManager dense_stock = base_stock;
+        SS::ShelfSelection dense(dense_stock, SS::SolverMode::DENSE);
+        dense.solve_mcf(orders, limit);
+        print_stats("dense", dense.get_last_stats());
+
+        SS::StockManager sparse_stock = base_stock;
+        SS::ShelfSelection sparse(sparse_stock, SS::SolverMode::SPARSE);
+        sparse.solve_mcf(orders, limit);
+        print_stats("sparse", sparse.get_last_stats());
+
+        SS::StockManager incremental_stock = base_stock;
+        SS::ShelfSelection incremental(incremental_stock, SS::SolverMode::INCREMENTAL);
+        incremental.solve_mcf(orders, limit);
+        print_stats("incr", incremental.get_last_stats());
+        if (incremental.get_last_stats().optimal_cost != sparse.get_last_stats().optimal_cost) {
+            std::cout << "INCREMENTAL and SPARSE objectives differ" << std::endl;
+        }
+
+        SS::StockManager parallel_stock = base_stock;
+        SS::ShelfSelection parallel(parallel_stock, SS::SolverMode::PARALLEL);
+        parallel.solve_mcf(orders, limit);
+        print_stats("par", parallel.get_last_stats());
+        if (parallel.get_last_stats().optimal_cost != sparse.get_last_stats().optimal_cost) {
+            std::cout << "PARALLEL and SPARSE objectives differ" << std::endl;
+        }
+
+        SS::StockManager greedy_stock = base_stock;
+        SS::ShelfSelection greedy(greedy_stock, SS::SolverMode::GREEDY);
+        greedy.solve_mcf(orders, limit);
+        print_stats("greedy", greedy.get_last_stats());
+        std::cout << "GREEDY gap to SPARSE: "
+                  << greedy.get_last_stats().optimal_cost - sparse.get_last_stats().optimal_cost << std::endl;
+
+        // Same throughput as SPARSE, fewer rack trips; its cost includes the fixed charges
+        SS::StockManager fixed_stock = base_stock;
+        SS::ShelfSelection fixed(fixed_stock, SS::SolverMode::FIXED_CHARGE);
+        fixed.solve_mcf(orders, limit);
+        print_stats("fixed", fixed.get_last_stats());
+        std::cout << "FIXED_CHARGE: " << fixed.get_last_stats().racks_opened << " racks vs "
+                  << fixed.get_last_stats().linear_racks_opened << " without trip costs, "
+                  << fixed.get_last_stats().iterations << " iterations"
+                  << (fixed.get_last_stats().timed_out ? " (time limit)" : "") << std::endl;
+        if (max_quantity == 1 && fixed.get_last_stats().assigned_orders != sparse.get_last_stats().assigned_orders) {
+            std::cout << "FIXED_CHARGE and SPARSE assign different numbers of orders" << std::endl;
+        }
+
+        // DENSE and SPARSE solve the same problem, only the graph layout differs. With
+        // multi-unit lines equal optima may route units that settle into different lines
+        const bool same = dense.get_last_stats().optimal_cost == sparse.get_last_stats().optimal_cost
+                       && (max_quantity > 1
+                           || dense.get_last_stats().assigned_orders == sparse.get_last_stats().assigned_orders);
+        std::cout << "Objective match: " << (same ? "yes" : "no") << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
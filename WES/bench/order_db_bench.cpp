@@ -0,0 +1,204 @@
+/**
+ * @brief Compares per-row and set-based status updates of OrderManager against Postgres,
+ * times the full and delta backlog fetches and ad-hoc vs prepared row inserts
+ *
+ * Usage: order_db_bench [stock_file] [num_orders] [completed] [stock_outs] [seed]
+ * Needs the database configured in .env. The orders go into a TEMP backlog table that
+ * shadows the real one for this session only, so the real backlog is never touched.
+ */
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <pqxx/pqxx>
+#include "db_connector.h"
+#include "order_manager.h"
+#include "stock.h"
+#include "utils.h"
+
+namespace {
+
+double elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void create_backlog(pqxx::connection& conn) {
+    pqxx::work txn(conn);
+    txn.exec(
+        "CREATE TEMP TABLE backlog ("
+            "order_id CHAR(25) PRIMARY KEY, "
+            "item_id CHAR(17), "
+            "quantity INTEGER DEFAULT 1, "
+            "creation_date TIMESTAMP, "
+            "due_date TIMESTAMP, "
+            "closure_date TIMESTAMP DEFAULT NULL, "
+            "status VARCHAR(11) DEFAULT 'PENDING', "
+            "seq BIGSERIAL)"
+    );
+    txn.commit();
+}
+
+void insert_orders(pqxx::connection& conn, const SS::StockManager& stock, int first, int count, std::mt19937& rng) {
+    pqxx::work txn(conn);
+    std::uniform_int_distribution<SS::ItemIdx> item_dist(0, stock.get_item_ids().size() - 1);
+    const std::string date = "2025-10-09T00:00:00";
+    auto stream = pqxx::stream_to::table(
+        txn, {"backlog"}, {"order_id", "item_id", "quantity", "creation_date", "due_date"});
+    for (int i = first; i < first + count; i++) {
+        stream.write_values("ORD_" + std::to_string(i), stock.get_item_ids().name(item_dist(rng)), 1, date, date);
+    }
+    stream.complete();
+    txn.commit();
+}
+
+void reset_backlog(pqxx::connection& conn) {
+    pqxx::work txn(conn);
+    txn.exec("UPDATE backlog SET status = 'PENDING', closure_date = NULL");
+    txn.commit();
+}
+
+// The update_completed_orders loop before it was batched
+void complete_per_row(pqxx::connection& conn, const std::vector<std::string>& order_ids) {
+    pqxx::work txn(conn);
+    std::string closure_str = SS::format_iso8601(std::chrono::system_clock::now());
+    for (const auto& order_id : order_ids) {
+        txn.exec_params(
+            "UPDATE backlog SET status = 'COMPLETED', closure_date = $1 WHERE order_id = $2",
+            closure_str, order_id
+        );
+    }
+    txn.commit();
+}
+
+// One UPDATE per stock out item
+void stock_out_per_row(pqxx::connection& conn, const std::vector<std::string>& item_ids) {
+    pqxx::work txn(conn);
+    std::string closure_str = SS::format_iso8601(std::chrono::system_clock::now());
+    for (const auto& item_id : item_ids) {
+        txn.exec_params(
+            "UPDATE backlog SET status = 'STOCK_OUT', closure_date = $1 "
+            "WHERE status = 'PENDING' AND item_id = $2",
+            closure_str, item_id
+        );
+    }
+    txn.commit();
+}
+
+// Per-row INSERT sent as text every time vs the statement prepared by DBConnector
+void insert_per_row(pqxx::connection& conn, const SS::StockManager& stock, const std::string& prefix,
+                    int count, bool prepared) {
+    pqxx::work txn(conn);
+    const std::string date = "2025-10-09T00:00:00";
+    for (int i = 0; i < count; i++) {
+        const std::string order_id = prefix + std::to_string(i);
+        const std::string& item_id = stock.get_item_ids().name(i % stock.get_item_ids().size());
+        if (prepared) {
+            txn.exec_prepared(SS::INSERT_ORDER_STMT, order_id, item_id, 1, date, date);
+        } else {
+            txn.exec_params(
+                "INSERT INTO backlog (order_id, item_id, quantity, creation_date, due_date) "
+                "VALUES ($1, $2, $3, $4, $5)",
+                order_id, item_id, 1, date, date
+            );
+        }
+    }
+    txn.commit();
+}
+
+void print_row(const char* name, size_t rows, double ms) {
+    std::cout << std::left << std::setw(20) << name
+              << std::right << std::setw(10) << rows
+              << std::setw(12) << std::fixed << std::setprecision(2) << ms
+              << std::setw(14) << std::setprecision(0) << (ms > 0 ? rows * 1000.0 / ms : 0.0) << std::endl;
+}
+
+}
+
+int main(int argc, char** argv) {
+    const std::string stock_file = argc > 1 ? argv[1] : "data/raw/stock.json";
+    const int num_orders = argc > 2 ? std::stoi(argv[2]) : 20000;
+    const int completed = argc > 3 ? std::stoi(argv[3]) : 2000;
+    const int stock_outs = argc > 4 ? std::stoi(argv[4]) : 200;
+    const int seed = argc > 5 ? std::stoi(argv[5]) : 28;
+
+    try {
+        SS::StockManager stock(stock_file);
+        SS::DBConnector db_connector;
+        pqxx::connection conn = db_connector.connect();
+        std::mt19937 rng(seed);
+        create_backlog(conn);
+        // Prepared after the TEMP table exists, so the statements resolve to it
+        SS::DBConnector::prepare_statements(conn);
+        insert_orders(conn, stock, 0, num_orders, rng);
+
+        // First fetch reads the whole backlog, the next one only the arrivals
+        const SS::TimePoint simulation_date = SS::parse_iso8601("2025-10-09T00:00:00");
+        SS::OrderManager order_manager(db_connector, stock);
+        auto fetch_start = std::chrono::steady_clock::now();
+        std::vector<SS::Order> backlog = order_manager.get_backlog_from_db(conn, simulation_date);
+        const double full_fetch_ms = elapsed_ms(fetch_start);
+        insert_orders(conn, stock, num_orders, completed, rng);
+        fetch_start = std::chrono::steady_clock::now();
+        order_manager.get_backlog_from_db(conn, simulation_date);
+        const double delta_fetch_ms = elapsed_ms(fetch_start);
+
+        // The first orders are completed in a single face, the first items run out
+        SS::Taskpool taskpool;
+        std::vector<std::string> order_ids;
+        for (int i = 0; i < completed && i < static_cast<int>(backlog.size()); i++) {
+            taskpool[0][0].push_back(backlog[i].order_idx);
+            order_ids.push_back(backlog[i].order_id);
+        }
+        std::vector<std::string> item_ids;
+        for (SS::ItemIdx item = 0; item < stock.get_item_ids().size() && static_cast<int>(item) < stock_outs; item++) {
+            stock.stock_out_items_.push_back(item);
+            item_ids.push_back(stock.get_item_ids().name(item));
+        }
+
+        std::cout << "Orders: " << backlog.size() << ", completed: " << order_ids.size()
+                  << ", stock out items: " << item_ids.size() << std::endl;
+        std::cout << std::left << std::setw(20) << "path"
+                  << std::right << std::setw(10) << "rows"
+                  << std::setw(12) << "ms"
+                  << std::setw(14) << "rows/sec" << std::endl;
+
+        print_row("fetch full", backlog.size(), full_fetch_ms);
+        print_row("fetch delta", completed, delta_fetch_ms);
+
+        auto start = std::chrono::steady_clock::now();
+        complete_per_row(conn, order_ids);
+        print_row("completed per-row", order_ids.size(), elapsed_ms(start));
+        reset_backlog(conn);
+
+        start = std::chrono::steady_clock::now();
+        order_manager.update_completed_orders(conn, taskpool);
+        print_row("completed set", order_ids.size(), elapsed_ms(start));
+        reset_backlog(conn);
+
+        start = std::chrono::steady_clock::now();
+        stock_out_per_row(conn, item_ids);
+        print_row("stock out per-row", item_ids.size(), elapsed_ms(start));
+        reset_backlog(conn);
+
+        start = std::chrono::steady_clock::now();
+        order_manager.update_stock_out_orders(conn);
+        print_row("stock out set", item_ids.size(), elapsed_ms(start));
+
+        start = std::chrono::steady_clock::now();
+        insert_per_row(conn, stock, "ADH_", completed, false);
+        print_row("insert ad-hoc", completed, elapsed_ms(start));
+
+        start = std::chrono::steady_clock::now();
+        insert_per_row(conn, stock, "PRE_", completed, true);
+        print_row("insert prepared", completed, elapsed_ms(start));
+
+        conn.close();
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,319 @@
+/**
+ * @brief Compares the min cost flow backends on shelf selection and random graphs
+ *
+ * Usage: solver_bench [stock_file] [num_orders] [limit] [seed] [num_small_graphs]
+ * Every backend compiled into wes_lib solves the same problems; objectives must match.
+ * Every backend also solves num_small_graphs random small graphs (20000 unless set),
+ * general ones with negative costs and infeasible supplies, checked against an exact
+ * successive shortest path reference.
+ */
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+#include "order.h"
+#include "stock.h"
+#include "mcf_solver.h"
+#include "shelf_selection.h"
+
+namespace {
+
+struct Arc {
+    int tail;
+    int head;
+    int capacity;
+    int cost;
+};
+
+struct Graph {
+    std::vector<int> supplies;
+    std::vector<Arc> arcs;
+};
+
+std::vector<SS::Order> make_orders(const SS::StockManager& stock, int num_orders, int seed) {
+    std::vector<SS::ItemIdx> items;
+    for (SS::ItemIdx item = 0; item < stock.get_item_ids().size(); item++) {
+        if (!stock.get_item_locations(item).empty()) {
+            items.push_back(item);
+        }
+    }
+
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<size_t> item_dist(0, items.size() - 1);
+    const int priorities[] = {1, 10, 50, 100};
+    std::uniform_int_distribution<int> priority_dist(0, 3);
+
+    std::vector<SS::Order> orders;
+    orders.reserve(num_orders);
+    for (int i = 0; i < num_orders; i++) {
+        SS::Order order{"ORD_" + std::to_string(i), "", 1, SS::TimePoint(), SS::TimePoint(),
+                        priorities[priority_dist(rng)]};
+        order.order_idx = i;
+        order.item_idx = items[item_dist(rng)];
+        orders.push_back(order);
+    }
+    return orders;
+}
+
+// Transportation problem: suppliers -> hubs -> customers, plus a costly overflow node that keeps it feasible
+Graph make_random_graph(int layer_size, int degree, int seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> node_dist(0, layer_size - 1);
+    std::uniform_int_distribution<int> capacity_dist(1, 20);
+    std::uniform_int_distribution<int> cost_dist(-100, 100);
+
+    Graph graph;
+    graph.supplies.assign(3 * layer_size + 1, 0);
+    const int overflow = 3 * layer_size;
+    long long total = 0;
+    for (int i = 0; i < layer_size; i++) {
+        int supply = capacity_dist(rng);
+        graph.supplies[i] = supply;
+        graph.supplies[2 * layer_size + i] = -supply / 2;
+        total += supply - supply / 2;
+        graph.arcs.push_back({i, overflow, supply, 10000});
+        graph.arcs.push_back({overflow, 2 * layer_size + i, supply / 2, 10000});
+        for (int d = 0; d < degree; d++) {
+            graph.arcs.push_back({i, layer_size + node_dist(rng), capacity_dist(rng), cost_dist(rng)});
+            graph.arcs.push_back({layer_size + i, 2 * layer_size + node_dist(rng), capacity_dist(rng),
+                                  cost_dist(rng)});
+        }
+    }
+    graph.supplies[overflow] = -static_cast<int>(total);
+    return graph;
+}
+
+// Small general graph: any arc between any two nodes, costs of both signs, supplies that may not fit
+Graph make_small_graph(std::mt19937& rng) {
+    std::uniform_int_distribution<int> size_dist(2, 8);
+    const int num_nodes = size_dist(rng);
+    std::uniform_int_distribution<int> node_dist(0, num_nodes - 1);
+    std::uniform_int_distribution<int> arc_count_dist(1, 12);
+    std::uniform_int_distribution<int> capacity_dist(1, 8);
+    std::uniform_int_distribution<int> cost_dist(-20, 20);
+    std::uniform_int_distribution<int> amount_dist(1, 4);
+
+    Graph graph;
+    graph.supplies.assign(num_nodes, 0);
+    for (int pair = std::uniform_int_distribution<int>(0, 2)(rng); pair > 0; pair--) {
+        const int amount = amount_dist(rng);
+        graph.supplies[node_dist(rng)] += amount;
+        graph.supplies[node_dist(rng)] -= amount;
+    }
+    for (int arc = arc_count_dist(rng); arc > 0; arc--) {
+        graph.arcs.push_back({node_dist(rng), node_dist(rng), capacity_dist(rng), cost_dist(rng)});
+    }
+    return graph;
+}
+
+// Exact reference: arcs of negative cost are saturated up front so every residual cost starts
+// non-negative, then successive Bellman-Ford shortest paths route the supplies. False if they do not fit
+bool reference_min_cost(const Graph& graph, long long& cost) {
+    const int num_nodes = static_cast<int>(graph.supplies.size());
+    const int source = num_nodes;
+    const int sink = num_nodes + 1;
+    std::vector<int> heads, residual;
+    std::vector<long long> costs;
+    std::vector<std::vector<int>> out(num_nodes + 2);
+    auto add = [&](int tail, int head, int capacity, long long arc_cost, int reverse_capacity) {
+        out[tail].push_back(static_cast<int>(heads.size()));
+        heads.push_back(head);
+        residual.push_back(capacity);
+        costs.push_back(arc_cost);
+        out[head].push_back(static_cast<int>(heads.size()));
+        heads.push_back(tail);
+        residual.push_back(reverse_capacity);
+        costs.push_back(-arc_cost);
+    };
+
+    cost = 0;
+    std::vector<long long> supplies(graph.supplies.begin(), graph.supplies.end());
+    for (const Arc& arc : graph.arcs) {
+        if (arc.cost < 0) {
+            cost += static_cast<long long>(arc.capacity) * arc.cost;
+            supplies[arc.tail] -= arc.capacity;
+            supplies[arc.head] += arc.capacity;
+            add(arc.head, arc.tail, arc.capacity, -arc.cost, 0);
+        } else {
+            add(arc.tail, arc.head, arc.capacity, arc.cost, 0);
+        }
+    }
+    long long required = 0;
+    for (int node = 0; node < num_nodes; node++) {
+        if (supplies[node] > 0) {
+            add(source, node, static_cast<int>(supplies[node]), 0, 0);
+            required += supplies[node];
+        } else if (supplies[node] < 0) {
+            add(node, sink, static_cast<int>(-supplies[node]), 0, 0);
+        }
+    }
+
+    const long long unreached = std::numeric_limits<long long>::max();
+    while (required > 0) {
+        std::vector<long long> distance(num_nodes + 2, unreached);
+        std::vector<int> via(num_nodes + 2, -1);
+        distance[source] = 0;
+        for (bool changed = true; changed;) {
+            changed = false;
+            for (int node = 0; node < num_nodes + 2; node++) {
+                if (distance[node] == unreached) {
+                    continue;
+                }
+                for (int arc : out[node]) {
+                    if (residual[arc] > 0 && distance[node] + costs[arc] < distance[heads[arc]]) {
+                        distance[heads[arc]] = distance[node] + costs[arc];
+                        via[heads[arc]] = arc;
+                        changed = true;
+                    }
+                }
+            }
+        }
+        if (distance[sink] == unreached) {
+            return false;
+        }
+        long long amount = required;
+        for (int node = sink; node != source; node = heads[via[node] ^ 1]) {
+            amount = std::min<long long>(amount, residual[via[node]]);
+        }
+        for (int node = sink; node != source; node = heads[via[node] ^ 1]) {
+            residual[via[node]] -= static_cast<int>(amount);
+            residual[via[node] ^ 1] += static_cast<int>(amount);
+        }
+        cost += amount * distance[sink];
+        required -= amount;
+    }
+    return true;
+}
+
+// Solves num_graphs small graphs with every backend, returns the graphs whose status or cost differ from the reference
+int check_small_graphs(const std::vector<SS::MCFBackend>& backends, int num_graphs, int seed) {
+    std::mt19937 rng(seed);
+    int mismatches = 0;
+    int infeasible = 0;
+    for (int i = 0; i < num_graphs; i++) {
+        const Graph graph = make_small_graph(rng);
+        long long expected = 0;
+        const bool feasible = reference_min_cost(graph, expected);
+        infeasible += feasible ? 0 : 1;
+        bool same = true;
+        for (SS::MCFBackend backend : backends) {
+            auto solver = SS::make_mcf_solver(backend);
+            for (size_t node = 0; node < graph.supplies.size(); node++) {
+                solver->set_node_supply(static_cast<int>(node), graph.supplies[node]);
+            }
+            for (const auto& arc : graph.arcs) {
+                solver->add_arc(arc.tail, arc.head, arc.capacity, arc.cost);
+            }
+            const SS::MCFStatus status = solver->solve();
+            same = same && (feasible ? status == SS::MCFStatus::OPTIMAL && solver->optimal_cost() == expected
+                                     : status == SS::MCFStatus::INFEASIBLE);
+        }
+        mismatches += same ? 0 : 1;
+    }
+    std::cout << "Reference check: " << num_graphs << " small graphs (" << infeasible << " infeasible), "
+              << mismatches << " mismatches" << std::endl;
+    return mismatches;
+}
+
+void time_random_graph(const Graph& graph, SS::MCFBackend backend, long long& cost) {
+    auto solver = SS::make_mcf_solver(backend);
+    for (size_t node = 0; node < graph.supplies.size(); node++) {
+        solver->set_node_supply(static_cast<int>(node), graph.supplies[node]);
+    }
+    for (const auto& arc : graph.arcs) {
+        solver->add_arc(arc.tail, arc.head, arc.capacity, arc.cost);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    SS::MCFStatus status = solver->solve();
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    cost = status == SS::MCFStatus::OPTIMAL ? solver->optimal_cost() : 0;
+
+    std::cout << std::left << std::setw(10) << SS::to_string(backend)
+              << std::setw(10) << "random"
+              << std::right << std::setw(10) << solver->num_nodes()
+              << std::setw(12) << solver->num_arcs()
+              << std::setw(12) << std::fixed << std::setprecision(2) << ms
+              << std::setw(14) << cost << std::endl;
+}
+
+void time_shelf_selection(const SS::StockManager& base_stock, const std::vector<SS::Order>& orders,
+                          int limit, SS::SolverMode mode, SS::MCFBackend backend, long long& cost) {
+    SS::StockManager stock = base_stock;
+    SS::ShelfSelection shelf_selection(stock, mode);
+    shelf_selection.set_backend(backend);
+    shelf_selection.solve_mcf(orders, limit);
+    const SS::MCFStats& stats = shelf_selection.get_last_stats();
+    cost = stats.optimal_cost;
+
+    std::cout << std::left << std::setw(10) << SS::to_string(backend)
+              << std::setw(10) << (mode == SS::SolverMode::PARALLEL ? "parallel" : "sparse")
+              << std::right << std::setw(10) << stats.num_nodes
+              << std::setw(12) << stats.num_arcs
+              << std::setw(12) << std::fixed << std::setprecision(2) << stats.solve_ms
+              << std::setw(14) << cost << std::endl;
+}
+
+}
+
+int main(int argc, char** argv) {
+    const std::string stock_file = argc > 1 ? argv[1] : "data/raw/stock.json";
+    const int num_orders = argc > 2 ? std::stoi(argv[2]) : 5000;
+    const int limit = argc > 3 ? std::stoi(argv[3]) : 1500;
+    const int seed = argc > 4 ? std::stoi(argv[4]) : 28;
+    const int num_small_graphs = argc > 5 ? std::stoi(argv[5]) : 20000;
+
+    std::vector<SS::MCFBackend> backends;
+    for (SS::MCFBackend backend : {SS::MCFBackend::NATIVE, SS::MCFBackend::ORTOOLS}) {
+        if (SS::has_mcf_backend(backend)) {
+            backends.push_back(backend);
+        }
+    }
+
+    try {
+        const SS::StockManager base_stock(stock_file);
+        std::vector<SS::Order> orders = make_orders(base_stock, num_orders, seed);
+        std::cout << "Racks: " << base_stock.num_racks()
+                  << ", orders: " << orders.size() << ", limit: " << limit << std::endl;
+
+        std::cout << std::left << std::setw(10) << "backend"
+                  << std::setw(10) << "graph"
+                  << std::right << std::setw(10) << "nodes"
+                  << std::setw(12) << "arcs"
+                  << std::setw(12) << "solve_ms"
+                  << std::setw(14) << "cost" << std::endl;
+
+        bool same = true;
+        const SS::SolverMode modes[] = {SS::SolverMode::SPARSE, SS::SolverMode::PARALLEL};
+        for (SS::SolverMode mode : modes) {
+            std::vector<long long> costs(backends.size());
+            for (size_t i = 0; i < backends.size(); i++) {
+                time_shelf_selection(base_stock, orders, limit, mode, backends[i], costs[i]);
+                same = same && costs[i] == costs[0];
+            }
+        }
+
+        const Graph graph = make_random_graph(num_orders, 4, seed);
+        std::vector<long long> costs(backends.size());
+        for (size_t i = 0; i < backends.size(); i++) {
+            time_random_graph(graph, backends[i], costs[i]);
+            same = same && costs[i] == costs[0];
+        }
+
+        if (backends.size() > 1) {
+            std::cout << "Objective match: " << (same ? "yes" : "no") << std::endl;
+        } else {
+            std::cout << "Objective match: skipped, only " << SS::to_string(backends[0]) << " is compiled in" << std::endl;
+        }
+        const bool exact = check_small_graphs(backends, num_small_graphs, seed) == 0;
+        return same && exact ? 0 : 1;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,124 @@
+/**
+ * @brief Compares the MAP and FLAT StockManager backends
+ *
+ * Usage: stock_bench [stock_file] [num_probes] [seed]
+ * Reports load time, heap usage and lookup/update throughput of each backend.
+ */
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <malloc.h>
+#include "stock.h"
+
+namespace {
+
+struct Probe {
+    SS::RackIdx rack;
+    SS::FaceIdx face;
+    SS::ItemIdx item;
+};
+
+size_t heap_in_use() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    return mallinfo2().uordblks;
+#else
+    return 0;
+#endif
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Half of the probes hit a stocked location, the other half ask for a random item
+std::vector<Probe> make_probes(const SS::StockManager& stock, size_t num_probes, int seed) {
+    std::vector<Probe> hits;
+    for (SS::ItemIdx item = 0; item < stock.get_item_ids().size(); item++) {
+        for (const auto& location : stock.get_item_locations(item)) {
+            hits.push_back({location.rack, location.face, item});
+        }
+    }
+
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<size_t> hit_dist(0, hits.size() - 1);
+    std::uniform_int_distribution<SS::RackIdx> rack_dist(0, stock.num_racks() - 1);
+    std::uniform_int_distribution<SS::FaceIdx> face_dist(0, stock.num_faces() - 1);
+    std::uniform_int_distribution<SS::ItemIdx> item_dist(0, stock.get_item_ids().size() - 1);
+
+    std::vector<Probe> probes;
+    probes.reserve(num_probes);
+    for (size_t i = 0; i < num_probes; i++) {
+        if (i % 2 == 0) {
+            probes.push_back(hits[hit_dist(rng)]);
+        } else {
+            probes.push_back({rack_dist(rng), face_dist(rng), item_dist(rng)});
+        }
+    }
+    return probes;
+}
+
+void run(const char* name, const std::string& stock_file, SS::StockBackend backend, size_t num_probes, int seed) {
+    size_t heap_before = heap_in_use();
+    auto load_start = std::chrono::steady_clock::now();
+    SS::StockManager stock(stock_file, backend);
+    double load_s = seconds_since(load_start);
+    size_t heap_after = heap_in_use();
+
+    std::vector<Probe> probes = make_probes(stock, num_probes, seed);
+
+    // Lookups
+    long long checksum = 0;
+    auto lookup_start = std::chrono::steady_clock::now();
+    for (const auto& probe : probes) {
+        checksum += stock.get_item_quantity(probe.rack, probe.face, probe.item);
+    }
+    double lookup_s = seconds_since(lookup_start);
+
+    // Updates, a decrement and a restock on every stocked location probed
+    size_t updates = 0;
+    auto update_start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < probes.size(); i += 2) {
+        stock.set_item_quantity(probes[i].rack, probes[i].face, probes[i].item, -1);
+        stock.set_item_quantity(probes[i].rack, probes[i].face, probes[i].item, 1);
+        updates += 2;
+    }
+    double update_s = seconds_since(update_start);
+
+    std::cout << std::left << std::setw(6) << name
+              << std::right << std::fixed << std::setprecision(2)
+              << std::setw(10) << load_s * 1000.0
+              << std::setw(12) << (heap_after - heap_before) / 1024.0
+              << std::setw(12) << stock.memory_usage() / 1024.0
+              << std::setw(14) << probes.size() / lookup_s / 1e6
+              << std::setw(14) << updates / update_s / 1e6
+              << std::setw(16) << checksum << std::endl;
+}
+
+}
+
+int main(int argc, char** argv) {
+    const std::string stock_file = argc > 1 ? argv[1] : "data/raw/stock.json";
+    const size_t num_probes = argc > 2 ? std::stoul(argv[2]) : 2000000;
+    const int seed = argc > 3 ? std::stoi(argv[3]) : 28;
+
+    try {
+        std::cout << std::left << std::setw(6) << "layout"
+                  << std::right << std::setw(10) << "load_ms"
+                  << std::setw(12) << "heap_KiB"
+                  << std::setw(12) << "est_KiB"
+                  << std::setw(14) << "lookup_Mops"
+                  << std::setw(14) << "update_Mops"
+                  << std::setw(16) << "checksum" << std::endl;
+
+        run("map", stock_file, SS::StockBackend::MAP, num_probes, seed);
+        run("flat", stock_file, SS::StockBackend::FLAT, num_probes, seed);
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,133 @@
+/**
+ * @brief Compares the hand-rolled parse_iso8601/format_iso8601 with the std::get_time/put_time
+ * versions they replaced, and fuzzes both against each other
+ *
+ * Usage: time_bench [num_dates] [seed]
+ * The process runs with TZ=UTC, so the mktime/localtime based versions agree with the
+ * UTC ones. Exits with 1 if any random date does not round trip or the outputs differ.
+ */
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "utils.h"
+
+namespace {
+
+// The std::get_time + mktime parser
+SS::TimePoint legacy_parse(const std::string& date_str) {
+    std::tm tm = {};
+    std::istringstream ss(date_str);
+    ss >> std::get_time(&tm, "%Y-%m-%dT%H:%M:%S");
+    if (ss.fail()) {
+        throw std::runtime_error("Failed to parse date string: " + date_str);
+    }
+    return std::chrono::system_clock::from_time_t(std::mktime(&tm));
+}
+
+// The localtime + put_time formatter
+std::string legacy_format(const SS::TimePoint& tp) {
+    auto time = std::chrono::system_clock::to_time_t(tp);
+    std::tm tm = *std::localtime(&time);
+    std::ostringstream oss;
+    oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
+    return oss.str();
+}
+
+double ns_per_op(std::chrono::steady_clock::time_point start, size_t ops) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ops;
+}
+
+void print_row(const char* name, double legacy_ns, double fast_ns) {
+    std::cout << std::left << std::setw(10) << name
+              << std::right << std::setw(14) << std::fixed << std::setprecision(1) << legacy_ns
+              << std::setw(14) << fast_ns
+              << std::setw(10) << std::setprecision(1) << legacy_ns / fast_ns << "x" << std::endl;
+}
+
+}
+
+int main(int argc, char** argv) {
+    const size_t num_dates = argc > 1 ? std::stoul(argv[1]) : 200000;
+    const int seed = argc > 2 ? std::stoi(argv[2]) : 28;
+    setenv("TZ", "UTC", 1);
+    tzset();
+
+    // Whole seconds between 1970 and 2100, the range mktime handles everywhere
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int64_t> second_dist(0, 4102444799LL);
+    std::uniform_int_distribution<int64_t> micro_dist(0, 999999);
+    std::vector<SS::TimePoint> dates;
+    std::vector<std::string> iso_dates;
+    dates.reserve(num_dates);
+    iso_dates.reserve(num_dates);
+    for (size_t i = 0; i < num_dates; i++) {
+        dates.push_back(SS::TimePoint(std::chrono::seconds(second_dist(rng))));
+        std::string iso = legacy_format(dates.back());
+        iso[10] = 'T';
+        iso_dates.push_back(iso);
+    }
+
+    // Fuzz: both parsers and formatters agree, fractional seconds survive a round trip
+    size_t mismatches = 0;
+    char buffer[SS::ISO8601_MAX_LENGTH];
+    for (size_t i = 0; i < num_dates; i++) {
+        const SS::TimePoint micro_date = dates[i] + std::chrono::microseconds(micro_dist(rng));
+        const bool ok = SS::parse_iso8601(iso_dates[i]) == legacy_parse(iso_dates[i])
+            && SS::format_iso8601(dates[i]) == legacy_format(dates[i])
+            && SS::parse_iso8601(SS::format_iso8601(micro_date)) == micro_date
+            && SS::parse_iso8601(std::string_view(buffer, SS::format_iso8601(micro_date, buffer))) == micro_date;
+        if (!ok) {
+            if (mismatches++ < 5) {
+                std::cerr << "Mismatch: " << iso_dates[i] << " (" << SS::format_iso8601(micro_date) << ")" << std::endl;
+            }
+        }
+    }
+    std::cout << "Dates: " << num_dates << ", mismatches: " << mismatches << std::endl;
+
+    std::cout << std::left << std::setw(10) << "op"
+              << std::right << std::setw(14) << "legacy ns/op"
+              << std::setw(14) << "fast ns/op"
+              << std::setw(11) << "speedup" << std::endl;
+
+    int64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& iso : iso_dates) {
+        checksum += legacy_parse(iso).time_since_epoch().count();
+    }
+    const double legacy_parse_ns = ns_per_op(start, num_dates);
+    start = std::chrono::steady_clock::now();
+    for (const auto& iso : iso_dates) {
+        checksum -= SS::parse_iso8601(iso).time_since_epoch().count();
+    }
+    print_row("parse", legacy_parse_ns, ns_per_op(start, num_dates));
+
+    size_t length = 0;
+    start = std::chrono::steady_clock::now();
+    for (const auto& date : dates) {
+        length += legacy_format(date).size();
+    }
+    const double legacy_format_ns = ns_per_op(start, num_dates);
+    start = std::chrono::steady_clock::now();
+    for (const auto& date : dates) {
+        length -= SS::format_iso8601(date).size();
+    }
+    const double format_ns = ns_per_op(start, num_dates);
+    print_row("format", legacy_format_ns, format_ns);
+    start = std::chrono::steady_clock::now();
+    for (const auto& date : dates) {
+        length += SS::format_iso8601(date, buffer);
+    }
+    print_row("format buf", legacy_format_ns, ns_per_op(start, num_dates));
+
+    // Both sums cancel out unless a parser or formatter disagrees
+    if (checksum != 0 || length != num_dates * 19) {
+        mismatches++;
+    }
+    return mismatches == 0 ? 0 : 1;
+}
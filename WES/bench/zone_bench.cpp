@@ -0,0 +1,161 @@
+/**
+ * @brief Compares one site-wide shelf selection with zone shards fed by the ZoneRouter
+ *
+ * Usage: zone_bench [stock_file] [num_orders] [limit] [num_zones] [seed]
+ * The stock is split with write_zone_stock_files into a temporary directory and every
+ * zone is loaded back from its file, as a shard process would. Orders are generated
+ * from the site's items like mcf_bench, routed to the zones, and each zone solves its
+ * share with its zone_share of the limit, the part of the capacity a wes shard runs with. The shards run one after the other here, so
+ * the max column is the solve time of a deployment with one process per zone.
+ */
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+#include "order.h"
+#include "stock.h"
+#include "shelf_selection.h"
+#include "zone_router.h"
+
+namespace {
+
+double elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::vector<SS::Order> make_orders(const SS::StockManager& stock, int num_orders, int seed) {
+    std::vector<SS::ItemIdx> items;
+    for (SS::ItemIdx item = 0; item < stock.get_item_ids().size(); item++) {
+        for (size_t i = 0; i < stock.get_item_locations(item).size(); i++) {
+            items.push_back(item);
+        }
+    }
+
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<size_t> item_dist(0, items.size() - 1);
+    const int priorities[] = {1, 10, 50, 100};
+    std::uniform_int_distribution<int> priority_dist(0, 3);
+
+    std::vector<SS::Order> orders;
+    orders.reserve(num_orders);
+    for (int i = 0; i < num_orders; i++) {
+        SS::ItemIdx item = items[item_dist(rng)];
+        SS::Order order{
+            "ORD_" + std::to_string(i),
+            stock.get_item_ids().name(item),
+            1,
+            SS::TimePoint(),
+            SS::TimePoint(),
+            priorities[priority_dist(rng)]
+        };
+        order.order_idx = i;
+        order.item_idx = item;
+        orders.push_back(order);
+    }
+    return orders;
+}
+
+void print_row(const std::string& name, size_t racks, size_t orders, size_t memory, double ms,
+               const SS::MCFStats& stats) {
+    std::cout << std::left << std::setw(8) << name
+              << std::right << std::setw(8) << racks
+              << std::setw(10) << orders
+              << std::setw(12) << memory / 1024
+              << std::setw(10) << stats.num_arcs
+              << std::setw(12) << std::fixed << std::setprecision(2) << ms
+              << std::setw(10) << stats.assigned_orders << std::endl;
+}
+
+}
+
+int main(int argc, char** argv) {
+    const std::string stock_file = argc > 1 ? argv[1] : "data/raw/stock.json";
+    const int num_orders = argc > 2 ? std::stoi(argv[2]) : 5000;
+    const int limit = argc > 3 ? std::stoi(argv[3]) : 1500;
+    const int num_zones = argc > 4 ? std::stoi(argv[4]) : 4;
+    const int seed = argc > 5 ? std::stoi(argv[5]) : 28;
+
+    try {
+        const SS::StockManager site_stock(stock_file);
+        const std::vector<SS::Order> orders = make_orders(site_stock, num_orders, seed);
+        std::cout << "Racks: " << site_stock.num_racks() << ", orders: " << orders.size()
+                  << ", limit: " << limit << ", zones: " << num_zones << std::endl;
+        std::cout << std::left << std::setw(8) << "run"
+                  << std::right << std::setw(8) << "racks"
+                  << std::setw(10) << "orders"
+                  << std::setw(12) << "stock_kib"
+                  << std::setw(10) << "arcs"
+                  << std::setw(12) << "ms"
+                  << std::setw(10) << "assigned" << std::endl;
+
+        SS::StockManager stock = site_stock;
+        SS::ShelfSelection site(stock, SS::SolverMode::SPARSE);
+        auto start = std::chrono::steady_clock::now();
+        site.solve_mcf(orders, limit);
+        const double site_ms = elapsed_ms(start);
+        print_row("site", stock.num_racks(), orders.size(), stock.memory_usage(), site_ms, site.get_last_stats());
+
+        const std::filesystem::path dir = std::filesystem::temp_directory_path() / "zone_bench";
+        std::filesystem::create_directories(dir);
+        const std::vector<std::string> paths = SS::write_zone_stock_files(site_stock, num_zones, dir.string());
+        std::vector<SS::StockManager> zone_stocks;
+        zone_stocks.reserve(num_zones);
+        SS::ZoneRouter router(num_zones);
+        for (int zone = 0; zone < num_zones; zone++) {
+            zone_stocks.emplace_back(paths[zone]);
+            const SS::StockManager& zone_stock = zone_stocks.back();
+            for (SS::ItemIdx item = 0; item < zone_stock.get_item_ids().size(); item++) {
+                router.set_stock(zone, zone_stock.get_item_ids().name(item), zone_stock.get_total_quantity(item), 0);
+            }
+            router.set_load(zone, SS::zone_share(limit, num_zones, zone), 0);
+        }
+
+        start = std::chrono::steady_clock::now();
+        const std::vector<int> zones = router.route(orders);
+        const double route_ms = elapsed_ms(start);
+        std::vector<std::vector<SS::Order>> zone_orders(num_zones);
+        size_t unrouted = 0;
+        for (size_t i = 0; i < orders.size(); i++) {
+            if (zones[i] == SS::NO_ZONE) {
+                unrouted++;
+                continue;
+            }
+            SS::Order order = orders[i];
+            order.item_idx = zone_stocks[zones[i]].get_item_ids().find(order.item_id);
+            zone_orders[zones[i]].push_back(order);
+        }
+
+        double total_ms = 0.0;
+        double max_ms = 0.0;
+        size_t max_memory = 0;
+        int assigned = 0;
+        for (int zone = 0; zone < num_zones; zone++) {
+            SS::ShelfSelection shard(zone_stocks[zone], SS::SolverMode::SPARSE);
+            start = std::chrono::steady_clock::now();
+            shard.solve_mcf(zone_orders[zone], SS::zone_share(limit, num_zones, zone));
+            const double ms = elapsed_ms(start);
+            total_ms += ms;
+            max_ms = std::max(max_ms, ms);
+            max_memory = std::max(max_memory, zone_stocks[zone].memory_usage());
+            assigned += shard.get_last_stats().assigned_orders;
+            print_row("zone " + std::to_string(zone), zone_stocks[zone].num_racks(), zone_orders[zone].size(),
+                      zone_stocks[zone].memory_usage(), ms, shard.get_last_stats());
+        }
+        std::filesystem::remove_all(dir);
+
+        std::cout << "Routing: " << route_ms << " ms, " << unrouted << " orders unrouted" << std::endl;
+        std::cout << "Zones: " << assigned << " assigned vs " << site.get_last_stats().assigned_orders
+                  << " site-wide, solve " << max_ms << " ms max / " << total_ms << " ms total vs "
+                  << site_ms << " ms, stock " << max_memory / 1024 << " KiB max vs "
+                  << stock.memory_usage() / 1024 << " KiB" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
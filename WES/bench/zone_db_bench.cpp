@@ -0,0 +1,347 @@
+/**
+ * @brief Runs the sharded WES as separate processes on one machine against Postgres and
+ * checks that every order ends where it should
+ *
+ * Usage: zone_db_bench [stock_file] [num_orders] [num_zones] [seconds] [speed_up] [seed]
+ * Needs the database configured in .env. The tables of mcf_db/schema.sql are created in a
+ * scratch schema, zone_db_bench, that every process selects through PGOPTIONS, so the
+ * real backlog is never touched; it is dropped and recreated on every run. NOTIFY
+ * channels belong to the whole database: run it where no wes or wes_coordinator listens.
+ *
+ * The stock is split with write_zone_stock_files, then the coordinator and one shard per
+ * zone are forked as processes, wired as in wes_coordinator and wes <zone>, and the parent
+ * publishes the orders in batches over the first half of the run like WMS. Simulated time
+ * runs speed_up times faster than the wall clock, so the shards accrue capacity. A shard
+ * ticks once to report its stock, then only wakes on the NOTIFY of its zone channel: its
+ * timer fallback is the end of the run. Afterwards the parent checks:
+ *
+ *   watermark  no order is left PENDING, every row routed to a zone was fetched
+ *   stock      per zone and item, completed units plus the units the shard reports
+ *              left add up to the zone's stock: no order completed twice or in a zone
+ *              without its item
+ *   hand-back  every STOCK_OUT order's item is out in every zone, orders a zone handed
+ *              back went to another zone while one still had stock
+ *
+ * and counts the hand-backs: zone_seq values drawn beyond the orders still holding a zone.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <pqxx/pqxx>
+#include "db_connector.h"
+#include "order.h"
+#include "order_listener.h"
+#include "order_manager.h"
+#include "shelf_selection.h"
+#include "stock.h"
+#include "task_manager.h"
+#include "tick_pipeline.h"
+#include "zone_coordinator.h"
+#include "zone_reporter.h"
+#include "zone_router.h"
+#include "utils.h"
+
+namespace {
+
+constexpr const char* SCHEMA = "zone_db_bench";
+
+/**
+ * @brief Wall-clock window of the run and the simulated clock every process derives from it
+ */
+struct Run {
+    int num_zones = 4;
+    int speed_up = 600;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point end;
+    SS::TimePoint start_date;
+
+    SS::TimePoint simulation_date() const {
+        return start_date + std::chrono::duration_cast<SS::TimePoint::duration>(
+            (std::chrono::steady_clock::now() - start) * speed_up);
+    }
+};
+
+void create_schema(pqxx::connection& conn) {
+    std::ifstream file("mcf_db/schema.sql");
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open mcf_db/schema.sql, run from the repository root");
+    }
+    std::stringstream schema;
+    schema << file.rdbuf();
+
+    // PGOPTIONS puts the scratch schema first on the search path, the tables land there
+    pqxx::work txn(conn);
+    txn.exec(std::string("DROP SCHEMA IF EXISTS ") + SCHEMA + " CASCADE");
+    txn.exec(std::string("CREATE SCHEMA ") + SCHEMA);
+    txn.exec(schema.str());
+    txn.commit();
+}
+
+std::vector<SS::Order> make_orders(const SS::StockManager& stock, int num_orders, int seed) {
+    std::vector<SS::ItemIdx> items;
+    for (SS::ItemIdx item = 0; item < stock.get_item_ids().size(); item++) {
+        for (size_t i = 0; i < stock.get_item_locations(item).size(); i++) {
+            items.push_back(item);
+        }
+    }
+
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<size_t> item_dist(0, items.size() - 1);
+    std::vector<SS::Order> orders;
+    orders.reserve(num_orders);
+    for (int i = 0; i < num_orders; i++) {
+        orders.push_back(SS::Order{"ZDB_" + std::to_string(i), stock.get_item_ids().name(items[item_dist(rng)]),
+                                   1, SS::TimePoint(), SS::TimePoint()});
+    }
+    return orders;
+}
+
+// One process per zone, as wes <zone> with a single station
+int run_shard(int zone, const std::string& stock_path, const Run& run, int seed) {
+    SS::DBConnector db_connector;
+    SS::StockManager stock(stock_path);
+    SS::ShelfSelection shelf_selection(stock, SS::SolverMode::SPARSE);
+    SS::TaskManager task_manager(seed + zone, SS::zone_share(1000, run.num_zones, zone),
+                                 SS::zone_share(2000, run.num_zones, zone));
+    SS::OrderManager order_manager(db_connector, stock);
+    order_manager.set_zone(zone);
+    SS::ZoneReporter reporter(zone, stock);
+    pqxx::connection conn = db_connector.connect();
+    SS::OrderListener listener(conn, SS::zone_channel(zone));
+
+    int ticks = 0;
+    int notified = 0;
+    size_t assigned = 0;
+    {
+        SS::TickPipeline pipeline(db_connector, order_manager, shelf_selection, task_manager);
+        pipeline.set_zone_reporter(&reporter);
+        // The coordinator routes nothing to a zone that has not reported its stock
+        pipeline.tick(run.simulation_date());
+        ticks++;
+
+        SS::TriggerPolicy policy;
+        policy.min_orders = 1;
+        policy.max_delay = std::chrono::milliseconds(20);
+        while (std::chrono::steady_clock::now() < run.end) {
+            policy.fallback = std::chrono::duration_cast<std::chrono::milliseconds>(
+                run.end - std::chrono::steady_clock::now());
+            if (listener.wait(policy) != SS::Trigger::TIMER) {
+                notified++;
+            }
+            assigned += pipeline.tick(run.simulation_date()).assigned_orders;
+            ticks++;
+        }
+        pipeline.flush();
+    }
+    std::cout << "  ├─ Zone " << zone << ": " << ticks << " ticks, " << notified << " woken by NOTIFY, "
+              << assigned << " orders assigned" << std::endl;
+    return 0;
+}
+
+// The wes_coordinator loop with a short poll, so hand-backs are routed again quickly
+int run_coordinator(const Run& run) {
+    SS::DBConnector db_connector;
+    SS::ZoneCoordinator coordinator(db_connector, run.num_zones);
+    pqxx::connection conn = db_connector.connect();
+    SS::OrderListener listener(conn);
+    SS::TriggerPolicy policy;
+    policy.min_orders = 1;
+    policy.max_delay = std::chrono::milliseconds(20);
+    policy.fallback = std::chrono::milliseconds(200);
+
+    size_t routed = 0;
+    size_t stock_out = 0;
+    while (std::chrono::steady_clock::now() < run.end) {
+        listener.wait(policy);
+        const SS::CoordinatorStats& stats = coordinator.route_once();
+        routed += stats.routed;
+        stock_out += stats.stock_out;
+    }
+    std::cout << "  ├─ Coordinator: " << coordinator.get_last_stats().round << " rounds, " << routed
+              << " routings, " << stock_out << " closed as stock out" << std::endl;
+    return 0;
+}
+
+// Fork a child running body, its return value is the exit status
+template <typename Body>
+pid_t spawn(Body body) {
+    const pid_t pid = fork();
+    if (pid < 0) {
+        throw std::runtime_error("fork failed");
+    }
+    if (pid == 0) {
+        int status = 1;
+        try {
+            status = body();
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+        }
+        std::cout.flush();
+        _exit(status);
+    }
+    return pid;
+}
+
+// WMS: the orders in batches over the first half of the run, announced like Publisher does
+void publish(SS::DBConnector& db_connector, const std::vector<SS::Order>& orders, const Run& run, int batches) {
+    const auto half = (run.end - run.start) / 2;
+    for (int b = 0; b < batches; b++) {
+        const size_t begin = orders.size() * b / batches;
+        const size_t end = orders.size() * (b + 1) / batches;
+        const SS::TimePoint date = run.simulation_date();
+        const std::string creation = SS::format_iso8601(date);
+        const std::string due = SS::format_iso8601(date + std::chrono::hours(24 * 7));
+        {
+            SS::DBConnector::Lease conn = db_connector.acquire();
+            pqxx::work txn(*conn);
+            for (size_t i = begin; i < end; i++) {
+                txn.exec_prepared(SS::INSERT_ORDER_STMT, orders[i].order_id, orders[i].item_id,
+                                  orders[i].quantity, creation, due);
+            }
+            txn.exec_prepared(SS::NOTIFY_BACKLOG_STMT, SS::BACKLOG_CHANNEL, std::to_string(end - begin));
+            txn.commit();
+        }
+        std::this_thread::sleep_until(run.start + half * (b + 1) / batches);
+    }
+}
+
+bool check(const char* name, bool ok, const std::string& detail) {
+    std::cout << "  " << (ok ? "✓ " : "✗ ") << name << ": " << detail << std::endl;
+    return ok;
+}
+
+}
+
+int main(int argc, char** argv) {
+    const std::string stock_file = argc > 1 ? argv[1] : "data/raw/stock.json";
+    const int num_orders = argc > 2 ? std::stoi(argv[2]) : 3000;
+    const int num_zones = argc > 3 ? std::stoi(argv[3]) : 4;
+    const int seconds = argc > 4 ? std::stoi(argv[4]) : 20;
+    const int speed_up = argc > 5 ? std::stoi(argv[5]) : 600;
+    const int seed = argc > 6 ? std::stoi(argv[6]) : 28;
+
+    try {
+        // Every connection of this process and its children opens on the scratch schema
+        setenv("PGOPTIONS", (std::string("-c search_path=") + SCHEMA).c_str(), 1);
+
+        const SS::StockManager site_stock(stock_file);
+        const std::filesystem::path dir = std::filesystem::temp_directory_path() / "zone_db_bench";
+        std::filesystem::create_directories(dir);
+        const std::vector<std::string> paths = SS::write_zone_stock_files(site_stock, num_zones, dir.string());
+        const std::vector<SS::Order> orders = make_orders(site_stock, num_orders, seed);
+        {
+            SS::DBConnector db_connector;
+            pqxx::connection conn = db_connector.connect();
+            create_schema(conn);
+            conn.close();
+        }
+        std::cout << "Racks: " << site_stock.num_racks() << ", orders: " << orders.size() << ", zones: "
+                  << num_zones << ", " << seconds << " s at " << speed_up << "x" << std::endl;
+
+        // No connection or thread is open in the parent while it forks
+        Run run;
+        run.num_zones = num_zones;
+        run.speed_up = speed_up;
+        run.start = std::chrono::steady_clock::now();
+        run.end = run.start + std::chrono::seconds(seconds);
+        run.start_date = SS::parse_iso8601("2025-10-09T00:00:00");
+        std::vector<pid_t> children;
+        children.push_back(spawn([&]() { return run_coordinator(run); }));
+        for (int zone = 0; zone < num_zones; zone++) {
+            children.push_back(spawn([&, zone]() { return run_shard(zone, paths[zone], run, seed); }));
+        }
+
+        SS::DBConnector db_connector;
+        publish(db_connector, orders, run, 20);
+        bool ok = true;
+        for (pid_t pid : children) {
+            int status = 0;
+            waitpid(pid, &status, 0);
+            ok = ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        }
+        std::cout << "  └─ Processes: " << (ok ? "all exited cleanly" : "FAILED") << std::endl;
+
+        // Zone stock at the start, from the files the shards loaded
+        std::map<std::pair<int, std::string>, long long> expected;
+        for (int zone = 0; zone < num_zones; zone++) {
+            const SS::StockManager zone_stock(paths[zone]);
+            for (SS::ItemIdx item = 0; item < zone_stock.get_item_ids().size(); item++) {
+                expected[{zone, zone_stock.get_item_ids().name(item)}] = zone_stock.get_total_quantity(item);
+            }
+        }
+        std::filesystem::remove_all(dir);
+
+        SS::DBConnector::Lease conn = db_connector.acquire();
+        pqxx::work txn(*conn);
+        std::map<std::string, long long> statuses;
+        for (const auto& row : txn.exec("SELECT status, count(*) AS orders FROM backlog GROUP BY status")) {
+            statuses[row["status"].as<std::string>()] = row["orders"].as<long long>();
+        }
+        for (const auto& row : txn.exec("SELECT zone, rtrim(item_id) AS item_id, sum(quantity) AS units "
+                                        "FROM backlog WHERE status = 'COMPLETED' GROUP BY zone, item_id")) {
+            expected[{row["zone"].as<int>(), row["item_id"].as<std::string>()}] -= row["units"].as<long long>();
+        }
+        std::map<std::pair<int, std::string>, long long> left;
+        std::map<std::string, long long> site_left;
+        for (const auto& row : txn.exec("SELECT zone, rtrim(item_id) AS item_id, quantity FROM zone_stock")) {
+            const std::string item_id = row["item_id"].as<std::string>();
+            left[{row["zone"].as<int>(), item_id}] = row["quantity"].as<long long>();
+            site_left[item_id] += row["quantity"].as<long long>();
+        }
+        std::set<std::string> stock_out_items;
+        for (const auto& row : txn.exec(
+                 "SELECT DISTINCT rtrim(item_id) AS item_id FROM backlog WHERE status = 'STOCK_OUT'")) {
+            stock_out_items.insert(row["item_id"].as<std::string>());
+        }
+        long long routings = 0;
+        long long holding = 0;
+        for (const auto& row : txn.exec(
+                 "SELECT (SELECT CASE WHEN is_called THEN last_value ELSE 0 END FROM backlog_zone_seq) AS routings, "
+                 "(SELECT count(*) FROM backlog WHERE zone IS NOT NULL) AS holding")) {
+            routings = row["routings"].as<long long>();
+            holding = row["holding"].as<long long>();
+        }
+        txn.commit();
+
+        size_t mismatched = 0;
+        for (const auto& [key, units] : expected) {
+            auto it = left.find(key);
+            mismatched += (it == left.end() ? 0 : it->second) != units ? 1 : 0;
+        }
+        size_t early = 0;
+        for (const std::string& item_id : stock_out_items) {
+            early += site_left[item_id] > 0 ? 1 : 0;
+        }
+
+        std::cout << "Orders: " << statuses["COMPLETED"] << " completed, " << statuses["STOCK_OUT"] << " stock out, "
+                  << statuses["EXPIRED"] << " expired, " << statuses["PENDING"] << " pending; "
+                  << routings << " routings, " << routings - holding << " hand-backs" << std::endl;
+        ok = check("watermark", statuses["PENDING"] == 0,
+                   std::to_string(statuses["PENDING"]) + " orders left pending") && ok;
+        ok = check("stock", mismatched == 0,
+                   std::to_string(mismatched) + " of " + std::to_string(expected.size()) + " zone items off") && ok;
+        ok = check("hand-back", early == 0, std::to_string(early) + " of " + std::to_string(stock_out_items.size())
+                   + " stock out items still stocked somewhere") && ok;
+        if (routings == holding) {
+            std::cout << "  (no hand-backs happened, raise num_orders past the site stock to exercise them)" << std::endl;
+        }
+        return ok ? 0 : 1;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
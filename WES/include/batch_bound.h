@@ -0,0 +1,95 @@
+#ifndef BATCH_BOUND_H
+#define BATCH_BOUND_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include "types.h"
+#include "order.h"
+#include "stock.h"
+#include "mcf_solver.h"
+
+namespace SS {
+
+/**
+ * @brief Horizon and capacities of a whole-day batch solve
+ */
+struct BatchBoundConfig {
+    TimePoint start_date;
+    TimePoint end_date;
+    std::chrono::minutes period{5};       // One period per polling tick, wes.cpp without events
+    int seed = 28;                        // TaskManager seed, same capacity draws as the simulation
+    int min_capacity = 1000;
+    int max_capacity = 2000;
+    MCFBackend backend = MCFBackend::NATIVE;
+};
+
+/**
+ * @brief Lower bounds of a whole-day batch solve
+ */
+struct BatchBoundResult {
+    size_t orders = 0;
+    long long units = 0;                  // Units ordered
+    size_t groups = 0;                    // (item, first period, last period, quantity) classes
+    size_t periods = 0;
+    long long served_units = 0;           // Most units any plan can deliver
+    long long min_unserved_units = 0;     // units - served_units
+    size_t served = 0;                    // Whole orders of the plan found, the most any plan can serve with one-unit lines
+    size_t min_unserved = 0;              // orders - served: bound on expired + stock out + open with one-unit lines
+    size_t unstocked = 0;                 // Orders of items with no stock at all
+    size_t out_of_window = 0;             // Orders with no period between creation and due date
+    double rack_visits_lp = 0.0;          // LP bound on the rack visits of a plan delivering `served_units`
+    long long rack_visits_bound = 0;      // Rounded up
+    int num_nodes = 0;
+    int num_arcs = 0;
+    double build_ms = 0.0;
+    double solve_ms = 0.0;
+    std::vector<int> capacity;            // N of each period
+    std::vector<int> period_flow;         // Units delivered in each period by the plan found
+};
+
+/**
+ * @brief Offline lower bound for the online policy: the whole day in one MCF
+ *
+ * Periods are the polling ticks start_date + k * period before end_date, each with a
+ * TaskManager capacity N_k. An order may use the periods between its creation and due
+ * dates. The time-expanded network is
+ *
+ *   source -> (rack, item) stock -> item -> order group -> period tree -> period -> sink
+ *
+ * Flow is in units, as N is. Orders with the same item, period window and quantity
+ * form one group carrying count * quantity units, and the groups reach their window
+ * through a segment tree over the periods, so the graph has O(log T) arcs per group
+ * instead of one per period. A fixed cost per rack visit makes the exact problem a
+ * MIP; its LP relaxation charges 1/u_r per unit taken from rack r, u_r being the most
+ * one visit can deliver (min of the largest N and the rack stock). Delivering a unit
+ * is worth more than any visit cost, so the solve maximizes the units served, then
+ * minimizes the linearized visits among those plans. The orders a group serves are
+ * its flow / quantity: with one-unit lines that is the most orders any plan serves,
+ * with larger lines only the units are a bound.
+ *
+ * Both results bound the simulation with event_driven off and the same period, seed
+ * and capacities from below: it draws from the same N and stock, and also loses
+ * capacity to pending tasks.
+ */
+class BatchBound {
+public:
+    BatchBound(const BatchBoundConfig& config, const StockManager& stock, const std::vector<Order>& orders);
+
+    const BatchBoundResult& solve();
+
+    // Write bound.json and bound_periods.csv to output_dir
+    void write_outputs(const std::string& output_dir) const;
+
+    const BatchBoundResult& get_result() const { return result_; }
+
+private:
+    const BatchBoundConfig config_;
+    const StockManager& stock_;
+    const std::vector<Order>& orders_;
+    BatchBoundResult result_;
+};
+
+}
+
+#endif // BATCH_BOUND_H
@@ -0,0 +1,59 @@
+#ifndef FLAT_STOCK_H
+#define FLAT_STOCK_H
+
+#include <cstdint>
+#include <vector>
+#include "types.h"
+
+namespace SS {
+
+/**
+ * @brief Columnar stock store
+ * Face-major slots (slot = rack * num_faces + face), each slot owning a CSR range
+ * of (item, quantity) pairs sorted by item. Items and quantities live in two
+ * contiguous arrays, so a face lookup touches one or two cache lines.
+ */
+class FlatStock {
+public:
+    FlatStock() = default;
+
+    // Build the store from the nested map layout
+    void build(const Stock& inventory, size_t num_racks, size_t num_faces);
+
+    // Take over arrays in this layout, e.g. read from a snapshot
+    void assign(size_t num_faces, std::vector<uint32_t> offsets, std::vector<ItemIdx> items,
+                std::vector<int32_t> quantities);
+
+    // Quantity of an item at a slot, 0 if absent
+    int get(RackIdx rack, FaceIdx face, ItemIdx item) const;
+
+    // Add delta to an item at a slot and return the new quantity
+    // Inserting an item a face never held shifts the arrays, which only happens on restock
+    int add(RackIdx rack, FaceIdx face, ItemIdx item, int delta);
+
+    // Slot layout
+    size_t num_slots() const { return offsets_.empty() ? 0 : offsets_.size() - 1; }
+    size_t slot(RackIdx rack, FaceIdx face) const { return static_cast<size_t>(rack) * num_faces_ + face; }
+    uint32_t slot_begin(size_t slot) const { return offsets_[slot]; }
+    uint32_t slot_end(size_t slot) const { return offsets_[slot + 1]; }
+    size_t num_faces() const { return num_faces_; }
+    const std::vector<uint32_t>& offsets() const { return offsets_; }
+    const std::vector<ItemIdx>& items() const { return items_; }
+    const std::vector<int32_t>& quantities() const { return quantities_; }
+
+    // Bytes held by the arrays
+    size_t memory_bytes() const;
+
+private:
+    // Position of item in the slot range, or the insertion point if absent
+    uint32_t find(size_t slot, ItemIdx item) const;
+
+    size_t num_faces_ = 0;
+    std::vector<uint32_t> offsets_;    // num_slots + 1 entries
+    std::vector<ItemIdx> items_;       // items of each slot, sorted
+    std::vector<int32_t> quantities_;  // parallel to items_
+};
+
+}
+
+#endif // FLAT_STOCK_H
@@ -0,0 +1,68 @@
+#ifndef GREEDY_SELECTION_H
+#define GREEDY_SELECTION_H
+
+#include <vector>
+#include "types.h"
+#include "order.h"
+#include "stock.h"
+#include "incremental_mcf.h"
+
+namespace SS {
+
+/**
+ * @brief Bounded-time shelf selection heuristic
+ *
+ * Greedy pass: orders are taken by priority and each one gets the hottest units of
+ * its item that are still free, until the limit on units is reached. Within an item this takes
+ * the highest priorities and the hottest units, so every item holds a prefix of its
+ * non-increasing marginal value curve (see IncrementalMCF).
+ *
+ * Improvement pass: while the best unit not taken is worth more than the worst unit
+ * taken, the worst one is dropped for the best one. Run to the end this reaches the
+ * MCF optimum; the time budget cuts it short on large backlogs.
+ */
+class GreedySelection {
+public:
+    explicit GreedySelection(const StockManager& stock);
+
+    // Picks for at most limit units within budget_ms (0 means no budget)
+    // cost uses the same units as the MCF objective
+    std::vector<Pick> solve(const std::vector<Order>& orders, const std::vector<int>& rack_costs,
+                            int limit, double budget_ms, long long& cost);
+
+    // Statistics of the last solve
+    int num_components() const { return static_cast<int>(active_.size()); }
+    int exchanges() const { return exchanges_; }
+    bool timed_out() const { return timed_out_; }
+
+private:
+    struct Component {
+        std::vector<size_t> orders;             // indices in the orders vector, by priority desc
+        std::vector<StockLocation> locations;   // by unit cost asc
+        std::vector<int> unit_costs;            // parallel to locations
+        std::vector<int> unit_locations;        // k-th unit -> index in locations
+        std::vector<int> unit_lines;            // k-th unit -> index in orders, a line of quantity q has q units
+        int taken = 0;
+    };
+
+    // Value of the k-th unit of an item: priority of the line it serves minus the unit cost
+    int value(const std::vector<Order>& orders, const Component& component, int k) const {
+        return orders[component.orders[component.unit_lines[k]]].priority
+            - component.unit_costs[component.unit_locations[k]];
+    }
+
+    // Sort the units of an item by cost and expand them up to the units ordered
+    void build_units(ItemIdx item, Component& component, const std::vector<Order>& orders,
+                     const std::vector<int>& rack_costs);
+
+    const StockManager& stock_;
+    std::vector<Component> components_; // indexed by ItemIdx
+    std::vector<ItemIdx> active_;       // items with orders and stock in the last solve
+    std::vector<size_t> by_priority_;   // scratch buffer
+    int exchanges_ = 0;
+    bool timed_out_ = false;
+};
+
+}
+
+#endif // GREEDY_SELECTION_H
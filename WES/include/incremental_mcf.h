@@ -0,0 +1,95 @@
+#ifndef INCREMENTAL_MCF_H
+#define INCREMENTAL_MCF_H
+
+#include <vector>
+#include <unordered_map>
+#include "types.h"
+#include "order.h"
+#include "stock.h"
+
+namespace SS {
+
+/**
+ * @brief Units of an order line picked at a face, one line may be split over several faces
+ */
+struct Pick {
+    OrderIdx order;
+    ItemIdx item;
+    RackIdx rack;
+    FaceIdx face;
+    int quantity = 1;
+};
+
+/**
+ * @brief Shelf selection MCF kept alive between iterations
+ *
+ * In the item-routed graph (source -> order -> item -> rack_face -> sink) the item
+ * subgraphs only meet at the source and the sink, so each item is an independent
+ * component. Within a component any order can use any unit, so the cheapest way to
+ * route k units takes the k highest priority units (a line of quantity q counts q
+ * times) and the k hottest units; its marginal value curve is non-increasing. The
+ * global optimum for a supply limit is the top-limit marginal values across components.
+ *
+ * update() applies the backlog, stock and rack cost deltas since the previous call
+ * and only rebuilds the components they touch; solve() re-allocates the limit over
+ * the cached curves.
+ */
+class IncrementalMCF {
+public:
+    explicit IncrementalMCF(const StockManager& stock);
+
+    // Apply the deltas between the previous and the current backlog, stock and rack costs
+    void update(const std::vector<Order>& orders, const std::vector<int>& rack_costs);
+
+    // Optimal picks for at most limit units; cost uses the same units as the MCF objective
+    // A line may come out partially routed, ShelfSelection settles it
+    std::vector<Pick> solve(int limit, long long& cost);
+
+    // Drop all cached state
+    void clear();
+
+    // Component statistics of the last update
+    size_t num_components() const { return active_.size(); }
+    size_t last_rebuilt() const { return last_rebuilt_; }
+
+private:
+    struct Line {
+        int priority;
+        OrderIdx order;
+        int quantity;
+    };
+
+    struct Component {
+        std::vector<Line> orders;                     // sorted by priority desc when clean
+        std::vector<StockLocation> locations;         // sorted by unit cost asc when clean
+        std::vector<int> unit_costs;                  // parallel to locations
+        int capacity = 0;                             // min(ordered units, stocked units)
+        uint32_t stock_version = 0;
+        bool dirty = true;
+    };
+
+    struct KnownOrder {
+        ItemIdx item;
+        int priority;
+        int quantity;
+        bool seen;
+    };
+
+    // Re-sort the orders and units of a component
+    void rebuild(ItemIdx item, Component& component);
+
+    void add_order(OrderIdx order, ItemIdx item, int priority, int quantity);
+    void remove_order(OrderIdx order, ItemIdx item);
+
+    const StockManager& stock_;
+    std::vector<Component> components_;               // indexed by ItemIdx
+    std::unordered_map<OrderIdx, KnownOrder> known_orders_;
+    std::vector<int> rack_costs_;                     // rack costs the components were built with
+    std::vector<ItemIdx> active_;                     // items with at least one order
+    std::vector<ItemIdx> rack_items_;                 // scratch buffer
+    size_t last_rebuilt_ = 0;
+};
+
+}
+
+#endif // INCREMENTAL_MCF_H
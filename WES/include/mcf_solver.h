@@ -0,0 +1,60 @@
+#ifndef MCF_SOLVER_H
+#define MCF_SOLVER_H
+
+#include <memory>
+
+namespace SS {
+
+/**
+ * @brief Min cost flow engine used to solve a graph
+ */
+enum class MCFBackend {
+    NATIVE,  // In-tree cost-scaling push-relabel (native_mcf.h)
+    ORTOOLS  // operations_research::SimpleMinCostFlow, only with WES_WITH_ORTOOLS
+};
+
+enum class MCFStatus {
+    OPTIMAL,
+    INFEASIBLE,  // Supplies cannot be routed with the given capacities
+    UNBALANCED   // Supplies do not add up to zero
+};
+
+/**
+ * @brief Min cost flow problem with integer capacities and costs
+ *
+ * Nodes are created implicitly by the highest index passed to set_node_supply or
+ * add_arc. Arcs are numbered in insertion order. clear() drops the graph but an
+ * implementation may keep its buffers for the next problem.
+ */
+class MCFSolver {
+public:
+    virtual ~MCFSolver() = default;
+
+    // Build
+    virtual void set_node_supply(int node, int supply) = 0;
+    virtual int add_arc(int tail, int head, int capacity, int cost) = 0;
+    virtual void clear() = 0;
+
+    // Solve
+    virtual MCFStatus solve() = 0;
+
+    // Graph and solution, valid after an OPTIMAL solve
+    virtual int num_nodes() const = 0;
+    virtual int num_arcs() const = 0;
+    virtual int tail(int arc) const = 0;
+    virtual int head(int arc) const = 0;
+    virtual int flow(int arc) const = 0;
+    virtual long long optimal_cost() const = 0;
+};
+
+// Throws if the backend was not compiled in
+std::unique_ptr<MCFSolver> make_mcf_solver(MCFBackend backend);
+
+// Whether the backend was compiled in
+bool has_mcf_backend(MCFBackend backend);
+
+const char* to_string(MCFBackend backend);
+
+}
+
+#endif // MCF_SOLVER_H
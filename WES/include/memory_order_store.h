@@ -0,0 +1,65 @@
+#ifndef MEMORY_ORDER_STORE_H
+#define MEMORY_ORDER_STORE_H
+
+#include <set>
+#include <unordered_set>
+#include <vector>
+#include "types.h"
+#include "order.h"
+#include "order_store.h"
+#include "stock.h"
+
+namespace SS {
+
+/**
+ * @brief OrderStore without a database, for the offline simulation
+ *
+ * Holds the whole backlog file. Orders are published as the simulation date passes
+ * their creation date, the way WMS does, and closed with the simulation date.
+ * OrderIdx is the position of the order in the file. Orders that are already closed,
+ * as in a backlog snapshot taken mid-simulation, keep their status and never arrive.
+ */
+class MemoryOrderStore : public OrderStore {
+public:
+    MemoryOrderStore(std::vector<Order> orders, const StockManager& stock);
+
+    std::vector<Order> get_backlog(const TimePoint& simulation_date) override;
+    void expire_orders(const TimePoint& simulation_date) override;
+    void complete_orders(const Taskpool& taskpool, const TimePoint& simulation_date) override;
+    void stock_out_orders(const TimePoint& simulation_date) override;
+
+    // Priority bands of get_backlog, the OrderManager ones unless set
+    void set_priority_bands(const PriorityBands& bands) { bands_ = bands; }
+
+    // Creation date of the k-th order not published yet, TimePoint::max() past the end
+    TimePoint next_arrival(size_t k = 0) const;
+
+    // Every order with its status and closure date
+    const std::vector<Order>& get_orders() const { return orders_; }
+
+    size_t num_published() const { return next_arrival_; }
+    size_t num_pending() const { return pending_.size(); }
+
+private:
+    // Publish the orders created up to simulation_date
+    void publish(const TimePoint& simulation_date);
+
+    // Close a pending order
+    void close(std::set<OrderIdx>::iterator it, OrderStatus status, const TimePoint& simulation_date);
+
+    const StockManager& stock_;
+    PriorityBands bands_;
+    std::vector<Order> orders_;          // file order, indexed by OrderIdx
+    std::vector<OrderIdx> arrivals_;     // by creation date, ties in file order
+    size_t next_arrival_ = 0;            // first entry of arrivals_ not published
+    std::set<OrderIdx> pending_;         // published and not closed
+    // stock_out_orders: entries of stock_.stock_out_items_ taken so far, the items they name
+    // and the entries of arrivals_ already checked against them
+    size_t stock_out_seen_ = 0;
+    std::unordered_set<ItemIdx> stock_out_items_;
+    size_t stock_out_checked_ = 0;
+};
+
+}
+
+#endif // MEMORY_ORDER_STORE_H
@@ -0,0 +1,83 @@
+#ifndef NATIVE_MCF_H
+#define NATIVE_MCF_H
+
+#include <cstdint>
+#include <vector>
+#include "mcf_solver.h"
+
+namespace SS {
+
+/**
+ * @brief In-tree min cost flow engine: Goldberg-Tarjan cost-scaling push-relabel
+ *
+ * Costs are multiplied by n + 1 so an epsilon of 1 is optimal for the original costs,
+ * then epsilon is divided by ALPHA between refine passes. Each refine saturates the
+ * arcs with negative reduced cost and discharges the active nodes in FIFO order.
+ *
+ * The shelf selection graphs are shallow (source -> order -> item -> face -> sink),
+ * so the residual graph is kept in flat arrays grouped by tail (arc a is residual
+ * 2a, its reverse 2a + 1) and every buffer survives clear() for the next tick.
+ */
+class NativeMCF : public MCFSolver {
+public:
+    void set_node_supply(int node, int supply) override;
+    int add_arc(int tail, int head, int capacity, int cost) override;
+    void clear() override;
+
+    MCFStatus solve() override;
+
+    int num_nodes() const override { return num_nodes_; }
+    int num_arcs() const override { return static_cast<int>(arc_tail_.size()); }
+    int tail(int arc) const override { return arc_tail_[arc]; }
+    int head(int arc) const override { return arc_head_[arc]; }
+    int flow(int arc) const override { return arc_capacity_[arc] - residual_[2 * arc]; }
+    long long optimal_cost() const override { return optimal_cost_; }
+
+private:
+    static constexpr int64_t ALPHA = 8;
+
+    void grow(int node);
+    void build_residual_graph();
+
+    // Turn a start_epsilon optimal flow into an epsilon optimal one, false if no feasible flow exists
+    bool refine(int64_t epsilon, int64_t start_epsilon);
+    bool discharge(int node, int64_t epsilon);
+    bool relabel(int node, int64_t epsilon);
+    void push(int node, int residual_arc, int amount);
+    void activate(int node);
+
+    int64_t reduced_cost(int node, int residual_arc) const {
+        return scaled_cost_[residual_arc] + price_[node] - price_[residual_head_[residual_arc]];
+    }
+
+    int num_nodes_ = 0;
+    long long optimal_cost_ = 0;
+
+    // Input graph
+    std::vector<int> supply_;
+    std::vector<int> arc_tail_;
+    std::vector<int> arc_head_;
+    std::vector<int> arc_capacity_;
+    std::vector<int> arc_cost_;
+
+    // Residual graph, grouped by tail through first_out_ and out_
+    std::vector<int> residual_;
+    std::vector<int> residual_head_;
+    std::vector<int64_t> scaled_cost_;
+    std::vector<int> first_out_;
+    std::vector<int> out_;
+
+    // Push-relabel state
+    std::vector<int> excess_;
+    std::vector<int64_t> price_;
+    std::vector<int64_t> price_floor_; // lowest price a feasible refine can reach
+    std::vector<int> current_;         // next position in out_ to scan
+    std::vector<int> queue_;           // FIFO ring of active nodes
+    std::vector<char> queued_;
+    size_t queue_head_ = 0;
+    size_t queue_size_ = 0;
+};
+
+}
+
+#endif // NATIVE_MCF_H
@@ -0,0 +1,39 @@
+#ifndef ORDER_LISTENER_H
+#define ORDER_LISTENER_H
+
+#include <chrono>
+#include <string>
+#include <pqxx/pqxx>
+#include "db_connector.h"
+#include "trigger_policy.h"
+
+namespace SS {
+
+/**
+ * @brief LISTENs on BACKLOG_CHANNEL and blocks on the connection socket until a trigger fires
+ *
+ * The connection must not be inside a transaction while wait() runs.
+ */
+class OrderListener : public pqxx::notification_receiver {
+public:
+    explicit OrderListener(pqxx::connection& conn, const std::string& channel = BACKLOG_CHANNEL);
+
+    // Called by pqxx for every notification, the payload is the number of published orders
+    void operator()(const std::string& payload, int backend_pid) override;
+
+    // Block until one of the policy triggers fires, then reset the counters
+    Trigger wait(const TriggerPolicy& policy);
+
+    // Orders announced since the previous trigger
+    int get_new_orders() const { return last_new_orders_; }
+
+private:
+    int new_orders_ = 0;
+    int last_new_orders_ = 0;
+    std::chrono::steady_clock::time_point first_arrival_;
+    std::chrono::steady_clock::time_point last_trigger_;
+};
+
+}
+
+#endif // ORDER_LISTENER_H
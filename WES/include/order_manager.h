@@ -1,27 +1,44 @@
 #ifndef ORDER_MANAGER_H
 #define ORDER_MANAGER_H
 
+#include <map>
+#include <string>
+#include <unordered_set>
 #include <vector>
 #include <pqxx/pqxx>
 #include "types.h"
 #include "order.h"
 #include "db_connector.h"
 #include "stock.h"
+#include "symbol_table.h"
+#include "order_store.h"
 
 namespace SS {
 
 /**
  * @brief Manages order database operations
  * Handles fetching, updating, and managing order statuses in the database
+ * Queries run as prepared statements: connections passed in must come from
+ * DBConnector::acquire or have gone through DBConnector::prepare_statements
+ * (and prepare_zone_statements for a zone shard)
  */
-class OrderManager {
+class OrderManager : public OrderStore {
 public:
     // Constructor
     OrderManager(DBConnector& db_connector, StockManager& stock);
 
-    // Fetch pending orders from database with status 'PENDING'
+    // Pending orders with their priority at simulation_date. Only the rows inserted since
+    // the previous call are read from the database; orders closed through this manager
+    // are dropped from the cache locally, and so are orders already past due
     std::vector<Order> get_backlog_from_db(pqxx::connection& conn, const TimePoint& simulation_date);
 
+    // Run as the shard of zone, -1 (the default) owns the whole backlog.
+    // A shard fetches the orders routed to its zone, and hands the orders of items it
+    // does not stock, or stocks no more, back to the coordinator instead of closing them
+    // A shard's pooled connections carry the zone statements, see DBConnector::enable_zone_statements
+    void set_zone(int zone);
+    int get_zone() const { return zone_; }
+
     // Update expired orders in the database
     void update_expired_orders(pqxx::connection& conn, const TimePoint& simulation_date);
 
@@ -31,9 +48,56 @@ public:
     // Update completed orders in the database
     void update_completed_orders(pqxx::connection& conn, const Taskpool& taskpool);
 
+    // In-memory half of the updates: drop the orders from the cache and return the IDs to write
+    std::vector<std::string> take_completed_orders(const Taskpool& taskpool);
+    // Items gone out of stock since the previous call, each one is returned once
+    std::vector<std::string> take_stock_out_items();
+    // Orders fetched after their item went out, closed by ID
+    std::vector<std::string> take_stock_out_orders();
+    // Zone shard only: orders fetched for items the zone does not stock
+    std::vector<std::string> take_unrouted_orders();
+
+    // Database half of the updates. They touch no OrderManager state, so a write-back
+    // stage can run them on its own connection while the next tick is fetched
+    static void write_expired_orders(pqxx::work& txn, const TimePoint& simulation_date);
+    static void write_completed_orders(pqxx::work& txn, const std::vector<std::string>& order_ids);
+    // With zone >= 0 the orders are handed back to the coordinator rather than closed
+    static void write_stock_out_orders(pqxx::work& txn, const std::vector<std::string>& item_ids, int zone = -1);
+    static void write_stock_out_order_ids(pqxx::work& txn, const std::vector<std::string>& order_ids);
+    static void write_unrouted_orders(pqxx::work& txn, const std::vector<std::string>& order_ids);
+
+    // OrderStore on a pooled connection per call
+    std::vector<Order> get_backlog(const TimePoint& simulation_date) override;
+    void expire_orders(const TimePoint& simulation_date) override;
+    void complete_orders(const Taskpool& taskpool, const TimePoint& simulation_date) override;
+    void stock_out_orders(const TimePoint& simulation_date) override;
+
+    // Interned IDs of the orders in the cache. An order's index is released once it
+    // leaves the cache, and reused from the fetch after next, when no solve knows it
+    const SymbolTable& get_order_ids() const { return order_ids_; }
+
 private:
+    // Drop cached orders due before simulation_date
+    void drop_expired(const TimePoint& simulation_date);
+
     DBConnector& db_connector_;
     StockManager& stock_;
+    SymbolTable order_ids_;
+    // Indices of the orders dropped since the last fetch, released by the next one
+    std::vector<OrderIdx> released_;
+
+    // PENDING orders fetched so far, by index
+    std::map<OrderIdx, Order> backlog_cache_;
+    // Highest backlog.seq already in the cache, backlog.zone_seq for a zone shard
+    long long last_seq_ = 0;
+
+    // Entries of stock_.stock_out_items_ taken so far and the items they name
+    size_t stock_out_seen_ = 0;
+    std::unordered_set<ItemIdx> stock_out_items_;
+    std::vector<std::string> stock_out_orders_;
+
+    int zone_ = -1;
+    std::vector<std::string> unrouted_;
 };
 
 }
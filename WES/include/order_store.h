@@ -0,0 +1,50 @@
+#ifndef ORDER_STORE_H
+#define ORDER_STORE_H
+
+#include <array>
+#include <vector>
+#include "types.h"
+#include "order.h"
+
+namespace SS {
+
+/**
+ * @brief Where the WES loop reads its backlog from and closes orders in
+ *
+ * OrderManager implements it on Postgres, MemoryOrderStore in memory for the
+ * offline simulation. Closure dates follow each store's clock: MemoryOrderStore
+ * stamps simulation_date, the database keeps its wall-clock closure dates.
+ */
+class OrderStore {
+public:
+    virtual ~OrderStore() = default;
+
+    // Pending orders with their priority at simulation_date, orders past due are left out
+    virtual std::vector<Order> get_backlog(const TimePoint& simulation_date) = 0;
+
+    // Close pending orders due before simulation_date as EXPIRED
+    virtual void expire_orders(const TimePoint& simulation_date) = 0;
+
+    // Close the orders of a taskpool as COMPLETED
+    virtual void complete_orders(const Taskpool& taskpool, const TimePoint& simulation_date) = 0;
+
+    // Close pending orders of stock out items as STOCK_OUT
+    virtual void stock_out_orders(const TimePoint& simulation_date) = 0;
+};
+
+/**
+ * @brief Order priority by (simulation_date - due_date) in minutes
+ * Up to minutes[0] -> priorities[0], up to minutes[1] -> priorities[1], ..., later -> priorities[3]
+ */
+struct PriorityBands {
+    std::array<int, 3> minutes = {35, 120, 360};
+    std::array<int, 4> priorities = {100, 50, 10, 1};
+};
+
+// Priority of an order at simulation_date
+int order_priority(const TimePoint& simulation_date, const TimePoint& due_date,
+                   const PriorityBands& bands = PriorityBands());
+
+}
+
+#endif // ORDER_STORE_H
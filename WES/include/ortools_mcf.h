@@ -0,0 +1,39 @@
+#ifndef ORTOOLS_MCF_H
+#define ORTOOLS_MCF_H
+
+#include <memory>
+#include "mcf_solver.h"
+#include "ortools/graph/min_cost_flow.h"
+
+namespace SS {
+
+/**
+ * @brief MCFSolver backed by operations_research::SimpleMinCostFlow
+ *
+ * Only built with WES_WITH_ORTOOLS.
+ */
+class OrToolsMCF : public MCFSolver {
+public:
+    OrToolsMCF();
+
+    void set_node_supply(int node, int supply) override;
+    int add_arc(int tail, int head, int capacity, int cost) override;
+    void clear() override;
+
+    MCFStatus solve() override;
+
+    int num_nodes() const override { return static_cast<int>(min_cost_flow_->NumNodes()); }
+    int num_arcs() const override { return static_cast<int>(min_cost_flow_->NumArcs()); }
+    int tail(int arc) const override { return static_cast<int>(min_cost_flow_->Tail(arc)); }
+    int head(int arc) const override { return static_cast<int>(min_cost_flow_->Head(arc)); }
+    int flow(int arc) const override { return static_cast<int>(min_cost_flow_->Flow(arc)); }
+    long long optimal_cost() const override { return min_cost_flow_->OptimalCost(); }
+
+private:
+    // Neither copyable nor movable, clear() replaces it
+    std::unique_ptr<operations_research::SimpleMinCostFlow> min_cost_flow_;
+};
+
+}
+
+#endif // ORTOOLS_MCF_H
@@ -0,0 +1,71 @@
+#ifndef PARALLEL_MCF_H
+#define PARALLEL_MCF_H
+
+#include <memory>
+#include <vector>
+#include "types.h"
+#include "order.h"
+#include "stock.h"
+#include "incremental_mcf.h"
+#include "mcf_solver.h"
+#include "thread_pool.h"
+
+namespace SS {
+
+/**
+ * @brief Shelf selection MCF decomposed into independent item clusters
+ *
+ * The item-routed graph splits into one component per item: faces reach the sink
+ * through uncapacitated arcs, so sharing a face couples nothing. Components are
+ * packed into clusters of similar size and each cluster is solved as its own MCF on
+ * the thread pool. The global supply limit is reconciled with an integer price on
+ * the source arcs: a bisection finds the lowest price at which the clusters ask for
+ * at most limit units, and the units priced exactly at the threshold are handed
+ * out greedily in a final capped solve.
+ */
+class ParallelMCF {
+public:
+    ParallelMCF(const StockManager& stock, ThreadPool& pool, MCFBackend backend = MCFBackend::NATIVE);
+
+    // Optimal picks for at most limit orders; cost uses the same units as the MCF objective
+    std::vector<Pick> solve(const std::vector<Order>& orders, const std::vector<int>& rack_costs,
+                            int limit, long long& cost);
+
+    // Statistics of the last solve
+    int num_components() const { return num_components_; }
+    int num_clusters() const { return static_cast<int>(clusters_.size()); }
+    int rounds() const { return rounds_; }
+    int num_nodes() const { return num_nodes_; }
+    int num_arcs() const { return num_arcs_; }
+
+private:
+    struct Cluster {
+        std::vector<ItemIdx> items;
+        std::vector<size_t> orders; // indices in the orders vector, grouped by item
+        size_t size = 0;            // arcs, used to balance the clusters
+    };
+
+    // Solve a cluster with source arcs priced at lambda and at most cap units
+    // Returns the number of units routed and fills picks, nodes and arcs when they are not null
+    int solve_cluster(size_t c, const std::vector<Order>& orders,
+                      const std::vector<int>& rack_costs, int lambda, int cap,
+                      std::vector<Pick>* picks, int* nodes, int* arcs) const;
+
+    // Solve every cluster concurrently, returns the units routed per cluster
+    std::vector<int> solve_all(const std::vector<Order>& orders, const std::vector<int>& rack_costs,
+                               int lambda, const std::vector<int>& caps);
+
+    const StockManager& stock_;
+    ThreadPool& pool_;
+    MCFBackend backend_;
+    std::vector<Cluster> clusters_;
+    std::vector<std::unique_ptr<MCFSolver>> solvers_; // one per cluster, kept between solves
+    int num_components_ = 0;
+    int rounds_ = 0;
+    int num_nodes_ = 0;
+    int num_arcs_ = 0;
+};
+
+}
+
+#endif // PARALLEL_MCF_H
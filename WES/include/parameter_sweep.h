@@ -0,0 +1,62 @@
+#ifndef PARAMETER_SWEEP_H
+#define PARAMETER_SWEEP_H
+
+#include <array>
+#include <string>
+#include <vector>
+#include "types.h"
+#include "order.h"
+#include "stock.h"
+#include "simulation.h"
+
+namespace SS {
+
+/**
+ * @brief Values to try for every policy parameter
+ *
+ * Read from a json file whose keys are the member names; a missing key keeps the
+ * SimulationConfig default. The grid is the cartesian product of all lists.
+ */
+struct SweepSpec {
+    std::vector<int> hot_cost;
+    std::vector<int> warm_cost;
+    std::vector<int> cold_cost;
+    std::vector<double> warm_racks_fraction;
+    std::vector<std::array<int, 3>> priority_minutes;
+    std::vector<std::array<int, 2>> capacity;   // [min, max]
+    std::vector<int> seed;
+    size_t samples = 0;      // 0 runs the whole grid, otherwise that many distinct random points
+    int sample_seed = 28;
+
+    static SweepSpec from_json_file(const std::string& file_path);
+
+    // Configs of the grid or of the sample, in grid order
+    std::vector<SimulationConfig> expand(const SimulationConfig& base) const;
+};
+
+/**
+ * @brief Runs independent offline simulations in parallel
+ *
+ * Every run has its own Simulation, so its own StockManager copy, ShelfSelection and
+ * order store; the stock and the backlog are parsed once and shared read-only.
+ */
+class ParameterSweep {
+public:
+    ParameterSweep(const StockManager& stock, const std::vector<Order>& orders);
+
+    // Run every config on num_threads workers (0 means one per hardware thread)
+    // Results are in config order
+    std::vector<SimulationMetrics> run(const std::vector<SimulationConfig>& configs, size_t num_threads = 0) const;
+
+    // One CSV row per run: parameters, then throughput, expiry rate, rack visits and solve time
+    static void write_csv(const std::string& file_path, const std::vector<SimulationConfig>& configs,
+                          const std::vector<SimulationMetrics>& results);
+
+private:
+    const StockManager& stock_;
+    const std::vector<Order>& orders_;
+};
+
+}
+
+#endif // PARAMETER_SWEEP_H
@@ -2,37 +2,184 @@
 #define SHELF_SELECTOR_H
 
 #include <vector>
-#include <deque>
+#include <map>
 #include <set>
 #include "order.h"
 #include "stock.h"
+#include <memory>
+#include <future>
+#include "mcf_solver.h"
+#include "incremental_mcf.h"
+#include "parallel_mcf.h"
+#include "greedy_selection.h"
+#include "fixed_charge_mcf.h"
+#include "thread_pool.h"
 
 namespace SS {
 
+/**
+ * @brief How solve_mcf builds and solves the flow problem
+ */
+enum class SolverMode {
+    DENSE,       // Every order is connected to every (rack, face) stocking its item, no item nodes
+    SPARSE,      // Orders are routed through item nodes to the faces that stock the item
+    INCREMENTAL, // SPARSE graph kept alive between iterations, only changed items are rebuilt
+    PARALLEL,    // SPARSE graph split into item clusters solved concurrently on a thread pool
+    GREEDY,      // Priority-ordered greedy plus exchange pass under a time budget, not always optimal
+    FIXED_CHARGE // SPARSE graph with a rack layer, fixed cost per rack/face opened (TripCosts), heuristic
+};
+
+/**
+ * @brief Size and timing of the last MCF solve
+ */
+struct MCFStats {
+    int num_nodes = 0;
+    int num_arcs = 0;
+    long long optimal_cost = 0;
+    int assigned_orders = 0;     // Order lines, each one complete
+    int assigned_units = 0;
+    int split_orders = 0;        // Lines picked from more than one face
+    int dropped_orders = 0;      // Lines routed in part, or not worth their split, left in the backlog
+    int components = 0;          // INCREMENTAL/PARALLEL: items with orders and stock
+    int rebuilt_components = 0;  // INCREMENTAL: items rebuilt because of a delta
+    int rounds = 0;              // PARALLEL: price coordination rounds
+    SolverMode mode = SolverMode::SPARSE; // Engine run() picked for this solve
+    bool timed_out = false;      // GREEDY/FIXED_CHARGE: stopped by the time budget
+    bool shadowed = false;       // GREEDY: a finished shadow MCF is reported below
+    long long shadow_heuristic_cost = 0; // GREEDY cost of the shadowed iteration
+    long long shadow_optimal_cost = 0;   // Exact MCF cost of the same iteration
+    double shadow_ms = 0.0;
+    int racks_opened = 0;        // Distinct racks and (rack, face) pairs in the taskpool
+    int faces_opened = 0;
+    int linear_racks_opened = 0; // FIXED_CHARGE: racks the objective without fixed charges opened
+    int iterations = 0;          // FIXED_CHARGE: slope scaling solves
+    double build_ms = 0.0;       // Graph construction, or delta application for INCREMENTAL
+    double solve_ms = 0.0;
+};
+
+/**
+ * @brief Unit cost of picking from a rack by its status, lower is preferred
+ */
+struct RackCosts {
+    int hot = -5;    // Rack already at a station
+    int warm = -3;   // Among the most recently visited racks
+    int cold = -1;
+};
+
 /**
  * @brief Core shelf selection algorithm using MCF optimization
  */
 class ShelfSelection {
 public:
     // Constructor
-    ShelfSelection(StockManager& stock);
+    ShelfSelection(StockManager& stock, SolverMode mode = SolverMode::SPARSE);
     
-    // Main method
+    // Main method, N is the capacity in units and pending faces still hold part of it
     Taskpool run(const std::vector<Order>& orders, Taskpool& pending, const int& N);
 
     // MCF
     Taskpool solve_mcf(const std::vector<Order>& orders, const int& limit);
     
     // Helper methods
-    void set_rack_warm(const RackID& rack_id);
+    void set_rack_warm(RackIdx rack);
     void reset_hot_racks();
+
+    // Rack costs by status and the share of racks kept warm (20% unless set)
+    void set_rack_costs(const RackCosts& costs) { rack_costs_ = costs; }
+    const RackCosts& get_rack_costs() const { return rack_costs_; }
+    void set_warm_racks_fraction(double fraction);
+
+    // Solver mode
+    void set_solver_mode(SolverMode mode) { mode_ = mode; }
+    SolverMode get_solver_mode() const { return mode_; }
+
+    // Min cost flow engine, NATIVE unless set
+    void set_backend(MCFBackend backend);
+    MCFBackend get_backend() const { return backend_; }
+
+    // Time budget of one run(), 0 disables. When the exact mode is expected to take longer,
+    // run() switches to GREEDY with that budget
+    void set_deadline_ms(double deadline_ms) { deadline_ms_ = deadline_ms; }
+
+    // Solve every n-th GREEDY iteration again with the exact MCF in the background, 0 disables
+    void set_shadow_sampling(int every) { shadow_every_ = every; }
+
+    // Cost of picking a line from one more face, compared with priority x quantity (5 unless set)
+    void set_split_penalty(int penalty) { split_penalty_ = penalty; }
+    int get_split_penalty() const { return split_penalty_; }
+
+    // Fixed cost of a rack trip and time limit used by FIXED_CHARGE
+    void set_trip_costs(const TripCosts& costs) { fixed_charge_.set_trip_costs(costs); }
+    const TripCosts& get_trip_costs() const { return fixed_charge_.get_trip_costs(); }
+
+    // Worker threads used by PARALLEL, 0 means one per hardware thread
+    void set_num_threads(size_t num_threads);
+
+    // Statistics of the last solve_mcf call
+    const MCFStats& get_last_stats() const { return last_stats_; }
+
+    // Units per (rack, face) of the last taskpool, updated by every solve
+    const FaceUnits& get_face_units() const { return face_units_; }
     
 private:
+    // Graph builders, both fill the taskpool and update stock
+    Taskpool solve_mcf_dense(const std::vector<Order>& orders, const int& limit);
+    Taskpool solve_mcf_sparse(const std::vector<Order>& orders, const int& limit);
+    Taskpool solve_mcf_incremental(const std::vector<Order>& orders, const int& limit);
+    Taskpool solve_mcf_parallel(const std::vector<Order>& orders, const int& limit);
+    Taskpool solve_mcf_greedy(const std::vector<Order>& orders, const int& limit);
+    Taskpool solve_mcf_fixed_charge(const std::vector<Order>& orders, const int& limit);
+    Taskpool solve_mcf(const std::vector<Order>& orders, const int& limit, SolverMode mode);
+
+    // Engine for a backlog: mode_, or GREEDY when the exact solve would miss the deadline
+    SolverMode choose_mode(size_t num_orders) const;
+
+    // Stage times and graph gauges of the last solve, total_ms covers the whole solve_mcf call
+    void record_metrics(double total_ms) const;
+
+    // Report a finished shadow solve and start a new one on sampled iterations
+    void poll_shadow();
+    void start_shadow(const std::vector<Order>& orders, int limit, long long heuristic_cost);
+
+    // Current unit cost of every rack
+    std::vector<int> rack_costs() const;
+
+    // Turn the engine picks into complete order lines and apply them
+    Taskpool settle_picks(const std::vector<Order>& orders, const std::vector<Pick>& picks);
+
+    // Repack the items with multi-unit lines: drop partial lines, limit and charge the splits
+    std::vector<Pick> settle_lines(const std::vector<Order>& orders, const std::vector<Pick>& picks);
+
+    // Record a pick in the taskpool, warm its rack and take its units from stock
+    void apply_pick(const Pick& pick, Taskpool& taskpool);
+
+    // Unit cost of picking from a rack according to its hot/warm status
+    int rack_cost(RackIdx rack) const;
+
     // Member variables
     StockManager& stock_;
-    std::deque<RackID> warm_racks_;
-    std::set<RackID> hot_racks_;
+    std::set<RackIdx> hot_racks_;
     size_t warm_racks_limit;
+    RackCosts rack_costs_;
+    SolverMode mode_;
+    MCFStats last_stats_;
+    MCFBackend backend_;
+    std::unique_ptr<MCFSolver> solver_;
+    IncrementalMCF incremental_;
+    size_t num_threads_ = 0;
+    std::unique_ptr<ThreadPool> pool_;
+    std::unique_ptr<ParallelMCF> parallel_;
+    GreedySelection greedy_;
+    FixedChargeMCF fixed_charge_;
+    double deadline_ms_ = 0.0;
+    int split_penalty_ = 5;
+    FaceUnits face_units_;              // units per face of the last taskpool
+    double exact_ms_per_order_ = 0.0;   // last exact solve time, live or shadow
+    int shadow_every_ = 10;
+    int greedy_runs_ = 0;
+    size_t shadow_orders_ = 0;
+    std::future<MCFStats> shadow_;
+    bool shadow_instance_ = false;      // the exact solve of start_shadow, records no metrics
 };
 
 }
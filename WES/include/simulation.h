@@ -0,0 +1,133 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "types.h"
+#include "order.h"
+#include "stock.h"
+#include "shelf_selection.h"
+#include "task_manager.h"
+#include "station_manager.h"
+#include "memory_order_store.h"
+#include "trigger_policy.h"
+
+namespace SS {
+
+/**
+ * @brief Settings of an offline simulation run
+ */
+struct SimulationConfig {
+    TimePoint start_date;
+    TimePoint end_date;
+    SolverMode mode = SolverMode::INCREMENTAL;
+    bool event_driven = true;       // Trigger on arrivals as well, not only every trigger_policy.fallback
+    TriggerPolicy trigger_policy;   // In simulated time
+    int seed = 28;                  // TaskManager seed
+    // Policy parameters, wes.cpp defaults
+    RackCosts rack_costs;
+    double warm_racks_fraction = 0.2;
+    PriorityBands priority_bands;
+    TripCosts trip_costs;           // FIXED_CHARGE only
+    int split_penalty = 5;          // Per extra face a multi-unit line is picked from
+    int min_capacity = 1000;        // TaskManager capacity range, per CAPACITY_PERIOD
+    int max_capacity = 2000;
+    int stations = 0;               // Pick stations sharing the capacity range, 0 keeps the single TaskManager
+    // Write stock and backlog snapshots to snapshot_dir every snapshot_every ticks, 0 = never
+    int snapshot_every = 0;
+    std::string snapshot_dir;
+};
+
+/**
+ * @brief One shelf selection iteration of the simulation
+ */
+struct SimulationTick {
+    int tick = 0;
+    TimePoint date;
+    Trigger trigger = Trigger::TIMER;
+    size_t backlog_size = 0;
+    int capacity = 0;              // Units accrued since the previous tick
+    int assigned_orders = 0;
+    int assigned_units = 0;
+    size_t racks = 0;              // Racks visited by the taskpool
+    size_t faces = 0;              // (rack, face) pairs presented
+    size_t linear_racks = 0;       // Racks the objective without trip costs opened, same as racks unless FIXED_CHARGE
+    size_t pending_tasks = 0;      // (rack, face) tasks left pending
+    double travel = 0.0;           // Grid distance of the racks sent to a station, 0 without stations
+    long long cost = 0;            // MCF objective
+    double solve_ms = 0.0;         // Wall time of run(), not deterministic
+};
+
+/**
+ * @brief Outcome of a simulation run. Everything but the timings is deterministic
+ */
+struct SimulationMetrics {
+    int ticks = 0;
+    size_t orders = 0;
+    size_t published = 0;
+    size_t completed = 0;
+    size_t expired = 0;
+    size_t stock_out = 0;
+    size_t open = 0;                 // Published and still pending at the end
+    long long rack_visits = 0;
+    long long linear_rack_visits = 0;  // Sum of the per-tick linear_racks
+    double travel = 0.0;             // Sum of the per-tick travel
+    double mean_lead_minutes = 0.0;  // Creation to completion
+    double solve_ms_total = 0.0;
+    double solve_ms_max = 0.0;
+    double wall_ms = 0.0;
+};
+
+/**
+ * @brief Discrete-event replay of the WES loop without Postgres
+ *
+ * The backlog lives in a MemoryOrderStore and time is virtual: the clock jumps to the
+ * next trigger instead of sleeping. Triggers follow OrderListener in simulated time:
+ * min_orders arrivals, max_delay after the first arrival, or fallback after the
+ * previous tick. Each tick runs the same steps as wes.cpp, with the capacity the
+ * stations accrued since the previous tick.
+ *
+ * Stock and orders are copied, so independent simulations can run side by side.
+ */
+class Simulation {
+public:
+    Simulation(const SimulationConfig& config, const StockManager& stock, const std::vector<Order>& orders);
+
+    // Run from start_date to end_date
+    const SimulationMetrics& run();
+
+    // Write sim_metrics.json and sim_ticks.csv to output_dir, deterministic fields only
+    void write_outputs(const std::string& output_dir) const;
+
+    // Write <prefix>stock.snap and <prefix>backlog.snap with the current state to output_dir
+    // A run restarted from them at the snapshot date goes on with the same stock and open orders
+    void write_snapshots(const std::string& output_dir, const std::string& prefix = "") const;
+
+    const SimulationMetrics& get_metrics() const { return metrics_; }
+    const std::vector<SimulationTick>& get_ticks() const { return ticks_; }
+
+private:
+    // One WES iteration at date
+    void tick(const TimePoint& date, Trigger trigger);
+
+    // Date and reason of the next iteration after last_tick
+    TimePoint next_trigger(const TimePoint& last_tick, Trigger& trigger) const;
+
+    // Fill metrics_ from the order statuses
+    void collect_metrics();
+
+    SimulationConfig config_;
+    StockManager stock_;
+    MemoryOrderStore store_;
+    ShelfSelection shelf_selection_;
+    std::unique_ptr<TaskExecutor> task_manager_;
+    StationManager* stations_ = nullptr;  // task_manager_ when config.stations > 0
+    Taskpool pending_;
+    std::vector<SimulationTick> ticks_;
+    SimulationMetrics metrics_;
+};
+
+}
+
+#endif // SIMULATION_H
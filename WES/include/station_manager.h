@@ -0,0 +1,121 @@
+#ifndef STATION_MANAGER_H
+#define STATION_MANAGER_H
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <vector>
+#include "types.h"
+#include "task_manager.h"
+#include "thread_pool.h"
+
+namespace SS {
+
+/**
+ * @brief One pick station: its throughput and where it sits on the rack grid
+ */
+struct StationConfig {
+    int min_capacity = 80;   // Capacity is drawn uniformly from [min_capacity, max_capacity] every tick
+    int max_capacity = 170;
+    int max_pending = 8;     // Up to this many of its tasks are left pending every tick
+    double x = 0.0;
+    double y = -1.0;
+};
+
+/**
+ * @brief Stations of the site and how racks are assigned to them
+ *
+ * The stock has no rack positions, racks are laid out row-major on a grid of
+ * grid_columns columns: rack r stands at (r % grid_columns, r / grid_columns).
+ */
+struct StationLayout {
+    std::vector<StationConfig> stations;
+    int grid_columns = 10;
+    // Travel a station running at full capacity is worth, trades balance against distance
+    double balance_weight = 20.0;
+};
+
+// num_stations stations evenly along the front edge of the grid (y = -1), sharing the
+// site capacity range and the 0-100 pending tasks of the single-station model
+StationLayout make_station_layout(int num_stations, int min_capacity = 1000, int max_capacity = 2000,
+                                  int grid_columns = 10);
+
+/**
+ * @brief What one station got in the last tick
+ */
+struct StationStats {
+    int capacity = 0;          // Drawn by the last get_available_capacity() or accrue_capacity()
+    int queued_units = 0;      // Units of its pending tasks at the start of the tick
+    int racks = 0;             // Racks assigned, pending ones included
+    int orders = 0;            // Order lines of the assigned racks
+    int units = 0;             // Units of the assigned racks
+    int pending_tasks = 0;     // (rack, face) tasks it left pending
+    double travel = 0.0;       // Grid distance of its new racks
+    bool overflow = false;     // Queued and assigned units exceed its capacity
+};
+
+/**
+ * @brief Several pick stations, each with its own capacity, queue and pending tasks
+ *
+ * Every station has a TaskManager with its own seed, so the draws do not depend on
+ * thread scheduling. A tick goes:
+ *
+ *   get_available_capacity()  draws every station's capacity, returns their sum
+ *   accrue_capacity(elapsed)  same, every station accruing its share of the period
+ *   process_tasks(taskpool)   assigns the racks to stations, then every station
+ *                             processes its share concurrently on the pool
+ *
+ * Load is counted in units, like the capacity: the units of a face come from the
+ * shelf selection (set_face_units), a face it does not know counts one unit per line.
+ * Assignment is greedy, heaviest rack first. A rack still pending at a station stays
+ * there, it is already in that queue. Any other rack goes, with all its faces, to the
+ * station with room for it minimizing
+ *
+ *   travel(rack, station) + balance_weight * (load + rack units) / capacity
+ *
+ * load being the units the station has queued and assigned so far this tick. Capacity
+ * is a hard limit: a full station passes the rack to the next best one. A rack no
+ * station has room for (racks do not split) goes to the one with the most room left.
+ */
+class StationManager : public TaskExecutor {
+public:
+    // 0 threads means one per hardware thread, capped at the number of stations
+    StationManager(const StationLayout& layout, int seed = 28, size_t num_threads = 0);
+
+    Taskpool process_tasks(const Taskpool& taskpool) override;
+    int get_available_capacity() override;
+    int accrue_capacity(std::chrono::milliseconds elapsed) override;
+
+    // Units per (rack, face) of the taskpools passed to process_tasks, kept up to date by
+    // their producer, see ShelfSelection::get_face_units. nullptr counts one unit per line
+    void set_face_units(const FaceUnits* face_units) { face_units_ = face_units; }
+
+    // Rack to station split of a taskpool with the current capacities and queues
+    std::vector<Taskpool> assign(const Taskpool& taskpool) const;
+
+    // Grid distance from rack to station
+    double travel(RackIdx rack, size_t station) const;
+
+    size_t num_stations() const { return stations_.size(); }
+    const StationLayout& get_layout() const { return layout_; }
+    const std::vector<StationStats>& get_last_stats() const { return last_stats_; }
+    // Pending tasks of each station
+    const std::vector<Taskpool>& get_queues() const { return queues_; }
+
+private:
+    StationLayout layout_;
+    std::vector<TaskManager> stations_;
+    std::vector<int> capacity_;
+    // Units of the faces of a rack
+    int count_units(RackIdx rack, const std::map<FaceIdx, std::vector<OrderIdx>>& faces) const;
+
+    std::vector<Taskpool> queues_;
+    std::vector<int> queued_units_;       // units of queues_, counted when they were assigned
+    const FaceUnits* face_units_ = nullptr;
+    std::vector<StationStats> last_stats_;
+    std::unique_ptr<ThreadPool> pool_;
+};
+
+}
+
+#endif // STATION_MANAGER_H
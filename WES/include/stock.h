@@ -1,54 +1,124 @@
 #ifndef STOCK_H
 #define STOCK_H
 
+#include <deque>
 #include <map>
 #include <string>
 #include <vector>
 #include <nlohmann/json_fwd.hpp>
 #include "rack.h"
-#include <set>
+#include "symbol_table.h"
+#include "flat_stock.h"
+#include "json_parser.h"
 
 namespace SS {
 
+/**
+ * @brief Stocked quantity of an item at a (rack, face) location
+ */
+struct StockLocation {
+    RackIdx rack;
+    FaceIdx face;
+    int quantity;
+};
+
+/**
+ * @brief Storage layout of the inventory
+ */
+enum class StockBackend {
+    MAP,  // Nested std::map rack -> face -> item -> quantity
+    FLAT  // Columnar FlatStock, face-major slots with CSR item lists
+};
+
 /**
  * @brief Represents the stock of items in the shelf selection system
+ * Racks, faces and items are interned at load time; all lookups use the dense indices
  */
 class StockManager {
 public:
-    // Constructor - loads stock from JSON file
-    StockManager(const std::string& stock_file_path);
+    // Constructor - loads stock from a JSON file or from a snapshot written by save_snapshot
+    // Every parser yields the same indices: racks and faces are interned in key order, like the DOM walk
+    StockManager(const std::string& stock_file_path, StockBackend backend = StockBackend::FLAT,
+                 JsonParser parser = default_json_parser());
 
-    // Load and process stock from JSON file
+    // Load and process stock from the JSON or snapshot file
     void load_stock();
 
+    // Write the current state (IDs, quantities, inverted index, stock outs, rack flags) as a binary
+    // snapshot, loading it gives back the same indices and the same state, mid-simulation included
+    void save_snapshot(const std::string& file_path) const;
+
     // Get/Set item quantity at specific location (rack, face, item)
-    int get_item_quantity(const RackID& rack_id, const FaceID& face_id, const ItemID& item_id) const;
-    void set_item_quantity(const RackID& rack_id, const FaceID& face_id, const ItemID& item_id, int quantity);
+    int get_item_quantity(RackIdx rack, FaceIdx face, ItemIdx item) const;
+    void set_item_quantity(RackIdx rack, FaceIdx face, ItemIdx item, int quantity);
 
     // Get total quantity of an item across all locations
-    int get_total_quantity(const ItemID& item_id) const;
+    int get_total_quantity(ItemIdx item) const;
+
+    // Get the locations holding a positive quantity of an item, O(1) lookup
+    const std::vector<StockLocation>& get_item_locations(ItemIdx item) const;
+
+    // True if the item has no stock left at any location
+    bool is_stock_out(ItemIdx item) const { return get_item_locations(item).empty(); }
+
+    // Counter bumped by every set_item_quantity on the item, lets callers cache per-item state
+    uint32_t get_item_version(ItemIdx item) const { return item < item_versions_.size() ? item_versions_[item] : 0; }
+
+    // Append the items with positive quantity on any face of a rack
+    void get_rack_items(RackIdx rack, std::vector<ItemIdx>& items) const;
+
+    // Number of racks and faces, racks are indexed 0..num_racks()-1
+    size_t num_racks() const { return rack_ids_.size(); }
+    size_t num_faces() const { return face_ids_.size(); }
 
-    // Get all rack IDs in inventory
-    const std::set<RackID>& get_racks() const { return racks_; }
+    // Symbol tables mapping external IDs to indices
+    const SymbolTable& get_rack_ids() const { return rack_ids_; }
+    const SymbolTable& get_face_ids() const { return face_ids_; }
+    const SymbolTable& get_item_ids() const { return item_ids_; }
 
-    // Get all face IDs in inventory
-    const std::set<FaceID>& get_faces() const { return faces_; }
+    // Storage layout in use
+    StockBackend get_backend() const { return backend_; }
 
-    // Get the entire stock structure
+    // Get the entire stock structure (MAP backend only, empty otherwise)
     const Stock& get_inventory() const { return inventory_; }
 
+    // Get the columnar store (FLAT backend only, empty otherwise)
+    const FlatStock& get_flat_stock() const { return flat_; }
+
+    // Approximate bytes held by the inventory, the totals and the inverted index
+    size_t memory_usage() const;
+
     // Stock out items
-    std::vector<ItemID> stock_out_items_;
+    std::vector<ItemIdx> stock_out_items_;
     
-    std::map<RackID, bool> is_rack_hot_;
-    std::map<RackID, bool> is_rack_warm_;
+    // Rack status flags, indexed by RackIdx (bit-packed)
+    std::vector<bool> is_rack_hot_;
+    std::vector<bool> is_rack_warm_;
+
+    // Warm racks in visit order, oldest first; kept here so a snapshot restores the order
+    std::deque<RackIdx> warm_racks_;
 
 private:
+    // Streaming parsers collect (rack, face, item, quantity) rows here first
+    struct Staging;
+
+    StockBackend backend_;
+    JsonParser parser_;
+
     // Nested map structure: rack -> face -> item -> quantity
     Stock inventory_;
 
-    // Map to hold total quantity of each item across all locations
-    std::map<ItemID, int> items_quantity_;
+    // Columnar structure, used instead of inventory_ by the FLAT backend
+    FlatStock flat_;
+
+    // Total quantity of each item across all locations, indexed by ItemIdx
+    std::vector<int> items_quantity_;
+
+    // Inverted index: item -> locations with positive quantity, indexed by ItemIdx
+    std::vector<std::vector<StockLocation>> item_locations_;
+
+    // Modification counters, indexed by ItemIdx
+    std::vector<uint32_t> item_versions_;
 
     // Path to the stock JSON file
     std::string stock_file_path_;
@@ -56,10 +126,27 @@ private:
     // Helper to process JSON and populate inventory
     void process_stock_json(const nlohmann::json& json_data);
 
-    std::set<RackID> racks_;
-    std::set<FaceID> faces_;
+    // Streaming loaders, fill a Staging from the file
+    void load_stock_sax(Staging& staging) const;
+    void load_stock_simd(Staging& staging) const;
+
+    // Populate inventory from the staged rows in DOM order
+    void process_staging(const Staging& staging);
+
+    // Totals, versions, inverted index and FLAT store once inventory_ is filled
+    void finish_load();
+
+    // Restore the state from an mmapped snapshot
+    void load_snapshot();
+
+    // Rebuild the inverted index from inventory_
+    void build_item_locations();
+
+    SymbolTable rack_ids_;
+    SymbolTable face_ids_;
+    SymbolTable item_ids_;
 };
 
 }
 
-#endif // STOCK_H
\ No newline at end of file
+#endif // STOCK_H
@@ -2,29 +2,59 @@
 #define TASK_MANAGER_H
 
 #include "types.h"
+#include <chrono>
 #include <vector>
 #include <random>
 
 namespace SS {
 
+// Time a capacity draw covers: the 5-minute tick of the polling loop
+constexpr std::chrono::minutes CAPACITY_PERIOD{5};
+
+/**
+ * @brief Executes the taskpool of a tick at the pick stations
+ *
+ * TaskManager models the site as one station, StationManager as several.
+ */
+class TaskExecutor {
+public:
+    virtual ~TaskExecutor() = default;
+
+    // Process tasks from the taskpool, returns pending tasks
+    virtual Taskpool process_tasks(const Taskpool& taskpool) = 0;
+
+    // Units the stations can take in one CAPACITY_PERIOD
+    virtual int get_available_capacity() = 0;
+
+    // Units the stations took in since the previous tick, elapsed ago: a draw of
+    // get_available_capacity() scaled by elapsed / CAPACITY_PERIOD, at most one period.
+    // Event-driven ticks come much faster than the polling ones and get their share only
+    virtual int accrue_capacity(std::chrono::milliseconds elapsed) = 0;
+};
+
 /**
  * @brief Manages task execution and pending tasks
  * Processes tasks selected by Shelf Selector and returns pending tasks
  * In practice, this process is not instantaneous
  */
-class TaskManager {
+class TaskManager : public TaskExecutor {
 public:
-    // Constructor
-    TaskManager(int seed = 28);
+    // Constructor, capacity is drawn uniformly from [min_capacity, max_capacity] every tick
+    // and up to max_pending tasks are left pending
+    TaskManager(int seed = 28, int min_capacity = 1000, int max_capacity = 2000, int max_pending = 100);
 
     // Process tasks from the taskpool, returns pending tasks
-    Taskpool process_tasks(const Taskpool& taskpool);
+    Taskpool process_tasks(const Taskpool& taskpool) override;
 
     // Placeholder for available capacity retrieval
-    int get_available_capacity();
+    int get_available_capacity() override;
+
+    // The fraction of a unit left by short ticks carries over to the next one
+    int accrue_capacity(std::chrono::milliseconds elapsed) override;
 
 private:
     int seed_;
+    double carry_ = 0.0;
     std::uniform_int_distribution<int> dist1; // For pending tasks
     std::uniform_int_distribution<int> dist2; // For available capacity
 };
@@ -0,0 +1,124 @@
+#ifndef TICK_PIPELINE_H
+#define TICK_PIPELINE_H
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <pqxx/pqxx>
+#include "types.h"
+#include "bounded_queue.h"
+#include "db_connector.h"
+#include "order_manager.h"
+#include "shelf_selection.h"
+#include "task_manager.h"
+#include "zone_reporter.h"
+
+namespace SS {
+
+/**
+ * @brief Wall time of one WES tick by stage
+ */
+struct TickStats {
+    int tick = 0;
+    size_t backlog_size = 0;
+    size_t assigned_orders = 0;
+    double fetch_ms = 0;          // Delta fetch and backlog build
+    double solve_ms = 0;          // Shelf selection, including the stock decrements
+    double tasks_ms = 0;          // Task processing
+    double enqueue_ms = 0;        // Blocked on a full write-back queue
+    size_t queue_depth = 0;       // Write-backs waiting right after this tick was queued
+    size_t max_queue_depth = 0;   // Highest queue_depth so far
+    // Latest committed write-back, it belongs to an earlier tick while the pipeline is busy
+    int written_tick = 0;
+    double write_ms = 0;
+};
+
+/**
+ * @brief Two-stage WES tick: plan on the caller thread, write back on a worker thread
+ *
+ * Plan stage: fetch the backlog delta, solve the shelf selection and process the tasks.
+ * The capacity of a tick is what the stations accrued since the previous one, see
+ * TaskExecutor::accrue_capacity, so event-driven ticks do not each get a full period.
+ * Write-back stage: expire, complete and stock out the tick's orders in one transaction.
+ * The stages hand over through a bounded queue, so the write-back of tick k runs while
+ * tick k+1 is fetched and solved, and a slow database holds the planner back instead
+ * of piling up work. Both stages borrow their connection from the DBConnector pool
+ * for each use, so a dropped connection is replaced on the next tick.
+ *
+ * The stock and the order cache are only touched by the plan stage: stock decrements
+ * stay serialized in solve order, and the cache drops the orders of tick k before tick
+ * k+1 is built, so they are not assigned twice while their UPDATE is still queued.
+ * The write-back stage only sees the IDs to write.
+ */
+class TickPipeline {
+public:
+    TickPipeline(DBConnector& db_connector, OrderManager& order_manager, ShelfSelection& shelf_selection,
+                 TaskExecutor& task_manager, size_t queue_capacity = 2);
+
+    // Waits for the queued write-backs, then stops the write-back stage
+    ~TickPipeline();
+
+    TickPipeline(const TickPipeline&) = delete;
+    TickPipeline& operator=(const TickPipeline&) = delete;
+
+    // Run the plan stage for simulation_date and queue its write-back
+    // A failed write-back of an earlier tick is rethrown here
+    const TickStats& tick(const TimePoint& simulation_date);
+
+    // Block until every queued write-back is committed
+    void flush();
+
+    // Zone shard: report stock, claims and load to the coordinator with every write-back
+    // Set before the first tick; the reporter must outlive the pipeline, nullptr reports nothing
+    void set_zone_reporter(ZoneReporter* reporter) { zone_reporter_ = reporter; }
+
+    // Tasks left pending by the last tick
+    const Taskpool& get_pending() const { return pending_; }
+
+    const TickStats& get_last_stats() const { return last_stats_; }
+
+private:
+    struct WriteBack {
+        int tick;
+        TimePoint simulation_date;
+        std::vector<std::string> completed;
+        std::vector<std::string> stock_out;
+        std::vector<std::string> stock_out_orders;
+        int zone = -1;
+        std::vector<std::string> unrouted;
+        ZoneReport report;
+    };
+
+    void write_loop();
+    void write(const WriteBack& job);
+    void rethrow_write_error();
+
+    DBConnector& db_connector_;
+    OrderManager& order_manager_;
+    ShelfSelection& shelf_selection_;
+    TaskExecutor& task_manager_;
+    ZoneReporter* zone_reporter_ = nullptr;
+
+    BoundedQueue<WriteBack> queue_;
+    std::thread writer_;
+
+    // Shared with the write-back stage
+    std::mutex mutex_;
+    std::condition_variable idle_cv_;
+    size_t outstanding_ = 0;        // queued or being written
+    int written_tick_ = 0;
+    double write_ms_ = 0;
+    std::exception_ptr write_error_;
+
+    Taskpool pending_;
+    TimePoint last_date_;
+    TickStats last_stats_;
+    size_t max_queue_depth_ = 0;
+};
+
+}
+
+#endif // TICK_PIPELINE_H
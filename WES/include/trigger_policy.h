@@ -0,0 +1,23 @@
+#ifndef TRIGGER_POLICY_H
+#define TRIGGER_POLICY_H
+
+#include <chrono>
+
+namespace SS {
+
+/**
+ * @brief When an event-driven WES runs shelf selection
+ */
+struct TriggerPolicy {
+    int min_orders = 200;                                // Run once this many new orders were announced
+    std::chrono::milliseconds max_delay{1000};           // Or once the oldest announced order waited this long
+    std::chrono::milliseconds fallback{5 * 60 * 1000};   // Or after this long without running at all
+};
+
+enum class Trigger { COUNT, DELAY, TIMER };
+
+const char* to_string(Trigger trigger);
+
+}
+
+#endif // TRIGGER_POLICY_H
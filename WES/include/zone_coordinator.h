@@ -0,0 +1,58 @@
+#ifndef ZONE_COORDINATOR_H
+#define ZONE_COORDINATOR_H
+
+#include <vector>
+#include "types.h"
+#include "db_connector.h"
+#include "zone_router.h"
+
+namespace SS {
+
+/**
+ * @brief Outcome of one routing round
+ */
+struct CoordinatorStats {
+    int round = 0;
+    size_t fetched = 0;           // Unrouted PENDING orders read
+    size_t routed = 0;
+    size_t stock_out = 0;         // No zone holds the item, closed as STOCK_OUT
+    size_t waiting = 0;           // No zone has the item, but some zone has not reported yet
+    size_t reported_zones = 0;
+    std::vector<size_t> zone_orders;  // Orders routed to each zone
+    double round_ms = 0.0;
+};
+
+/**
+ * @brief Routes the backlog to the WES zone shards through Postgres
+ *
+ * A round runs in one transaction: read zone_status and zone_stock (written by the
+ * shards, see ZoneReporter), route the PENDING orders without a zone with the
+ * ZoneRouter, set their zone and a zone_seq, close the orders no zone can serve and
+ * NOTIFY zone_channel(z) for every zone that got orders. Orders a shard hands back
+ * (stock out in its zone, stale routing) lose their zone and are routed again.
+ *
+ * One coordinator per database: shards fetch above a zone_seq watermark, which is
+ * only safe while routing transactions commit one after the other.
+ */
+class ZoneCoordinator {
+public:
+    ZoneCoordinator(DBConnector& db_connector, int num_zones,
+                    const ZoneRouterOptions& options = ZoneRouterOptions(), int batch_size = 50000);
+
+    // One routing round of at most batch_size orders
+    const CoordinatorStats& route_once();
+
+    const ZoneRouter& get_router() const { return router_; }
+    const CoordinatorStats& get_last_stats() const { return last_stats_; }
+
+private:
+    DBConnector& db_connector_;
+    ZoneRouter router_;
+    int num_zones_;
+    int batch_size_;
+    CoordinatorStats last_stats_;
+};
+
+}
+
+#endif // ZONE_COORDINATOR_H
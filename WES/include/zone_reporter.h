@@ -0,0 +1,56 @@
+#ifndef ZONE_REPORTER_H
+#define ZONE_REPORTER_H
+
+#include <string>
+#include <vector>
+#include <pqxx/pqxx>
+#include "types.h"
+#include "order.h"
+#include "stock.h"
+
+namespace SS {
+
+/**
+ * @brief What a zone shard tells the coordinator after a tick
+ */
+struct ZoneReport {
+    int zone = -1;
+    int tick = 0;
+    int capacity = 0;
+    long long open_units = 0;            // Units of the orders still open in the zone
+    // Items whose stock or claimed units changed since the previous report
+    std::vector<std::string> item_ids;
+    std::vector<int> quantities;
+    std::vector<int> claimed;
+};
+
+/**
+ * @brief Shard side of the zone price step: stock, claims and load of one zone
+ *
+ * Only the items that changed since the previous report are sent, the first report
+ * sends every item of the zone. The rows go to zone_stock and zone_status in the
+ * shard's write-back transaction, together with the completions they account for.
+ */
+class ZoneReporter {
+public:
+    ZoneReporter(int zone, const StockManager& stock);
+
+    // Report after a tick. backlog is what the tick solved, the orders of taskpool
+    // were just completed and no longer claim stock
+    ZoneReport take_report(int tick, int capacity, const std::vector<Order>& backlog, const Taskpool& taskpool);
+
+    static void write_report(pqxx::work& txn, const ZoneReport& report);
+
+    int get_zone() const { return zone_; }
+
+private:
+    int zone_;
+    const StockManager& stock_;
+    // Last reported values by ItemIdx, -1 before the first report
+    std::vector<int> reported_quantity_;
+    std::vector<int> reported_claimed_;
+};
+
+}
+
+#endif // ZONE_REPORTER_H
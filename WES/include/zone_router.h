@@ -0,0 +1,94 @@
+#ifndef ZONE_ROUTER_H
+#define ZONE_ROUTER_H
+
+#include <string>
+#include <vector>
+#include "types.h"
+#include "order.h"
+#include "stock.h"
+#include "symbol_table.h"
+
+namespace SS {
+
+// Zone of an order the router could not place: no zone holds its item
+constexpr int NO_ZONE = -1;
+
+// Zone owning rack: racks are split in key order into num_zones contiguous blocks (aisles)
+int rack_zone(RackIdx rack, size_t num_racks, int num_zones);
+
+// Write the racks of each zone of stock as <output_dir>/zone_<z>_stock.json, the layout of
+// stock.json with only that zone's racks. Returns the file paths, indexed by zone
+std::vector<std::string> write_zone_stock_files(const StockManager& stock, int num_zones,
+                                                const std::string& output_dir);
+
+// NOTIFY channel the coordinator signals after routing orders to zone
+std::string zone_channel(int zone);
+
+// Zone's part of a site-wide total (capacity, stations) split evenly over num_zones,
+// the remainder going to the first zones. A shard runs with its zone's part of the site
+int zone_share(int total, int num_zones, int zone);
+
+/**
+ * @brief Price step settings of the ZoneRouter
+ */
+struct ZoneRouterOptions {
+    double price_step = 0.5;        // Price change per round at 100% overload (or idle capacity)
+    double scarcity_weight = 1.0;   // Weight of the share of a zone's stock of the item already claimed
+};
+
+/**
+ * @brief Routes backlog orders to the WES shards (zones) holding their item
+ *
+ * Every zone reports the stock of its items, the units its open orders already claim
+ * and its capacity. An item stocked in one zone goes there. An item stocked in several
+ * zones is settled by a bid per zone:
+ *
+ *   price(zone) + scarcity_weight * (claimed + quantity) / stock
+ *
+ * Prices are updated once per round, before routing, by a subgradient step on the
+ * relative overload: price += price_step * (open units / capacity - 1), floored at 0.
+ * A zone that keeps more work than it can pick gets dearer, so the orders it shares
+ * with other zones drift away from it; a zone with spare capacity gets cheaper down
+ * to 0, where only the scarcity term decides. Claims made while routing count right
+ * away, so one round spreads a burst of the same item over the zones holding it.
+ */
+class ZoneRouter {
+public:
+    explicit ZoneRouter(int num_zones, const ZoneRouterOptions& options = ZoneRouterOptions());
+
+    // Stock of item in zone and the units of the zone's open orders for it
+    void set_stock(int zone, const std::string& item_id, int quantity, int claimed);
+
+    // Capacity of zone's last tick and the units of its open orders
+    void set_load(int zone, int capacity, long long open_units);
+
+    // Zone of every order, NO_ZONE when no zone has the item in stock
+    // Updates the prices first, then claims the routed units
+    std::vector<int> route(const std::vector<Order>& orders);
+
+    // Sum of the stock of item over all zones, 0 for items no zone reported
+    long long total_quantity(const std::string& item_id) const;
+
+    int num_zones() const { return static_cast<int>(prices_.size()); }
+    double price(int zone) const { return prices_[zone]; }
+    long long open_units(int zone) const { return open_units_[zone]; }
+    int capacity(int zone) const { return capacity_[zone]; }
+
+private:
+    struct ZoneStock {
+        int zone;
+        int quantity;
+        int claimed;
+    };
+
+    ZoneRouterOptions options_;
+    SymbolTable item_ids_;
+    std::vector<std::vector<ZoneStock>> item_zones_;  // ItemIdx -> zones stocking it
+    std::vector<int> capacity_;
+    std::vector<long long> open_units_;
+    std::vector<double> prices_;
+};
+
+}
+
+#endif // ZONE_ROUTER_H
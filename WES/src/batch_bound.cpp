@@ -0,0 +1,265 @@
+#include "batch_bound.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <nlohmann/json.hpp>
+#include "task_manager.h"
+#include "utils.h"
+
+namespace SS {
+
+namespace {
+
+// Fixed point of the visit costs: a unit from rack r costs floor(VISIT_SCALE / u_r)
+constexpr int VISIT_SCALE = 1 << 16;
+// Above any visit cost, so serving one more unit always pays
+constexpr int SERVE_REWARD = VISIT_SCALE + 1;
+
+double elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Orders of one item and line quantity sharing the same window of periods
+struct OrderGroup {
+    ItemIdx item;
+    int first;
+    int last;
+    int quantity;   // Units per order
+    int count;      // Orders
+};
+
+}
+
+BatchBound::BatchBound(const BatchBoundConfig& config, const StockManager& stock, const std::vector<Order>& orders)
+    : config_(config), stock_(stock), orders_(orders) {
+    if (config_.period.count() <= 0) {
+        throw std::invalid_argument("Batch bound period must be positive");
+    }
+}
+
+const BatchBoundResult& BatchBound::solve() {
+    auto build_start = std::chrono::steady_clock::now();
+    result_ = BatchBoundResult{};
+    result_.orders = orders_.size();
+    for (const Order& order : orders_) {
+        result_.units += order.quantity;
+    }
+
+    // Period k is the tick at start_date + (k + 1) * period, as the polling simulation runs them
+    std::vector<TimePoint> period_dates;
+    for (TimePoint date = config_.start_date + config_.period; date < config_.end_date; date += config_.period) {
+        period_dates.push_back(date);
+    }
+    const int num_periods = static_cast<int>(period_dates.size());
+    result_.periods = period_dates.size();
+    TaskManager capacities(config_.seed, config_.min_capacity, config_.max_capacity);
+    for (int k = 0; k < num_periods; k++) {
+        result_.capacity.push_back(capacities.accrue_capacity(
+            std::chrono::duration_cast<std::chrono::milliseconds>(config_.period)));
+        // A simulation tick draws twice, process_tasks advances the seed the same way
+        capacities.process_tasks({});
+    }
+
+    // Group the orders by item, window and quantity
+    std::vector<OrderGroup> groups;
+    groups.reserve(orders_.size());
+    for (const Order& order : orders_) {
+        const ItemIdx item = stock_.get_item_ids().find(order.item_id);
+        if (item == INVALID_IDX || stock_.get_total_quantity(item) <= 0) {
+            result_.unstocked++;
+            continue;
+        }
+        const int first = static_cast<int>(std::lower_bound(period_dates.begin(), period_dates.end(),
+                                                            order.creation_date) - period_dates.begin());
+        const int last = static_cast<int>(std::upper_bound(period_dates.begin(), period_dates.end(),
+                                                           order.due_date) - period_dates.begin()) - 1;
+        if (first > last) {
+            result_.out_of_window++;
+            continue;
+        }
+        groups.push_back({item, first, last, std::max(1, order.quantity), 1});
+    }
+    std::sort(groups.begin(), groups.end(), [](const OrderGroup& a, const OrderGroup& b) {
+        return std::tie(a.item, a.first, a.last, a.quantity) < std::tie(b.item, b.first, b.last, b.quantity);
+    });
+    size_t num_groups = 0;
+    long long windowed = 0;
+    for (const OrderGroup& group : groups) {
+        windowed += group.quantity;
+        if (num_groups > 0 && std::tie(groups[num_groups - 1].item, groups[num_groups - 1].first,
+                                       groups[num_groups - 1].last, groups[num_groups - 1].quantity)
+                                  == std::tie(group.item, group.first, group.last, group.quantity)) {
+            groups[num_groups - 1].count++;
+        } else {
+            groups[num_groups++] = group;
+        }
+    }
+    groups.resize(num_groups);
+    result_.groups = num_groups;
+
+    // Largest delivery of one visit to each rack
+    const int max_capacity = result_.capacity.empty() ? 0
+        : *std::max_element(result_.capacity.begin(), result_.capacity.end());
+    std::vector<long long> rack_stock(stock_.num_racks(), 0);
+    long long total_stock = 0;
+    for (ItemIdx item = 0; item < stock_.get_item_ids().size(); item++) {
+        for (const StockLocation& location : stock_.get_item_locations(item)) {
+            rack_stock[location.rack] += location.quantity;
+            total_stock += location.quantity;
+        }
+    }
+    std::vector<int> visit_cost(stock_.num_racks(), 0);
+    for (RackIdx rack = 0; rack < stock_.num_racks(); rack++) {
+        const long long per_visit = std::min<long long>(max_capacity, rack_stock[rack]);
+        visit_cost[rack] = per_visit > 0 ? static_cast<int>(VISIT_SCALE / per_visit) : 0;
+    }
+
+    // Node layout: source, sink, items, groups, then the period tree (heap order, root 1)
+    int tree_size = 1;
+    while (tree_size < std::max(1, num_periods)) {
+        tree_size *= 2;
+    }
+    const int source = 0;
+    const int sink = 1;
+    const int first_item = 2;
+    const int first_group = first_item + static_cast<int>(stock_.get_item_ids().size());
+    const int first_tree = first_group + static_cast<int>(num_groups);
+    auto tree_node = [&](int v) { return first_tree + v; };
+
+    std::unique_ptr<MCFSolver> min_cost_flow = make_mcf_solver(config_.backend);
+    const long long servable = std::min(total_stock, windowed);
+    const int flow = static_cast<int>(std::min<long long>(servable, std::numeric_limits<int>::max()));
+    min_cost_flow->set_node_supply(source, flow);
+    min_cost_flow->set_node_supply(sink, -flow);
+
+    // Source -> item through each rack holding it, the arc cost is the linearized visit
+    std::vector<int> stock_arcs;
+    std::vector<RackIdx> stock_arc_rack;
+    for (ItemIdx item = 0; item < stock_.get_item_ids().size(); item++) {
+        // Faces of one rack share the visit, merge them into one arc
+        std::vector<std::pair<RackIdx, int>> racks;
+        for (const StockLocation& location : stock_.get_item_locations(item)) {
+            racks.push_back({location.rack, location.quantity});
+        }
+        std::sort(racks.begin(), racks.end());
+        for (size_t i = 0; i < racks.size();) {
+            const RackIdx rack = racks[i].first;
+            int quantity = 0;
+            for (; i < racks.size() && racks[i].first == rack; i++) {
+                quantity += racks[i].second;
+            }
+            stock_arcs.push_back(min_cost_flow->add_arc(source, first_item + item, quantity, visit_cost[rack]));
+            stock_arc_rack.push_back(rack);
+        }
+    }
+
+    // Item -> group carries the reward per unit, group -> the tree nodes covering its window
+    std::vector<int> group_arcs;
+    group_arcs.reserve(num_groups);
+    for (size_t g = 0; g < num_groups; g++) {
+        const OrderGroup& group = groups[g];
+        const int node = first_group + static_cast<int>(g);
+        const int units = static_cast<int>(std::min<long long>(
+            static_cast<long long>(group.count) * group.quantity, std::numeric_limits<int>::max()));
+        group_arcs.push_back(min_cost_flow->add_arc(first_item + group.item, node, units, -SERVE_REWARD));
+        for (int left = group.first + tree_size, right = group.last + tree_size + 1; left < right;
+             left /= 2, right /= 2) {
+            if (left & 1) {
+                min_cost_flow->add_arc(node, tree_node(left++), units, 0);
+            }
+            if (right & 1) {
+                min_cost_flow->add_arc(node, tree_node(--right), units, 0);
+            }
+        }
+    }
+    for (int v = 1; v < tree_size; v++) {
+        min_cost_flow->add_arc(tree_node(v), tree_node(2 * v), flow, 0);
+        min_cost_flow->add_arc(tree_node(v), tree_node(2 * v + 1), flow, 0);
+    }
+    std::vector<int> period_arcs;
+    for (int k = 0; k < num_periods; k++) {
+        period_arcs.push_back(min_cost_flow->add_arc(tree_node(tree_size + k), sink, result_.capacity[k], 0));
+    }
+
+    // Unserved units
+    min_cost_flow->add_arc(source, sink, flow, 0);
+
+    result_.num_nodes = first_tree + 2 * tree_size;
+    result_.num_arcs = min_cost_flow->num_arcs();
+    result_.build_ms = elapsed_ms(build_start);
+
+    auto solve_start = std::chrono::steady_clock::now();
+    MCFStatus status = min_cost_flow->solve();
+    result_.solve_ms = elapsed_ms(solve_start);
+    if (status != MCFStatus::OPTIMAL) {
+        throw std::runtime_error("Error: Solving the batch min cost flow problem failed.");
+    }
+
+    for (int k = 0; k < num_periods; k++) {
+        result_.period_flow.push_back(min_cost_flow->flow(period_arcs[k]));
+        result_.served_units += result_.period_flow.back();
+    }
+    result_.min_unserved_units = result_.units - result_.served_units;
+    // Whole orders the unit plan covers in every group
+    for (size_t g = 0; g < num_groups; g++) {
+        result_.served += static_cast<size_t>(std::min(groups[g].count,
+                                                       min_cost_flow->flow(group_arcs[g]) / groups[g].quantity));
+    }
+    result_.min_unserved = result_.orders - result_.served;
+
+    // The objective rounded the visit costs down, so this stays a valid bound
+    long long visit_units = 0;
+    for (size_t i = 0; i < stock_arcs.size(); i++) {
+        visit_units += static_cast<long long>(min_cost_flow->flow(stock_arcs[i])) * visit_cost[stock_arc_rack[i]];
+    }
+    result_.rack_visits_lp = static_cast<double>(visit_units) / VISIT_SCALE;
+    result_.rack_visits_bound = static_cast<long long>(std::ceil(result_.rack_visits_lp - 1e-9));
+    return result_;
+}
+
+void BatchBound::write_outputs(const std::string& output_dir) const {
+    nlohmann::json bound = {
+        {"start_date", format_iso8601(config_.start_date)},
+        {"end_date", format_iso8601(config_.end_date)},
+        {"period_minutes", config_.period.count()},
+        {"seed", config_.seed},
+        {"orders", result_.orders},
+        {"groups", result_.groups},
+        {"periods", result_.periods},
+        {"units", result_.units},
+        {"served", result_.served},
+        {"served_units", result_.served_units},
+        {"min_unserved", result_.min_unserved},
+        {"min_unserved_units", result_.min_unserved_units},
+        {"unstocked", result_.unstocked},
+        {"out_of_window", result_.out_of_window},
+        {"rack_visits_lp", result_.rack_visits_lp},
+        {"rack_visits_bound", result_.rack_visits_bound},
+        {"num_nodes", result_.num_nodes},
+        {"num_arcs", result_.num_arcs}
+    };
+    std::ofstream bound_file(output_dir + "/bound.json");
+    if (!bound_file.is_open()) {
+        throw std::runtime_error("Could not open output file: " + output_dir + "/bound.json");
+    }
+    bound_file << bound.dump(2) << std::endl;
+
+    std::ofstream periods_file(output_dir + "/bound_periods.csv");
+    if (!periods_file.is_open()) {
+        throw std::runtime_error("Could not open output file: " + output_dir + "/bound_periods.csv");
+    }
+    periods_file << "period,date,capacity,served_units\n";
+    for (size_t k = 0; k < result_.periods; k++) {
+        periods_file << k << ','
+                     << format_iso8601(config_.start_date + config_.period * static_cast<int>(k + 1)) << ','
+                     << result_.capacity[k] << ','
+                     << result_.period_flow[k] << '\n';
+    }
+}
+
+}
@@ -0,0 +1,266 @@
+#include "fixed_charge_mcf.h"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <stdexcept>
+
+namespace SS {
+
+namespace {
+
+// Costs are scaled so a fixed charge spread over many units keeps some resolution
+constexpr int SLOPE_SCALE = 256;
+constexpr int UNSERVED_COST = 999999;
+
+double elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Linearized fixed charge of an arc expected to carry units
+int slope(long long charge, int units) {
+    if (charge <= 0) {
+        return 0;
+    }
+    return static_cast<int>(std::min<long long>(charge / std::max(1, units), std::numeric_limits<int>::max()));
+}
+
+}
+
+FixedChargeMCF::FixedChargeMCF(const StockManager& stock, MCFBackend backend)
+    : stock_(stock), solver_(make_mcf_solver(backend)) {
+}
+
+std::vector<Pick> FixedChargeMCF::solve(const std::vector<Order>& orders, const std::vector<int>& rack_costs,
+                                        const std::vector<bool>& hot_racks, int limit, long long& cost) {
+    auto start = std::chrono::steady_clock::now();
+    iterations_ = 0;
+    timed_out_ = false;
+    linear_racks_ = 0;
+    linear_cost_ = 0;
+    const int num_faces = stock_.num_faces();
+
+    // Requested items with stock, in first-seen order
+    std::vector<ItemIdx> items;
+    std::vector<int> item_nodes(stock_.get_item_ids().size(), -1);
+    int node_index = 0;
+    const int source = node_index++;
+    for (const auto& order : orders) {
+        if (order.item_idx != INVALID_IDX && item_nodes[order.item_idx] < 0
+            && !stock_.is_stock_out(order.item_idx)) {
+            item_nodes[order.item_idx] = node_index++;
+            items.push_back(order.item_idx);
+        }
+    }
+
+    // Rack_face nodes for the faces holding a requested item, then their racks
+    std::vector<int> rack_face_nodes(stock_.num_racks() * num_faces, -1);
+    std::vector<int> rack_face_slots;  // node - first_rack_face -> rack * num_faces + face
+    std::vector<int> face_units;       // units of requested items, parallel to rack_face_slots
+    const int first_rack_face = node_index;
+    for (ItemIdx item : items) {
+        for (const auto& location : stock_.get_item_locations(item)) {
+            int slot = location.rack * num_faces + location.face;
+            if (rack_face_nodes[slot] < 0) {
+                rack_face_nodes[slot] = node_index++;
+                rack_face_slots.push_back(slot);
+                face_units.push_back(0);
+            }
+            face_units[rack_face_nodes[slot] - first_rack_face] += location.quantity;
+        }
+    }
+    std::vector<int> rack_nodes(stock_.num_racks(), -1);
+    std::vector<RackIdx> racks;        // node - first_rack -> rack
+    std::vector<int> rack_units;
+    const int first_rack = node_index;
+    for (size_t f = 0; f < rack_face_slots.size(); f++) {
+        RackIdx rack = rack_face_slots[f] / num_faces;
+        if (rack_nodes[rack] < 0) {
+            rack_nodes[rack] = node_index++;
+            racks.push_back(rack);
+            rack_units.push_back(0);
+        }
+        rack_units[rack_nodes[rack] - first_rack] += face_units[f];
+    }
+    const int sink = node_index++;
+
+    // Order nodes, only for orders whose item has stock
+    std::vector<size_t> routed_orders;
+    for (size_t i = 0; i < orders.size(); i++) {
+        ItemIdx item = orders[i].item_idx;
+        if (item != INVALID_IDX && item_nodes[item] >= 0) {
+            routed_orders.push_back(i);
+        }
+    }
+    num_nodes_ = node_index + static_cast<int>(routed_orders.size());
+
+    // Fixed charges, a hot rack is already at a station and costs no trip
+    std::vector<long long> rack_charge(racks.size());
+    for (size_t r = 0; r < racks.size(); r++) {
+        rack_charge[r] = hot_racks[racks[r]] ? 0 : static_cast<long long>(costs_.rack) * SLOPE_SCALE;
+    }
+    const long long face_charge = static_cast<long long>(std::max(0, costs_.face)) * SLOPE_SCALE;
+    const bool has_charges = face_charge > 0
+        || std::any_of(rack_charge.begin(), rack_charge.end(), [](long long c) { return c > 0; });
+
+    // The first solve has no slopes, the second spreads each charge over the arc capacity
+    std::vector<int> face_slope(rack_face_slots.size(), 0);
+    std::vector<int> rack_slope(racks.size(), 0);
+
+    MCFSolver& min_cost_flow = *solver_;
+    std::vector<int> order_arcs;     // order -> item, parallel to routed_orders
+    std::vector<int> location_arcs;
+    std::vector<int> face_arcs;      // parallel to rack_face_slots
+    std::vector<int> rack_arcs;      // parallel to racks
+    auto build = [&]() {
+        min_cost_flow.clear();
+        order_arcs.clear();
+        location_arcs.clear();
+        face_arcs.clear();
+        rack_arcs.clear();
+        min_cost_flow.set_node_supply(source, limit);
+        min_cost_flow.set_node_supply(sink, -limit);
+
+        int order_node = sink + 1;
+        for (size_t i : routed_orders) {
+            min_cost_flow.add_arc(source, order_node, orders[i].quantity, -orders[i].priority * SLOPE_SCALE);
+            order_arcs.push_back(min_cost_flow.add_arc(order_node, item_nodes[orders[i].item_idx],
+                                                       orders[i].quantity, 0));
+            order_node++;
+        }
+        for (ItemIdx item : items) {
+            for (const auto& location : stock_.get_item_locations(item)) {
+                location_arcs.push_back(min_cost_flow.add_arc(
+                    item_nodes[item], rack_face_nodes[location.rack * num_faces + location.face],
+                    location.quantity, rack_costs[location.rack] * SLOPE_SCALE));
+            }
+        }
+        for (size_t f = 0; f < rack_face_slots.size(); f++) {
+            RackIdx rack = rack_face_slots[f] / num_faces;
+            face_arcs.push_back(min_cost_flow.add_arc(first_rack_face + f, rack_nodes[rack], limit, face_slope[f]));
+        }
+        for (size_t r = 0; r < racks.size(); r++) {
+            rack_arcs.push_back(min_cost_flow.add_arc(first_rack + r, sink, limit, rack_slope[r]));
+        }
+        min_cost_flow.add_arc(source, sink, limit, UNSERVED_COST * SLOPE_SCALE);
+    };
+
+    std::vector<int> best_order_flow;
+    std::vector<int> best_location_flow;
+    long long best_cost = std::numeric_limits<long long>::max();
+    std::vector<int> face_flow(rack_face_slots.size());
+    std::vector<int> rack_flow(racks.size());
+    std::vector<int> previous_face_flow;
+    std::vector<int> previous_rack_flow;
+    build_ms_ = 0.0;
+    while (iterations_ < std::max(1, costs_.max_iterations)) {
+        auto build_start = std::chrono::steady_clock::now();
+        build();
+        build_ms_ += elapsed_ms(build_start);
+        if (min_cost_flow.solve() != MCFStatus::OPTIMAL) {
+            throw std::runtime_error("Error: Solving the fixed charge min cost flow problem failed.");
+        }
+        iterations_++;
+
+        // True objective of this flow: linear costs plus the charges of the arcs it opened
+        long long iteration_cost = 0;
+        int served = 0;
+        for (size_t k = 0; k < order_arcs.size(); k++) {
+            int flow = min_cost_flow.flow(order_arcs[k]);
+            served += flow;
+            iteration_cost -= static_cast<long long>(flow) * orders[routed_orders[k]].priority;
+        }
+        size_t arc = 0;
+        for (ItemIdx item : items) {
+            for (const auto& location : stock_.get_item_locations(item)) {
+                iteration_cost += static_cast<long long>(min_cost_flow.flow(location_arcs[arc++])) * rack_costs[location.rack];
+            }
+        }
+        iteration_cost += static_cast<long long>(UNSERVED_COST) * (limit - served);
+        int opened_racks = 0;
+        for (size_t f = 0; f < face_arcs.size(); f++) {
+            face_flow[f] = min_cost_flow.flow(face_arcs[f]);
+            iteration_cost += face_flow[f] > 0 ? face_charge / SLOPE_SCALE : 0;
+        }
+        for (size_t r = 0; r < rack_arcs.size(); r++) {
+            rack_flow[r] = min_cost_flow.flow(rack_arcs[r]);
+            opened_racks += rack_flow[r] > 0;
+            iteration_cost += rack_flow[r] > 0 ? rack_charge[r] / SLOPE_SCALE : 0;
+        }
+        if (iterations_ == 1) {
+            linear_racks_ = opened_racks;
+            linear_cost_ = iteration_cost;
+        }
+        if (iteration_cost < best_cost) {
+            best_cost = iteration_cost;
+            best_order_flow.resize(order_arcs.size());
+            for (size_t k = 0; k < order_arcs.size(); k++) {
+                best_order_flow[k] = min_cost_flow.flow(order_arcs[k]);
+            }
+            best_location_flow.resize(location_arcs.size());
+            for (size_t k = 0; k < location_arcs.size(); k++) {
+                best_location_flow[k] = min_cost_flow.flow(location_arcs[k]);
+            }
+        }
+
+        // Same flows twice in a row give the same slopes again
+        if (!has_charges || (iterations_ > 2 && face_flow == previous_face_flow && rack_flow == previous_rack_flow)) {
+            break;
+        }
+        if (costs_.time_limit_ms > 0 && elapsed_ms(start) > costs_.time_limit_ms) {
+            timed_out_ = iterations_ < costs_.max_iterations;
+            break;
+        }
+        previous_face_flow = face_flow;
+        previous_rack_flow = rack_flow;
+        for (size_t f = 0; f < face_slope.size(); f++) {
+            if (iterations_ == 1) {
+                face_slope[f] = slope(face_charge, std::min(limit, face_units[f]));
+            } else if (face_flow[f] > 0) {
+                face_slope[f] = slope(face_charge, face_flow[f]);
+            }
+        }
+        for (size_t r = 0; r < rack_slope.size(); r++) {
+            if (iterations_ == 1) {
+                rack_slope[r] = slope(rack_charge[r], std::min(limit, rack_units[r]));
+            } else if (rack_flow[r] > 0) {
+                rack_slope[r] = slope(rack_charge[r], rack_flow[r]);
+            }
+        }
+    }
+    num_arcs_ = min_cost_flow.num_arcs();
+    cost = best_cost;
+
+    // Units leaving each item node per rack_face, then matched with the orders entering it
+    std::vector<std::vector<std::pair<int, int>>> item_outflow(first_rack_face); // item node -> (rack_face node, flow)
+    size_t arc = 0;
+    for (ItemIdx item : items) {
+        for (const auto& location : stock_.get_item_locations(item)) {
+            int flow = best_location_flow[arc++];
+            if (flow > 0) {
+                item_outflow[item_nodes[item]].push_back({rack_face_nodes[location.rack * num_faces + location.face], flow});
+            }
+        }
+    }
+    std::vector<Pick> picks;
+    std::vector<size_t> next_outflow(first_rack_face, 0);
+    for (size_t k = 0; k < routed_orders.size(); k++) {
+        const Order& order = orders[routed_orders[k]];
+        int item_node = item_nodes[order.item_idx];
+        auto& outflow = item_outflow[item_node];
+        size_t& next = next_outflow[item_node];
+        for (int units = best_order_flow[k]; units > 0;) {
+            while (outflow[next].second == 0) {
+                next++;
+            }
+            int taken = std::min(units, outflow[next].second);
+            outflow[next].second -= taken;
+            units -= taken;
+            int slot = rack_face_slots[outflow[next].first - first_rack_face];
+            picks.push_back({order.order_idx, order.item_idx,
+                             static_cast<RackIdx>(slot / num_faces), static_cast<FaceIdx>(slot % num_faces), taken});
+        }
+    }
+    return picks;
+}
+
+}
@@ -0,0 +1,97 @@
+#include "flat_stock.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace SS {
+
+void FlatStock::build(const Stock& inventory, size_t num_racks, size_t num_faces) {
+    num_faces_ = num_faces;
+    const size_t num_slots = num_racks * num_faces;
+
+    // Count items per slot, then prefix-sum into offsets
+    offsets_.assign(num_slots + 1, 0);
+    for (const auto& [rack, faces] : inventory) {
+        for (const auto& [face, items] : faces) {
+            offsets_[slot(rack, face) + 1] += items.size();
+        }
+    }
+    for (size_t s = 0; s < num_slots; s++) {
+        offsets_[s + 1] += offsets_[s];
+    }
+
+    // std::map iterates items in order, so each slot range comes out sorted
+    items_.resize(offsets_[num_slots]);
+    quantities_.resize(offsets_[num_slots]);
+    for (const auto& [rack, faces] : inventory) {
+        for (const auto& [face, items] : faces) {
+            uint32_t pos = offsets_[slot(rack, face)];
+            for (const auto& [item, quantity] : items) {
+                items_[pos] = item;
+                quantities_[pos] = quantity;
+                pos++;
+            }
+        }
+    }
+}
+
+void FlatStock::assign(size_t num_faces, std::vector<uint32_t> offsets, std::vector<ItemIdx> items,
+                       std::vector<int32_t> quantities) {
+    if (offsets.empty() || offsets.back() != items.size() || items.size() != quantities.size()) {
+        throw std::invalid_argument("FlatStock arrays do not match");
+    }
+    num_faces_ = num_faces;
+    offsets_ = std::move(offsets);
+    items_ = std::move(items);
+    quantities_ = std::move(quantities);
+}
+
+uint32_t FlatStock::find(size_t slot, ItemIdx item) const {
+    // Faces hold a handful of items, a linear scan beats a binary search here
+    uint32_t pos = offsets_[slot];
+    const uint32_t end = offsets_[slot + 1];
+    while (pos < end && items_[pos] < item) {
+        pos++;
+    }
+    return pos;
+}
+
+int FlatStock::get(RackIdx rack, FaceIdx face, ItemIdx item) const {
+    const size_t s = slot(rack, face);
+    if (s >= num_slots()) {
+        return 0;
+    }
+    uint32_t pos = find(s, item);
+    if (pos < offsets_[s + 1] && items_[pos] == item) {
+        return quantities_[pos];
+    }
+    return 0;
+}
+
+int FlatStock::add(RackIdx rack, FaceIdx face, ItemIdx item, int delta) {
+    const size_t s = slot(rack, face);
+    if (s >= num_slots()) {
+        throw std::out_of_range("Unknown stock slot: " + std::to_string(s));
+    }
+
+    uint32_t pos = find(s, item);
+    if (pos < offsets_[s + 1] && items_[pos] == item) {
+        quantities_[pos] += delta;
+        return quantities_[pos];
+    }
+
+    items_.insert(items_.begin() + pos, item);
+    quantities_.insert(quantities_.begin() + pos, delta);
+    for (size_t next = s + 1; next < offsets_.size(); next++) {
+        offsets_[next]++;
+    }
+    return delta;
+}
+
+size_t FlatStock::memory_bytes() const {
+    return offsets_.capacity() * sizeof(uint32_t)
+         + items_.capacity() * sizeof(ItemIdx)
+         + quantities_.capacity() * sizeof(int32_t);
+}
+
+}
@@ -0,0 +1,180 @@
+#include "greedy_selection.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <queue>
+
+namespace SS {
+
+GreedySelection::GreedySelection(const StockManager& stock)
+    : stock_(stock) {
+}
+
+std::vector<Pick> GreedySelection::solve(const std::vector<Order>& orders, const std::vector<int>& rack_costs,
+                                         int limit, double budget_ms, long long& cost) {
+    auto start = std::chrono::steady_clock::now();
+    for (ItemIdx item : active_) {
+        Component& component = components_[item];
+        component.orders.clear();
+        component.taken = 0;
+    }
+    active_.clear();
+    exchanges_ = 0;
+    timed_out_ = false;
+    cost = 0;
+    if (limit <= 0) {
+        return {};
+    }
+    if (components_.size() < stock_.get_item_ids().size()) {
+        components_.resize(stock_.get_item_ids().size());
+    }
+
+    // Orders with stock, by priority desc, grouped into their items in that order
+    by_priority_.clear();
+    for (size_t i = 0; i < orders.size(); i++) {
+        ItemIdx item = orders[i].item_idx;
+        if (item != INVALID_IDX && !stock_.is_stock_out(item)) {
+            by_priority_.push_back(i);
+        }
+    }
+    std::stable_sort(by_priority_.begin(), by_priority_.end(), [&](size_t a, size_t b) {
+        return orders[a].priority > orders[b].priority;
+    });
+    for (size_t i : by_priority_) {
+        Component& component = components_[orders[i].item_idx];
+        if (component.orders.empty()) {
+            active_.push_back(orders[i].item_idx);
+        }
+        component.orders.push_back(i);
+    }
+    for (ItemIdx item : active_) {
+        build_units(item, components_[item], orders, rack_costs);
+    }
+
+    // Greedy pass: every order gets the hottest free units of its item
+    int picked = 0;
+    for (size_t i : by_priority_) {
+        if (picked == limit) {
+            break;
+        }
+        Component& component = components_[orders[i].item_idx];
+        int take = std::min({orders[i].quantity, static_cast<int>(component.unit_locations.size()) - component.taken,
+                             limit - picked});
+        if (take > 0) {
+            component.taken += take;
+            picked += take;
+        }
+    }
+
+    // Improvement pass: swap the worst unit taken for the best unit left
+    // Heap entries go stale when their item moves, they are checked against the current value
+    using Entry = std::pair<int, ItemIdx>; // (value, item)
+    std::priority_queue<Entry> best;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> worst;
+    auto push_item = [&](ItemIdx item) {
+        const Component& component = components_[item];
+        if (component.taken < static_cast<int>(component.unit_locations.size())) {
+            best.push({value(orders, component, component.taken), item});
+        }
+        if (component.taken > 0) {
+            worst.push({value(orders, component, component.taken - 1), item});
+        }
+    };
+    for (ItemIdx item : active_) {
+        push_item(item);
+    }
+    while (true) {
+        while (!best.empty()) {
+            const Component& component = components_[best.top().second];
+            if (component.taken < static_cast<int>(component.unit_locations.size())
+                && value(orders, component, component.taken) == best.top().first) {
+                break;
+            }
+            best.pop();
+        }
+        while (!worst.empty()) {
+            const Component& component = components_[worst.top().second];
+            if (component.taken > 0 && value(orders, component, component.taken - 1) == worst.top().first) {
+                break;
+            }
+            worst.pop();
+        }
+        if (best.empty() || worst.empty() || best.top().first <= worst.top().first) {
+            break;
+        }
+        if (budget_ms > 0 && (exchanges_ & 63) == 63
+            && std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() > budget_ms) {
+            timed_out_ = true;
+            break;
+        }
+
+        ItemIdx gain = best.top().second;
+        ItemIdx loss = worst.top().second;
+        best.pop();
+        worst.pop();
+        components_[gain].taken++;
+        components_[loss].taken--;
+        exchanges_++;
+        push_item(gain);
+        push_item(loss);
+    }
+
+    // Extract the picks with the same objective as the MCF
+    std::vector<Pick> picks;
+    picks.reserve(picked);
+    long long total_value = 0;
+    long long units = 0;
+    for (ItemIdx item : active_) {
+        const Component& component = components_[item];
+        for (int k = 0; k < component.taken; k++) {
+            const Order& order = orders[component.orders[component.unit_lines[k]]];
+            const StockLocation& location = component.locations[component.unit_locations[k]];
+            if (k > 0 && component.unit_lines[k] == component.unit_lines[k - 1]
+                && component.unit_locations[k] == component.unit_locations[k - 1]) {
+                picks.back().quantity++;
+            } else {
+                picks.push_back({order.order_idx, item, location.rack, location.face});
+            }
+            total_value += value(orders, component, k);
+            units++;
+        }
+    }
+    cost = -total_value + 999999LL * (limit - units);
+    return picks;
+}
+
+void GreedySelection::build_units(ItemIdx item, Component& component, const std::vector<Order>& orders,
+                                  const std::vector<int>& rack_costs) {
+    // Hottest (cheapest) units first, same tie-break as IncrementalMCF
+    component.locations = stock_.get_item_locations(item);
+    std::sort(component.locations.begin(), component.locations.end(),
+              [&](const StockLocation& a, const StockLocation& b) {
+                  if (rack_costs[a.rack] != rack_costs[b.rack]) {
+                      return rack_costs[a.rack] < rack_costs[b.rack];
+                  }
+                  return a.rack != b.rack ? a.rack < b.rack : a.face < b.face;
+              });
+
+    size_t ordered = 0;
+    for (size_t i : component.orders) {
+        ordered += orders[i].quantity;
+    }
+    component.unit_costs.clear();
+    component.unit_locations.clear();
+    for (size_t l = 0; l < component.locations.size(); l++) {
+        component.unit_costs.push_back(rack_costs[component.locations[l].rack]);
+        for (int unit = 0; unit < component.locations[l].quantity
+                           && component.unit_locations.size() < ordered; unit++) {
+            component.unit_locations.push_back(static_cast<int>(l));
+        }
+    }
+    component.unit_lines.clear();
+    for (size_t line = 0; line < component.orders.size(); line++) {
+        for (int unit = 0; unit < orders[component.orders[line]].quantity
+                           && component.unit_lines.size() < component.unit_locations.size(); unit++) {
+            component.unit_lines.push_back(static_cast<int>(line));
+        }
+    }
+}
+
+}
@@ -0,0 +1,209 @@
+#include "incremental_mcf.h"
+#include <algorithm>
+#include <numeric>
+#include <queue>
+
+namespace SS {
+
+IncrementalMCF::IncrementalMCF(const StockManager& stock)
+    : stock_(stock) {
+}
+
+void IncrementalMCF::clear() {
+    components_.clear();
+    known_orders_.clear();
+    rack_costs_.clear();
+    active_.clear();
+    last_rebuilt_ = 0;
+}
+
+void IncrementalMCF::update(const std::vector<Order>& orders, const std::vector<int>& rack_costs) {
+    if (components_.size() < stock_.get_item_ids().size()) {
+        components_.resize(stock_.get_item_ids().size());
+    }
+
+    // Backlog delta: new orders, closed orders and changed ones. OrderManager reuses the
+    // index of a closed order, so a known index may now name another item or quantity
+    for (auto& [order, known] : known_orders_) {
+        known.seen = false;
+    }
+    for (const auto& order : orders) {
+        if (order.item_idx == INVALID_IDX) {
+            continue;
+        }
+        auto it = known_orders_.find(order.order_idx);
+        if (it == known_orders_.end()) {
+            add_order(order.order_idx, order.item_idx, order.priority, order.quantity);
+            known_orders_.emplace(order.order_idx, KnownOrder{order.item_idx, order.priority, order.quantity, true});
+            continue;
+        }
+        KnownOrder& known = it->second;
+        if (known.item != order.item_idx || known.priority != order.priority || known.quantity != order.quantity) {
+            remove_order(order.order_idx, known.item);
+            add_order(order.order_idx, order.item_idx, order.priority, order.quantity);
+            known = KnownOrder{order.item_idx, order.priority, order.quantity, false};
+        }
+        known.seen = true;
+    }
+    for (auto it = known_orders_.begin(); it != known_orders_.end();) {
+        if (!it->second.seen) {
+            remove_order(it->first, it->second.item);
+            it = known_orders_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // Hot/warm delta: items stocked on racks whose cost changed
+    if (rack_costs_.size() != rack_costs.size()) {
+        rack_costs_ = rack_costs;
+        for (auto& component : components_) {
+            component.dirty = true;
+        }
+    } else {
+        for (RackIdx rack = 0; rack < rack_costs.size(); rack++) {
+            if (rack_costs_[rack] == rack_costs[rack]) {
+                continue;
+            }
+            rack_costs_[rack] = rack_costs[rack];
+            rack_items_.clear();
+            stock_.get_rack_items(rack, rack_items_);
+            for (ItemIdx item : rack_items_) {
+                components_[item].dirty = true;
+            }
+        }
+    }
+
+    // Stock delta, then rebuild what changed
+    active_.clear();
+    last_rebuilt_ = 0;
+    for (ItemIdx item = 0; item < components_.size(); item++) {
+        Component& component = components_[item];
+        if (component.orders.empty()) {
+            continue;
+        }
+        if (component.dirty || component.stock_version != stock_.get_item_version(item)) {
+            rebuild(item, component);
+        }
+        if (component.capacity > 0) {
+            active_.push_back(item);
+        }
+    }
+}
+
+std::vector<Pick> IncrementalMCF::solve(int limit, long long& cost) {
+    // Merge the components' non-increasing marginal curves, keeping the top values
+    struct Cursor {
+        ItemIdx item;
+        int k;          // next unit of the component
+        size_t line;    // order line of that unit
+        int line_used;  // units already given to that line
+        size_t loc;     // location of that unit
+        int used;       // units already taken from that location
+    };
+    std::vector<Cursor> cursors;
+    cursors.reserve(active_.size());
+    std::priority_queue<std::pair<int, size_t>> heap;
+    for (ItemIdx item : active_) {
+        cursors.push_back({item, 0, 0, 0, 0, 0});
+        const Component& component = components_[item];
+        heap.push({component.orders[0].priority - component.unit_costs[0], cursors.size() - 1});
+    }
+
+    std::vector<Pick> picks;
+    picks.reserve(std::max(limit, 0));
+    long long value = 0;
+    int units = 0;
+    while (units < limit && !heap.empty()) {
+        auto [unit_value, index] = heap.top();
+        heap.pop();
+
+        Cursor& cursor = cursors[index];
+        const Component& component = components_[cursor.item];
+        const StockLocation& location = component.locations[cursor.loc];
+        const OrderIdx order = component.orders[cursor.line].order;
+        if (!picks.empty() && picks.back().order == order && picks.back().rack == location.rack
+            && picks.back().face == location.face) {
+            picks.back().quantity++;
+        } else {
+            picks.push_back({order, cursor.item, location.rack, location.face});
+        }
+        value += unit_value;
+        units++;
+
+        cursor.k++;
+        if (++cursor.line_used == component.orders[cursor.line].quantity) {
+            cursor.line++;
+            cursor.line_used = 0;
+        }
+        if (++cursor.used == location.quantity) {
+            cursor.loc++;
+            cursor.used = 0;
+        }
+        if (cursor.k < component.capacity) {
+            heap.push({component.orders[cursor.line].priority - component.unit_costs[cursor.loc], index});
+        }
+    }
+
+    // Same objective as the MCF: unit costs plus the source->sink penalty for unused supply
+    cost = -value + 999999LL * (limit - static_cast<long long>(units));
+    return picks;
+}
+
+void IncrementalMCF::rebuild(ItemIdx item, Component& component) {
+    std::sort(component.orders.begin(), component.orders.end(),
+              [](const Line& a, const Line& b) {
+                  return a.priority != b.priority ? a.priority > b.priority : a.order < b.order;
+              });
+
+    // Hottest (cheapest) units first
+    const auto& locations = stock_.get_item_locations(item);
+    std::vector<size_t> by_cost(locations.size());
+    std::iota(by_cost.begin(), by_cost.end(), 0);
+    std::sort(by_cost.begin(), by_cost.end(), [&](size_t a, size_t b) {
+        int cost_a = rack_costs_[locations[a].rack];
+        int cost_b = rack_costs_[locations[b].rack];
+        if (cost_a != cost_b) {
+            return cost_a < cost_b;
+        }
+        return locations[a].rack != locations[b].rack ? locations[a].rack < locations[b].rack
+                                                      : locations[a].face < locations[b].face;
+    });
+
+    component.locations.clear();
+    component.unit_costs.clear();
+    long long units = 0;
+    for (size_t i : by_cost) {
+        component.locations.push_back(locations[i]);
+        component.unit_costs.push_back(rack_costs_[locations[i].rack]);
+        units += locations[i].quantity;
+    }
+
+    long long ordered = 0;
+    for (const Line& line : component.orders) {
+        ordered += line.quantity;
+    }
+    component.capacity = static_cast<int>(std::min(ordered, units));
+    component.stock_version = stock_.get_item_version(item);
+    component.dirty = false;
+    last_rebuilt_++;
+}
+
+void IncrementalMCF::add_order(OrderIdx order, ItemIdx item, int priority, int quantity) {
+    Component& component = components_[item];
+    component.orders.push_back({priority, order, quantity});
+    component.dirty = true;
+}
+
+void IncrementalMCF::remove_order(OrderIdx order, ItemIdx item) {
+    Component& component = components_[item];
+    auto it = std::find_if(component.orders.begin(), component.orders.end(),
+                           [&](const Line& line) { return line.order == order; });
+    if (it != component.orders.end()) {
+        *it = component.orders.back();
+        component.orders.pop_back();
+    }
+    component.dirty = true;
+}
+
+}
@@ -0,0 +1,43 @@
+#include "mcf_solver.h"
+#include <stdexcept>
+#include <string>
+#include "native_mcf.h"
+#ifdef WES_WITH_ORTOOLS
+#include "ortools_mcf.h"
+#endif
+
+namespace SS {
+
+std::unique_ptr<MCFSolver> make_mcf_solver(MCFBackend backend) {
+    switch (backend) {
+        case MCFBackend::NATIVE:
+            return std::make_unique<NativeMCF>();
+#ifdef WES_WITH_ORTOOLS
+        case MCFBackend::ORTOOLS:
+            return std::make_unique<OrToolsMCF>();
+#endif
+        default:
+            throw std::runtime_error(std::string("Error: MCF backend ") + to_string(backend)
+                                     + " is not available in this build.");
+    }
+}
+
+bool has_mcf_backend(MCFBackend backend) {
+#ifdef WES_WITH_ORTOOLS
+    return backend == MCFBackend::NATIVE || backend == MCFBackend::ORTOOLS;
+#else
+    return backend == MCFBackend::NATIVE;
+#endif
+}
+
+const char* to_string(MCFBackend backend) {
+    switch (backend) {
+        case MCFBackend::NATIVE:
+            return "native";
+        case MCFBackend::ORTOOLS:
+            return "ortools";
+    }
+    return "unknown";
+}
+
+}
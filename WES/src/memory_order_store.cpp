@@ -0,0 +1,109 @@
+#include "memory_order_store.h"
+#include "metrics.h"
+#include <algorithm>
+#include <unordered_set>
+
+namespace SS {
+
+MemoryOrderStore::MemoryOrderStore(std::vector<Order> orders, const StockManager& stock)
+    : stock_(stock), orders_(std::move(orders)) {
+    arrivals_.reserve(orders_.size());
+    for (size_t i = 0; i < orders_.size(); i++) {
+        orders_[i].order_idx = static_cast<OrderIdx>(i);
+        orders_[i].item_idx = stock_.get_item_ids().find(orders_[i].item_id);
+        if (orders_[i].status == OrderStatus::PENDING) {
+            arrivals_.push_back(static_cast<OrderIdx>(i));
+        }
+    }
+    std::stable_sort(arrivals_.begin(), arrivals_.end(), [this](OrderIdx a, OrderIdx b) {
+        return orders_[a].creation_date < orders_[b].creation_date;
+    });
+}
+
+std::vector<Order> MemoryOrderStore::get_backlog(const TimePoint& simulation_date) {
+    publish(simulation_date);
+    std::vector<Order> backlog;
+    backlog.reserve(pending_.size());
+    for (OrderIdx order_idx : pending_) {
+        const Order& order = orders_[order_idx];
+        if (order.due_date < simulation_date) {
+            continue;
+        }
+        backlog.push_back(order);
+        backlog.back().priority = order_priority(simulation_date, order.due_date, bands_);
+    }
+    return backlog;
+}
+
+void MemoryOrderStore::expire_orders(const TimePoint& simulation_date) {
+    publish(simulation_date);
+    for (auto it = pending_.begin(); it != pending_.end();) {
+        if (orders_[*it].due_date < simulation_date) {
+            close(it++, OrderStatus::EXPIRED, simulation_date);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void MemoryOrderStore::complete_orders(const Taskpool& taskpool, const TimePoint& simulation_date) {
+    ScopedTimer timer(Stage::COMPLETE_ORDERS);
+    for (const auto& [rack, faces] : taskpool) {
+        for (const auto& [face, orders] : faces) {
+            for (OrderIdx order : orders) {
+                auto it = pending_.find(order);
+                if (it != pending_.end()) {
+                    close(it, OrderStatus::COMPLETED, simulation_date);
+                }
+            }
+        }
+    }
+}
+
+void MemoryOrderStore::stock_out_orders(const TimePoint& simulation_date) {
+    // Items gone out since the last call, their pending orders are scanned once
+    const std::vector<ItemIdx>& items = stock_.stock_out_items_;
+    std::unordered_set<ItemIdx> fresh(items.begin() + std::min(stock_out_seen_, items.size()), items.end());
+    stock_out_seen_ = items.size();
+    if (!fresh.empty()) {
+        for (auto it = pending_.begin(); it != pending_.end();) {
+            if (fresh.count(orders_[*it].item_idx)) {
+                close(it++, OrderStatus::STOCK_OUT, simulation_date);
+            } else {
+                ++it;
+            }
+        }
+        stock_out_items_.insert(fresh.begin(), fresh.end());
+    }
+
+    // Orders published since the last call for items already out
+    for (; stock_out_checked_ < next_arrival_; stock_out_checked_++) {
+        auto it = pending_.find(arrivals_[stock_out_checked_]);
+        if (it != pending_.end() && stock_out_items_.count(orders_[*it].item_idx)) {
+            close(it, OrderStatus::STOCK_OUT, simulation_date);
+        }
+    }
+}
+
+TimePoint MemoryOrderStore::next_arrival(size_t k) const {
+    if (next_arrival_ + k >= arrivals_.size()) {
+        return TimePoint::max();
+    }
+    return orders_[arrivals_[next_arrival_ + k]].creation_date;
+}
+
+void MemoryOrderStore::publish(const TimePoint& simulation_date) {
+    while (next_arrival_ < arrivals_.size() && orders_[arrivals_[next_arrival_]].creation_date <= simulation_date) {
+        pending_.insert(arrivals_[next_arrival_]);
+        next_arrival_++;
+    }
+}
+
+void MemoryOrderStore::close(std::set<OrderIdx>::iterator it, OrderStatus status, const TimePoint& simulation_date) {
+    Order& order = orders_[*it];
+    order.status = status;
+    order.closure_date = simulation_date;
+    pending_.erase(it);
+}
+
+}
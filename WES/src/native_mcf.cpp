@@ -0,0 +1,215 @@
+#include "native_mcf.h"
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+
+namespace SS {
+
+void NativeMCF::grow(int node) {
+    if (node >= num_nodes_) {
+        num_nodes_ = node + 1;
+        supply_.resize(num_nodes_, 0);
+    }
+}
+
+void NativeMCF::set_node_supply(int node, int supply) {
+    grow(node);
+    supply_[node] = supply;
+}
+
+int NativeMCF::add_arc(int tail, int head, int capacity, int cost) {
+    grow(std::max(tail, head));
+    arc_tail_.push_back(tail);
+    arc_head_.push_back(head);
+    arc_capacity_.push_back(capacity);
+    arc_cost_.push_back(cost);
+    return static_cast<int>(arc_tail_.size()) - 1;
+}
+
+void NativeMCF::clear() {
+    num_nodes_ = 0;
+    optimal_cost_ = 0;
+    supply_.clear();
+    arc_tail_.clear();
+    arc_head_.clear();
+    arc_capacity_.clear();
+    arc_cost_.clear();
+}
+
+MCFStatus NativeMCF::solve() {
+    optimal_cost_ = 0;
+    long long total_supply = 0;
+    for (int supply : supply_) {
+        total_supply += supply;
+    }
+    if (total_supply != 0) {
+        return MCFStatus::UNBALANCED;
+    }
+
+    const int n = num_nodes_;
+    const int m = num_arcs();
+    int64_t max_cost = 0;
+    for (int cost : arc_cost_) {
+        max_cost = std::max<int64_t>(max_cost, std::llabs(cost));
+    }
+    // A pass lowers a price by at most n * (epsilon + start epsilon), below 3 * n * (n + 1) * max_cost over all passes
+    if (static_cast<long double>(max_cost) * (n + 1) * n * 3 > std::numeric_limits<int64_t>::max()) {
+        throw std::runtime_error("Error: Min cost flow costs are too large for the native solver.");
+    }
+
+    build_residual_graph();
+    excess_.assign(supply_.begin(), supply_.end());
+    price_.assign(n, 0);
+    price_floor_.resize(n);
+    current_.resize(n);
+    queue_.resize(n);
+    queued_.assign(n, 0);
+
+    // With zero prices any feasible flow is max_cost * (n + 1) optimal
+    int64_t epsilon = max_cost * (n + 1);
+    do {
+        const int64_t start_epsilon = epsilon;
+        epsilon = std::max<int64_t>(1, epsilon / ALPHA);
+        if (!refine(epsilon, start_epsilon)) {
+            return MCFStatus::INFEASIBLE;
+        }
+    } while (epsilon > 1);
+
+    for (int arc = 0; arc < m; arc++) {
+        optimal_cost_ += static_cast<long long>(flow(arc)) * arc_cost_[arc];
+    }
+    return MCFStatus::OPTIMAL;
+}
+
+void NativeMCF::build_residual_graph() {
+    const int n = num_nodes_;
+    const int m = num_arcs();
+    const int64_t scale = n + 1;
+
+    residual_.resize(2 * m);
+    residual_head_.resize(2 * m);
+    scaled_cost_.resize(2 * m);
+    for (int arc = 0; arc < m; arc++) {
+        residual_[2 * arc] = arc_capacity_[arc];
+        residual_[2 * arc + 1] = 0;
+        residual_head_[2 * arc] = arc_head_[arc];
+        residual_head_[2 * arc + 1] = arc_tail_[arc];
+        scaled_cost_[2 * arc] = arc_cost_[arc] * scale;
+        scaled_cost_[2 * arc + 1] = -arc_cost_[arc] * scale;
+    }
+
+    // Counting sort of the residual arcs by tail
+    first_out_.assign(n + 1, 0);
+    for (int arc = 0; arc < m; arc++) {
+        first_out_[arc_tail_[arc] + 1]++;
+        first_out_[arc_head_[arc] + 1]++;
+    }
+    for (int node = 0; node < n; node++) {
+        first_out_[node + 1] += first_out_[node];
+    }
+    current_.assign(first_out_.begin(), first_out_.end() - 1);
+    out_.resize(2 * m);
+    for (int arc = 0; arc < m; arc++) {
+        out_[current_[arc_tail_[arc]]++] = 2 * arc;
+        out_[current_[arc_head_[arc]]++] = 2 * arc + 1;
+    }
+}
+
+bool NativeMCF::refine(int64_t epsilon, int64_t start_epsilon) {
+    // A node with excess has a residual path to a deficit, whose price does not move,
+    // and a feasible flow that is start_epsilon optimal runs back along it, so its
+    // price stays within n * (epsilon + start_epsilon) of where the pass began
+    const int n = num_nodes_;
+    const int64_t max_drop = n * (epsilon + start_epsilon);
+    for (int node = 0; node < n; node++) {
+        price_floor_[node] = price_[node] - max_drop;
+        current_[node] = first_out_[node];
+    }
+
+    // Saturate every arc with negative reduced cost, the flow becomes 0-optimal but not feasible
+    for (int node = 0; node < n; node++) {
+        for (int i = first_out_[node]; i < first_out_[node + 1]; i++) {
+            int arc = out_[i];
+            if (residual_[arc] > 0 && reduced_cost(node, arc) < 0) {
+                push(node, arc, residual_[arc]);
+            }
+        }
+    }
+
+    queue_head_ = 0;
+    queue_size_ = 0;
+    for (int node = 0; node < n; node++) {
+        if (excess_[node] > 0) {
+            activate(node);
+        }
+    }
+    while (queue_size_ > 0) {
+        int node = queue_[queue_head_];
+        queue_head_ = (queue_head_ + 1) % queue_.size();
+        queue_size_--;
+        queued_[node] = 0;
+        if (!discharge(node, epsilon)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool NativeMCF::discharge(int node, int64_t epsilon) {
+    while (excess_[node] > 0) {
+        int& i = current_[node];
+        const int end = first_out_[node + 1];
+        for (; i < end; i++) {
+            int arc = out_[i];
+            if (residual_[arc] > 0 && reduced_cost(node, arc) < 0) {
+                int head = residual_head_[arc];
+                push(node, arc, std::min(excess_[node], residual_[arc]));
+                if (excess_[head] > 0) {
+                    activate(head);
+                }
+                if (excess_[node] == 0) {
+                    break;
+                }
+            }
+        }
+        if (excess_[node] > 0 && !relabel(node, epsilon)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool NativeMCF::relabel(int node, int64_t epsilon) {
+    // Highest price that makes one residual arc admissible
+    int64_t best = std::numeric_limits<int64_t>::min();
+    for (int i = first_out_[node]; i < first_out_[node + 1]; i++) {
+        int arc = out_[i];
+        if (residual_[arc] > 0) {
+            best = std::max(best, price_[residual_head_[arc]] - scaled_cost_[arc]);
+        }
+    }
+    if (best == std::numeric_limits<int64_t>::min()) {
+        return false; // excess with no way out
+    }
+    price_[node] = best - epsilon;
+    current_[node] = first_out_[node];
+    return price_[node] >= price_floor_[node]; // below the floor the excess has nowhere to go
+}
+
+void NativeMCF::push(int node, int residual_arc, int amount) {
+    residual_[residual_arc] -= amount;
+    residual_[residual_arc ^ 1] += amount;
+    excess_[node] -= amount;
+    excess_[residual_head_[residual_arc]] += amount;
+}
+
+void NativeMCF::activate(int node) {
+    if (!queued_[node]) {
+        queue_[(queue_head_ + queue_size_) % queue_.size()] = node;
+        queue_size_++;
+        queued_[node] = 1;
+    }
+}
+
+}
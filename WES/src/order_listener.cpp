@@ -0,0 +1,53 @@
+#include "order_listener.h"
+#include <algorithm>
+
+namespace SS {
+
+OrderListener::OrderListener(pqxx::connection& conn, const std::string& channel)
+    : pqxx::notification_receiver(conn, channel),
+      last_trigger_(std::chrono::steady_clock::now()) {
+}
+
+void OrderListener::operator()(const std::string& payload, int /*backend_pid*/) {
+    if (new_orders_ == 0) {
+        first_arrival_ = std::chrono::steady_clock::now();
+    }
+    int count = 1;
+    try {
+        count = std::max(1, std::stoi(payload));
+    } catch (const std::exception&) {
+        // Unknown payload, count the notification as one order
+    }
+    new_orders_ += count;
+}
+
+Trigger OrderListener::wait(const TriggerPolicy& policy) {
+    while (true) {
+        auto now = std::chrono::steady_clock::now();
+        Trigger trigger;
+        if (new_orders_ >= policy.min_orders) {
+            trigger = Trigger::COUNT;
+        } else if (new_orders_ > 0 && now - first_arrival_ >= policy.max_delay) {
+            trigger = Trigger::DELAY;
+        } else if (now - last_trigger_ >= policy.fallback) {
+            trigger = Trigger::TIMER;
+        } else {
+            // Sleep on the socket until a notification or the nearest deadline
+            auto until = last_trigger_ + policy.fallback;
+            if (new_orders_ > 0) {
+                until = std::min(until, first_arrival_ + policy.max_delay);
+            }
+            auto timeout = std::chrono::duration_cast<std::chrono::microseconds>(until - now);
+            conn().await_notification(static_cast<std::time_t>(timeout.count() / 1000000),
+                                      static_cast<long>(timeout.count() % 1000000));
+            continue;
+        }
+
+        last_new_orders_ = new_orders_;
+        new_orders_ = 0;
+        last_trigger_ = now;
+        return trigger;
+    }
+}
+
+}
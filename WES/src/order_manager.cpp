@@ -1,6 +1,10 @@
 #include "order_manager.h"
 #include "utils.h"
+#include "metrics.h"
 #include "stock.h"
+#include <algorithm>
+#include <chrono>
+#include <unordered_set>
 
 namespace SS {
 
@@ -8,85 +12,234 @@ OrderManager::OrderManager(DBConnector& db_connector, StockManager& stock)
     : db_connector_(db_connector), stock_(stock) {
 }
 
+void OrderManager::set_zone(int zone) {
+    zone_ = zone;
+    if (zone_ >= 0) {
+        db_connector_.enable_zone_statements();
+    }
+}
+
 std::vector<Order> OrderManager::get_backlog_from_db(pqxx::connection& conn, const TimePoint& simulation_date) {
+    ScopedTimer timer(Stage::FETCH_BACKLOG);
+    // Delta since the watermark. WMS commits its inserts in seq order from one connection,
+    // so no row can show up later with a seq below last_seq_
+    // The coordinator routes rows in zone_seq order in one transaction, the same holds for a shard
     pqxx::work txn(conn);
-    std::string sim_date_str = format_iso8601(simulation_date);
-    pqxx::result result = txn.exec_params(
-        "SELECT order_id, item_id, quantity, creation_date, due_date, "
-        "CASE "
-            "WHEN EXTRACT(EPOCH FROM ($1::timestamp - due_date))/60 <= 35 THEN 100 "
-            "WHEN EXTRACT(EPOCH FROM ($1::timestamp - due_date))/60 <= 120 THEN 50 "
-            "WHEN EXTRACT(EPOCH FROM ($1::timestamp - due_date))/60 <= 360 THEN 10 "
-            "ELSE 1 "
-        "END AS priority "
-        "FROM backlog WHERE status = 'PENDING'",
-        sim_date_str
-    );
-    
-    std::vector<Order> backlog;
-    backlog.reserve(result.size());
+    pqxx::result result = zone_ < 0 ? txn.exec_prepared(FETCH_BACKLOG_STMT, last_seq_)
+                                    : txn.exec_prepared(FETCH_ZONE_BACKLOG_STMT, last_seq_, zone_);
+    txn.commit();
     
     for (const auto& row : result) {
         Order order{
             row["order_id"].as<std::string>(),
             row["item_id"].as<std::string>(),
             row["quantity"].as<int>(),
-            parse_iso8601(row["creation_date"].as<std::string>()),
-            parse_iso8601(row["due_date"].as<std::string>()),
-            row["priority"].as<int>()
+            parse_iso8601(row["creation_date"].view()),
+            parse_iso8601(row["due_date"].view())
         };
-        backlog.push_back(order);
+        // Intern IDs once here, the rest of WES works on indices
+        order.order_idx = order_ids_.intern(order.order_id);
+        order.item_idx = stock_.get_item_ids().find(order.item_id);
+        last_seq_ = std::max(last_seq_, row["seq"].as<long long>());
+        // Routed on a stale zone_stock row, another zone has to serve it
+        if (zone_ >= 0 && (order.item_idx == INVALID_IDX || stock_.is_stock_out(order.item_idx))) {
+            unrouted_.push_back(order.order_id);
+            released_.push_back(order.order_idx);
+            continue;
+        }
+        // Inserted after its item went out, the item UPDATE did not see it
+        if (zone_ < 0 && stock_out_items_.count(order.item_idx)) {
+            stock_out_orders_.push_back(order.order_id);
+            released_.push_back(order.order_idx);
+            continue;
+        }
+        backlog_cache_.emplace(order.order_idx, order);
     }
     
-    txn.commit();
+    // Rows the write-back stage has not expired in the database yet are still PENDING there
+    drop_expired(simulation_date);
+    
+    std::vector<Order> backlog;
+    backlog.reserve(backlog_cache_.size());
+    for (const auto& [order_idx, order] : backlog_cache_) {
+        backlog.push_back(order);
+        backlog.back().priority = order_priority(simulation_date, order.due_date);
+    }
+
+    // The solve of this backlog no longer sees the orders dropped so far, their indices
+    // can go to the orders of the next fetch
+    for (OrderIdx order_idx : released_) {
+        order_ids_.release(order_idx);
+    }
+    released_.clear();
+    Metrics::global().set(Gauge::BACKLOG, static_cast<long long>(backlog.size()));
     return backlog;
 }
 
 void OrderManager::update_expired_orders(pqxx::connection& conn, const TimePoint& simulation_date) {
     pqxx::work txn(conn);
-    std::string sim_date_str = format_iso8601(simulation_date);
-    
-    txn.exec_params(
-        "UPDATE backlog SET status = 'EXPIRED', closure_date = $1 "
-        "WHERE status = 'PENDING' AND due_date < $1",
-        sim_date_str
-    );
-    
+    write_expired_orders(txn, simulation_date);
     txn.commit();
+
+    drop_expired(simulation_date);
 }
 
 void OrderManager::update_stock_out_orders(pqxx::connection& conn) {
-    // Implementation to update stock out orders in the database can be added here
-    /*
-    UPDATE backlog SET status = 'STOCK_OUT', closure_date = NOW()
-    WHERE STATUS = 'PENDING' AND item_id IN (list_of_stock_out_item_ids);
-    */
+    std::vector<std::string> item_ids = take_stock_out_items();
+    std::vector<std::string> order_ids = take_stock_out_orders();
+    std::vector<std::string> unrouted = take_unrouted_orders();
+    if (item_ids.empty() && order_ids.empty() && unrouted.empty()) {
+        return;
+    }
+    pqxx::work txn(conn);
+    write_stock_out_orders(txn, item_ids, zone_);
+    write_stock_out_order_ids(txn, order_ids);
+    write_unrouted_orders(txn, unrouted);
+    txn.commit();
 }
 
 void OrderManager::update_completed_orders(pqxx::connection& conn, const Taskpool& taskpool) {
+    std::vector<std::string> order_ids = take_completed_orders(taskpool);
+    if (order_ids.empty()) {
+        return;
+    }
     pqxx::work txn(conn);
-    TimePoint closure_time = std::chrono::system_clock::now();
-    std::string closure_str = format_iso8601(closure_time);
-    
+    write_completed_orders(txn, order_ids);
+    txn.commit();
+}
+
+std::vector<Order> OrderManager::get_backlog(const TimePoint& simulation_date) {
+    DBConnector::Lease conn = db_connector_.acquire();
+    return get_backlog_from_db(*conn, simulation_date);
+}
+
+void OrderManager::expire_orders(const TimePoint& simulation_date) {
+    DBConnector::Lease conn = db_connector_.acquire();
+    update_expired_orders(*conn, simulation_date);
+}
+
+void OrderManager::complete_orders(const Taskpool& taskpool, const TimePoint& /*simulation_date*/) {
+    DBConnector::Lease conn = db_connector_.acquire();
+    update_completed_orders(*conn, taskpool);
+}
+
+void OrderManager::stock_out_orders(const TimePoint& /*simulation_date*/) {
+    DBConnector::Lease conn = db_connector_.acquire();
+    update_stock_out_orders(*conn);
+}
+
+std::vector<std::string> OrderManager::take_completed_orders(const Taskpool& taskpool) {
     // Collect all order IDs from taskpool
     std::vector<std::string> order_ids;
-    for (const auto& [rack_id, faces] : taskpool) {
-        for (const auto& [face_id, orders] : faces) {
-            order_ids.insert(order_ids.end(), orders.begin(), orders.end());
+    for (const auto& [rack, faces] : taskpool) {
+        for (const auto& [face, orders] : faces) {
+            for (OrderIdx order : orders) {
+                order_ids.push_back(order_ids_.name(order));
+                if (backlog_cache_.erase(order) > 0) {
+                    released_.push_back(order);
+                }
+            }
         }
     }
-    
-    // Update each order individually using parameterized queries to prevent SQL injection
-    if (!order_ids.empty()) {
-        for (const auto& order_id : order_ids) {
-            txn.exec_params(
-                "UPDATE backlog SET status = 'COMPLETED', closure_date = $1 WHERE order_id = $2",
-                closure_str, order_id
-            );
+    return order_ids;
+}
+
+std::vector<std::string> OrderManager::take_stock_out_items() {
+    // Only the items gone out since the last call, the earlier ones were written already
+    std::vector<std::string> item_ids;
+    const std::vector<ItemIdx>& items = stock_.stock_out_items_;
+    const size_t first = std::min(stock_out_seen_, items.size());
+    stock_out_seen_ = items.size();
+    if (first == items.size()) {
+        return item_ids;
+    }
+    std::unordered_set<ItemIdx> fresh(items.begin() + first, items.end());
+    item_ids.reserve(items.size() - first);
+    for (size_t i = first; i < items.size(); i++) {
+        item_ids.push_back(stock_.get_item_ids().name(items[i]));
+    }
+    stock_out_items_.insert(fresh.begin(), fresh.end());
+
+    for (auto it = backlog_cache_.begin(); it != backlog_cache_.end();) {
+        if (fresh.count(it->second.item_idx)) {
+            released_.push_back(it->first);
+            it = backlog_cache_.erase(it);
+        } else {
+            ++it;
         }
     }
+    return item_ids;
+}
+
+std::vector<std::string> OrderManager::take_stock_out_orders() {
+    std::vector<std::string> order_ids;
+    order_ids.swap(stock_out_orders_);
+    return order_ids;
+}
+
+std::vector<std::string> OrderManager::take_unrouted_orders() {
+    std::vector<std::string> order_ids;
+    order_ids.swap(unrouted_);
+    return order_ids;
+}
+
+void OrderManager::write_expired_orders(pqxx::work& txn, const TimePoint& simulation_date) {
+    std::string sim_date_str = format_iso8601(simulation_date);
     
-    txn.commit();
+    txn.exec_prepared(EXPIRE_ORDERS_STMT, sim_date_str);
+}
+
+void OrderManager::write_completed_orders(pqxx::work& txn, const std::vector<std::string>& order_ids) {
+    ScopedTimer timer(Stage::COMPLETE_ORDERS);
+    if (order_ids.empty()) {
+        return;
+    }
+    TimePoint closure_time = std::chrono::system_clock::now();
+    std::string closure_str = format_iso8601(closure_time);
+    
+    // Single round trip: the IDs travel as one array parameter
+    txn.exec_prepared(COMPLETE_ORDERS_STMT, closure_str, order_ids);
+}
+
+void OrderManager::write_stock_out_orders(pqxx::work& txn, const std::vector<std::string>& item_ids, int zone) {
+    if (item_ids.empty()) {
+        return;
+    }
+    // Out of stock in this zone only, the coordinator routes them again or closes them
+    if (zone >= 0) {
+        txn.exec_prepared(UNROUTE_ITEMS_STMT, zone, item_ids);
+        return;
+    }
+    TimePoint closure_time = std::chrono::system_clock::now();
+    std::string closure_str = format_iso8601(closure_time);
+    
+    // One statement for every stock out item
+    txn.exec_prepared(STOCK_OUT_ORDERS_STMT, closure_str, item_ids);
+}
+
+void OrderManager::write_stock_out_order_ids(pqxx::work& txn, const std::vector<std::string>& order_ids) {
+    if (order_ids.empty()) {
+        return;
+    }
+    txn.exec_prepared(STOCK_OUT_ORDER_IDS_STMT, format_iso8601(std::chrono::system_clock::now()), order_ids);
+}
+
+void OrderManager::write_unrouted_orders(pqxx::work& txn, const std::vector<std::string>& order_ids) {
+    if (order_ids.empty()) {
+        return;
+    }
+    txn.exec_prepared(UNROUTE_ORDERS_STMT, order_ids);
+}
+
+void OrderManager::drop_expired(const TimePoint& simulation_date) {
+    for (auto it = backlog_cache_.begin(); it != backlog_cache_.end();) {
+        if (it->second.due_date < simulation_date) {
+            released_.push_back(it->first);
+            it = backlog_cache_.erase(it);
+        } else {
+            ++it;
+        }
+    }
 }
 
 } // namespace SS
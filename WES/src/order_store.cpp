@@ -0,0 +1,17 @@
+#include "order_store.h"
+#include <chrono>
+
+namespace SS {
+
+// Default bands are the former SQL CASE on (simulation_date - due_date) in minutes
+int order_priority(const TimePoint& simulation_date, const TimePoint& due_date, const PriorityBands& bands) {
+    double minutes = std::chrono::duration<double, std::ratio<60>>(simulation_date - due_date).count();
+    for (size_t band = 0; band < bands.minutes.size(); band++) {
+        if (minutes <= bands.minutes[band]) {
+            return bands.priorities[band];
+        }
+    }
+    return bands.priorities.back();
+}
+
+}
@@ -0,0 +1,32 @@
+#include "ortools_mcf.h"
+
+namespace SS {
+
+OrToolsMCF::OrToolsMCF()
+    : min_cost_flow_(std::make_unique<operations_research::SimpleMinCostFlow>()) {
+}
+
+void OrToolsMCF::set_node_supply(int node, int supply) {
+    min_cost_flow_->SetNodeSupply(node, supply);
+}
+
+int OrToolsMCF::add_arc(int tail, int head, int capacity, int cost) {
+    return static_cast<int>(min_cost_flow_->AddArcWithCapacityAndUnitCost(tail, head, capacity, cost));
+}
+
+void OrToolsMCF::clear() {
+    min_cost_flow_ = std::make_unique<operations_research::SimpleMinCostFlow>();
+}
+
+MCFStatus OrToolsMCF::solve() {
+    switch (min_cost_flow_->Solve()) {
+        case operations_research::SimpleMinCostFlow::OPTIMAL:
+            return MCFStatus::OPTIMAL;
+        case operations_research::SimpleMinCostFlow::UNBALANCED:
+            return MCFStatus::UNBALANCED;
+        default:
+            return MCFStatus::INFEASIBLE;
+    }
+}
+
+}
@@ -0,0 +1,270 @@
+#include "parallel_mcf.h"
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <numeric>
+#include <queue>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace SS {
+
+ParallelMCF::ParallelMCF(const StockManager& stock, ThreadPool& pool, MCFBackend backend)
+    : stock_(stock), pool_(pool), backend_(backend) {
+}
+
+std::vector<Pick> ParallelMCF::solve(const std::vector<Order>& orders, const std::vector<int>& rack_costs,
+                                     int limit, long long& cost) {
+    clusters_.clear();
+    num_components_ = 0;
+    rounds_ = 0;
+    num_nodes_ = 0;
+    num_arcs_ = 0;
+    cost = 0;
+    if (limit <= 0) {
+        return {};
+    }
+
+    // One component per requested item with stock
+    std::unordered_map<ItemIdx, std::vector<size_t>> item_orders;
+    int min_priority = INT_MAX;
+    int max_priority = INT_MIN;
+    for (size_t i = 0; i < orders.size(); i++) {
+        ItemIdx item = orders[i].item_idx;
+        if (item == INVALID_IDX || stock_.is_stock_out(item)) {
+            continue;
+        }
+        item_orders[item].push_back(i);
+        min_priority = std::min(min_priority, orders[i].priority);
+        max_priority = std::max(max_priority, orders[i].priority);
+    }
+    if (item_orders.empty()) {
+        cost = 999999LL * limit;
+        return {};
+    }
+
+    struct Component {
+        ItemIdx item;
+        size_t size;
+    };
+    std::vector<Component> components;
+    components.reserve(item_orders.size());
+    for (const auto& [item, indices] : item_orders) {
+        components.push_back({item, 2 * indices.size() + stock_.get_item_locations(item).size()});
+    }
+    std::sort(components.begin(), components.end(), [](const Component& a, const Component& b) {
+        return a.size != b.size ? a.size > b.size : a.item < b.item;
+    });
+    num_components_ = components.size();
+
+    // Largest component first into the lightest cluster
+    const size_t num_clusters = std::min(components.size(), pool_.size() * 4);
+    clusters_.resize(num_clusters);
+    while (solvers_.size() < num_clusters) {
+        solvers_.push_back(make_mcf_solver(backend_));
+    }
+    using Load = std::pair<size_t, size_t>; // (size, cluster)
+    std::priority_queue<Load, std::vector<Load>, std::greater<Load>> lightest;
+    for (size_t c = 0; c < num_clusters; c++) {
+        lightest.push({0, c});
+    }
+    for (const auto& component : components) {
+        auto [size, c] = lightest.top();
+        lightest.pop();
+        Cluster& cluster = clusters_[c];
+        cluster.items.push_back(component.item);
+        const auto& indices = item_orders[component.item];
+        cluster.orders.insert(cluster.orders.end(), indices.begin(), indices.end());
+        cluster.size += component.size;
+        lightest.push({cluster.size, c});
+    }
+
+    // Price range: every unit is worth more than lo, none is worth more than hi
+    int min_hotness = INT_MAX;
+    int max_hotness = INT_MIN;
+    for (int rack_cost : rack_costs) {
+        min_hotness = std::min(min_hotness, -rack_cost);
+        max_hotness = std::max(max_hotness, -rack_cost);
+    }
+    int lo = min_priority + min_hotness - 1;
+    int hi = max_priority + max_hotness;
+
+    const std::vector<int> no_caps(num_clusters, INT_MAX);
+    std::vector<int> caps = no_caps;
+    std::vector<int> flows_lo = solve_all(orders, rack_costs, lo, no_caps);
+    rounds_++;
+
+    if (std::accumulate(flows_lo.begin(), flows_lo.end(), 0) > limit) {
+        // Bisection on the price until lo and hi are adjacent
+        std::vector<int> flows_hi(num_clusters, 0);
+        while (hi - lo > 1) {
+            int mid = lo + (hi - lo) / 2;
+            std::vector<int> flows = solve_all(orders, rack_costs, mid, no_caps);
+            rounds_++;
+            if (std::accumulate(flows.begin(), flows.end(), 0) <= limit) {
+                hi = mid;
+                flows_hi.swap(flows);
+            } else {
+                lo = mid;
+                flows_lo.swap(flows);
+            }
+        }
+
+        // Units worth exactly hi are interchangeable, hand out the remaining supply greedily
+        int remaining = limit - std::accumulate(flows_hi.begin(), flows_hi.end(), 0);
+        for (size_t c = 0; c < num_clusters; c++) {
+            int extra = std::min(flows_lo[c] - flows_hi[c], remaining);
+            caps[c] = flows_hi[c] + extra;
+            remaining -= extra;
+        }
+    }
+
+    // Final solve at price lo, capped where needed, with extraction
+    std::vector<std::vector<Pick>> cluster_picks(num_clusters);
+    std::vector<int> cluster_nodes(num_clusters, 0);
+    std::vector<int> cluster_arcs(num_clusters, 0);
+    pool_.parallel_for(num_clusters, [&](size_t c) {
+        solve_cluster(c, orders, rack_costs, lo, caps[c], &cluster_picks[c], &cluster_nodes[c], &cluster_arcs[c]);
+    });
+    rounds_++;
+
+    std::vector<Pick> picks;
+    for (size_t c = 0; c < num_clusters; c++) {
+        picks.insert(picks.end(), cluster_picks[c].begin(), cluster_picks[c].end());
+        num_nodes_ += cluster_nodes[c];
+        num_arcs_ += cluster_arcs[c];
+    }
+
+    // Same objective as the MCF: unit costs plus the source->sink penalty for unused supply
+    std::unordered_map<OrderIdx, int> priorities;
+    for (const auto& cluster : clusters_) {
+        for (size_t index : cluster.orders) {
+            priorities[orders[index].order_idx] = orders[index].priority;
+        }
+    }
+    long long units = 0;
+    for (const auto& pick : picks) {
+        cost += static_cast<long long>(pick.quantity) * (-priorities[pick.order] + rack_costs[pick.rack]);
+        units += pick.quantity;
+    }
+    cost += 999999LL * (limit - units);
+    return picks;
+}
+
+std::vector<int> ParallelMCF::solve_all(const std::vector<Order>& orders, const std::vector<int>& rack_costs,
+                                        int lambda, const std::vector<int>& caps) {
+    std::vector<int> flows(clusters_.size(), 0);
+    pool_.parallel_for(clusters_.size(), [&](size_t c) {
+        flows[c] = solve_cluster(c, orders, rack_costs, lambda, caps[c], nullptr, nullptr, nullptr);
+    });
+    return flows;
+}
+
+int ParallelMCF::solve_cluster(size_t c, const std::vector<Order>& orders,
+                               const std::vector<int>& rack_costs, int lambda, int cap,
+                               std::vector<Pick>* picks, int* nodes, int* arcs) const {
+    /**
+     * source -> order -> item -> rack_face -> sink, plus a free source -> sink bypass.
+     * Costs are doubled and the price is lambda + 1/2, so a unit is routed exactly
+     * when its value (priority + hotness) is above lambda and ties never occur.
+     */
+    const Cluster& cluster = clusters_[c];
+    const int num_faces = stock_.num_faces();
+    long long ordered = 0;
+    for (size_t index : cluster.orders) {
+        ordered += orders[index].quantity;
+    }
+    const int supply = static_cast<int>(std::min<long long>(cap, ordered));
+    if (supply == 0) {
+        return 0;
+    }
+
+    MCFSolver& min_cost_flow = *solvers_[c];
+    min_cost_flow.clear();
+    const int source = 0;
+    const int sink = 1;
+    int node_index = 2;
+    min_cost_flow.set_node_supply(source, supply);
+    min_cost_flow.set_node_supply(sink, -supply);
+    const int bypass = min_cost_flow.add_arc(source, sink, supply, 0);
+
+    // Item and rack_face nodes
+    std::unordered_map<ItemIdx, int> item_nodes;
+    std::unordered_map<size_t, int> rack_face_nodes;
+    std::vector<size_t> rack_face_slots;
+    std::vector<int> location_arcs;
+    for (ItemIdx item : cluster.items) {
+        item_nodes[item] = node_index++;
+    }
+    const int first_rack_face = node_index;
+    for (ItemIdx item : cluster.items) {
+        const int item_node = item_nodes[item];
+        for (const auto& location : stock_.get_item_locations(item)) {
+            size_t slot = static_cast<size_t>(location.rack) * num_faces + location.face;
+            auto [it, inserted] = rack_face_nodes.try_emplace(slot, 0);
+            if (inserted) {
+                it->second = node_index++;
+                rack_face_slots.push_back(slot);
+                min_cost_flow.add_arc(it->second, sink, supply, 0);
+            }
+            location_arcs.push_back(min_cost_flow.add_arc(
+                item_node, it->second, location.quantity, 2 * rack_costs[location.rack]));
+        }
+    }
+
+    // Order nodes
+    std::vector<std::pair<int, size_t>> order_arcs; // (order->item arc, index in orders)
+    for (size_t index : cluster.orders) {
+        const Order& order = orders[index];
+        int order_node = node_index++;
+        min_cost_flow.add_arc(source, order_node, order.quantity, -2 * order.priority + 2 * lambda + 1);
+        order_arcs.push_back({min_cost_flow.add_arc(order_node, item_nodes[order.item_idx], order.quantity, 0),
+                              index});
+    }
+
+    if (nodes) {
+        *nodes = min_cost_flow.num_nodes();
+    }
+    if (arcs) {
+        *arcs = min_cost_flow.num_arcs();
+    }
+    if (min_cost_flow.solve() != MCFStatus::OPTIMAL) {
+        throw std::runtime_error("Error: Solving a min cost flow cluster failed.");
+    }
+    const int flow = supply - min_cost_flow.flow(bypass);
+    if (!picks) {
+        return flow;
+    }
+
+    // Match the orders entering each item node with the units leaving it
+    std::vector<std::vector<std::pair<int, int>>> item_outflow(first_rack_face);
+    for (int arc : location_arcs) {
+        int arc_flow = min_cost_flow.flow(arc);
+        if (arc_flow > 0) {
+            item_outflow[min_cost_flow.tail(arc)].push_back({min_cost_flow.head(arc), arc_flow});
+        }
+    }
+    std::vector<size_t> next_outflow(first_rack_face, 0);
+    for (const auto& [arc, index] : order_arcs) {
+        int units = min_cost_flow.flow(arc);
+        int item_node = min_cost_flow.head(arc);
+        auto& outflow = item_outflow[item_node];
+        size_t& next = next_outflow[item_node];
+        while (units > 0) {
+            while (outflow[next].second == 0) {
+                next++;
+            }
+            int taken = std::min(units, outflow[next].second);
+            outflow[next].second -= taken;
+            units -= taken;
+
+            size_t slot = rack_face_slots[outflow[next].first - first_rack_face];
+            picks->push_back({orders[index].order_idx, orders[index].item_idx,
+                              static_cast<RackIdx>(slot / num_faces), static_cast<FaceIdx>(slot % num_faces),
+                              taken});
+        }
+    }
+    return flow;
+}
+
+}
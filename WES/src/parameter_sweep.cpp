@@ -0,0 +1,163 @@
+#include "parameter_sweep.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <unordered_set>
+#include <nlohmann/json.hpp>
+#include "thread_pool.h"
+
+namespace SS {
+
+namespace {
+
+template <typename T>
+void read_values(const nlohmann::json& json_data, const char* key, std::vector<T>& values) {
+    if (json_data.contains(key)) {
+        values = json_data[key].get<std::vector<T>>();
+        if (values.empty()) {
+            throw std::runtime_error(std::string("Sweep parameter has no values: ") + key);
+        }
+    }
+}
+
+// The base value alone when the parameter is not swept
+template <typename T>
+std::vector<T> or_base(const std::vector<T>& values, const T& base) {
+    return values.empty() ? std::vector<T>{base} : values;
+}
+
+}
+
+SweepSpec SweepSpec::from_json_file(const std::string& file_path) {
+    std::ifstream file(file_path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open sweep file: " + file_path);
+    }
+    nlohmann::json json_data;
+    file >> json_data;
+
+    SweepSpec spec;
+    read_values(json_data, "hot_cost", spec.hot_cost);
+    read_values(json_data, "warm_cost", spec.warm_cost);
+    read_values(json_data, "cold_cost", spec.cold_cost);
+    read_values(json_data, "warm_racks_fraction", spec.warm_racks_fraction);
+    read_values(json_data, "priority_minutes", spec.priority_minutes);
+    read_values(json_data, "capacity", spec.capacity);
+    read_values(json_data, "seed", spec.seed);
+    spec.samples = json_data.value("samples", spec.samples);
+    spec.sample_seed = json_data.value("sample_seed", spec.sample_seed);
+    return spec;
+}
+
+std::vector<SimulationConfig> SweepSpec::expand(const SimulationConfig& base) const {
+    const auto hot = or_base(hot_cost, base.rack_costs.hot);
+    const auto warm = or_base(warm_cost, base.rack_costs.warm);
+    const auto cold = or_base(cold_cost, base.rack_costs.cold);
+    const auto fraction = or_base(warm_racks_fraction, base.warm_racks_fraction);
+    const auto minutes = or_base(priority_minutes, base.priority_bands.minutes);
+    const auto capacities = or_base(capacity, std::array<int, 2>{base.min_capacity, base.max_capacity});
+    const auto seeds = or_base(seed, base.seed);
+    const std::vector<size_t> sizes = {hot.size(), warm.size(), cold.size(), fraction.size(),
+                                       minutes.size(), capacities.size(), seeds.size()};
+    size_t total = 1;
+    for (size_t size : sizes) {
+        total *= size;
+    }
+
+    // Grid indices to run, a sorted random subset when sampling
+    std::vector<size_t> indices;
+    if (samples == 0 || samples >= total) {
+        indices.resize(total);
+        for (size_t i = 0; i < total; i++) {
+            indices[i] = i;
+        }
+    } else {
+        std::mt19937_64 rng(sample_seed);
+        std::uniform_int_distribution<size_t> index_dist(0, total - 1);
+        std::unordered_set<size_t> chosen;
+        while (chosen.size() < samples) {
+            chosen.insert(index_dist(rng));
+        }
+        indices.assign(chosen.begin(), chosen.end());
+        std::sort(indices.begin(), indices.end());
+    }
+
+    std::vector<SimulationConfig> configs;
+    configs.reserve(indices.size());
+    for (size_t index : indices) {
+        // Mixed radix decode, the last parameter varies fastest
+        size_t digits[7];
+        for (int d = 6; d >= 0; d--) {
+            digits[d] = index % sizes[d];
+            index /= sizes[d];
+        }
+        SimulationConfig config = base;
+        config.rack_costs = {hot[digits[0]], warm[digits[1]], cold[digits[2]]};
+        config.warm_racks_fraction = fraction[digits[3]];
+        config.priority_bands.minutes = minutes[digits[4]];
+        config.min_capacity = capacities[digits[5]][0];
+        config.max_capacity = capacities[digits[5]][1];
+        config.seed = seeds[digits[6]];
+        configs.push_back(config);
+    }
+    return configs;
+}
+
+ParameterSweep::ParameterSweep(const StockManager& stock, const std::vector<Order>& orders)
+    : stock_(stock), orders_(orders) {
+}
+
+std::vector<SimulationMetrics> ParameterSweep::run(const std::vector<SimulationConfig>& configs,
+                                                   size_t num_threads) const {
+    std::vector<SimulationMetrics> results(configs.size());
+    ThreadPool pool(num_threads);
+    pool.parallel_for(configs.size(), [&](size_t i) {
+        Simulation simulation(configs[i], stock_, orders_);
+        results[i] = simulation.run();
+    });
+    return results;
+}
+
+void ParameterSweep::write_csv(const std::string& file_path, const std::vector<SimulationConfig>& configs,
+                               const std::vector<SimulationMetrics>& results) {
+    std::ofstream file(file_path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open output file: " + file_path);
+    }
+    file << "run,hot_cost,warm_cost,cold_cost,warm_racks_fraction,priority_minutes,min_capacity,max_capacity,seed,"
+            "ticks,published,completed,expired,stock_out,open,throughput_per_hour,expiry_rate,"
+            "rack_visits,orders_per_visit,mean_lead_minutes,solve_ms_total,solve_ms_max,wall_ms\n";
+    for (size_t i = 0; i < configs.size(); i++) {
+        const SimulationConfig& config = configs[i];
+        const SimulationMetrics& metrics = results[i];
+        double hours = std::chrono::duration<double, std::ratio<3600>>(config.end_date - config.start_date).count();
+        file << i << ','
+             << config.rack_costs.hot << ','
+             << config.rack_costs.warm << ','
+             << config.rack_costs.cold << ','
+             << config.warm_racks_fraction << ','
+             << config.priority_bands.minutes[0] << '/' << config.priority_bands.minutes[1] << '/'
+             << config.priority_bands.minutes[2] << ','
+             << config.min_capacity << ','
+             << config.max_capacity << ','
+             << config.seed << ','
+             << metrics.ticks << ','
+             << metrics.published << ','
+             << metrics.completed << ','
+             << metrics.expired << ','
+             << metrics.stock_out << ','
+             << metrics.open << ','
+             << (hours > 0 ? metrics.completed / hours : 0.0) << ','
+             << (metrics.published > 0 ? static_cast<double>(metrics.expired) / metrics.published : 0.0) << ','
+             << metrics.rack_visits << ','
+             << (metrics.rack_visits > 0 ? static_cast<double>(metrics.completed) / metrics.rack_visits : 0.0) << ','
+             << metrics.mean_lead_minutes << ','
+             << metrics.solve_ms_total << ','
+             << metrics.solve_ms_max << ','
+             << metrics.wall_ms << '\n';
+    }
+}
+
+}
@@ -1,6 +1,5 @@
 #include "shelf_selection.h"
 #include <set>
-#include <deque>
 #include <cstddef>
 #include <cstdint>
 #include <vector>
@@ -9,207 +8,672 @@
 #include <string>
 #include <stdexcept>
 #include <cmath>
-#include "ortools/graph/min_cost_flow.h"
+#include <chrono>
+#include <unordered_map>
+#include <unordered_set>
 #include "utils.h"
+#include "metrics.h"
 
 namespace SS {
+
+namespace {
+
+double elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
 // Constructor
-ShelfSelection::ShelfSelection(StockManager& stock)
-    : stock_(stock) {
-    int rack_size = stock_.get_racks().size();
-    warm_racks_limit = static_cast<size_t>(0.2 * rack_size);
-    
-    warm_racks_ = std::deque<RackID>{};
-    hot_racks_ = std::set<RackID>{};
+ShelfSelection::ShelfSelection(StockManager& stock, SolverMode mode)
+    : stock_(stock), mode_(mode), backend_(MCFBackend::NATIVE), solver_(make_mcf_solver(backend_)),
+      incremental_(stock), greedy_(stock), fixed_charge_(stock, backend_) {
+    // The warm racks live in the stock, a restored snapshot keeps them in visit order
+    set_warm_racks_fraction(0.2);
+    hot_racks_ = std::set<RackIdx>{};
 }
 
 Taskpool ShelfSelection::run(const std::vector<Order>& orders, Taskpool& pending, const int& N) {
     // Implementation of the main shelf selection algorithm
     
-    // Mark racks in pending as warm and count covered orders
-    int covered_orders = 0;
-    for (const auto& [rack_id, faces] : pending) {
-        for (const auto& [face_id, orders] : faces) {
-            covered_orders += orders.size();
-            hot_racks_.insert(rack_id);
-            stock_.is_rack_hot_[rack_id] = true;
+    // Mark racks in pending as warm and count the units they still cover
+    int covered_units = 0;
+    for (const auto& [rack, faces] : pending) {
+        for (const auto& [face, orders] : faces) {
+            auto it = face_units_.find({rack, face});
+            covered_units += it != face_units_.end() ? it->second : static_cast<int>(orders.size());
+            hot_racks_.insert(rack);
+            stock_.is_rack_hot_[rack] = true;
         }
     }
 
-    // Determine limit for MCF
-    const int orders_size = orders.size();
-    const int limit = std::min(N - covered_orders, orders_size);
+    // Determine limit for MCF, in units
+    long long ordered_units = 0;
+    for (const auto& order : orders) {
+        ordered_units += order.quantity;
+    }
+    const int limit = static_cast<int>(std::max<long long>(0, std::min<long long>(N - covered_units, ordered_units)));
 
-    return solve_mcf(orders, limit);
+    return solve_mcf(orders, limit, choose_mode(orders.size()));
 }
 
 Taskpool ShelfSelection::solve_mcf(const std::vector<Order>& orders, const int& limit) {
-    // Implementation of the MCF optimization algorithm
+    return solve_mcf(orders, limit, mode_);
+}
 
-    std::set<ItemID> items;
-    std::vector<std::string> nodes_names = {};
-    std::map<OrderID, ItemID> order_to_item; // Map to track which item each order needs
- 
-    // Generate a mapping of the nodes
-    int node_index = 0;
-    
-    // Source node
-    int source = node_index;
-    node_index++;
-    nodes_names.push_back("source");
+Taskpool ShelfSelection::solve_mcf(const std::vector<Order>& orders, const int& limit, SolverMode mode) {
+    last_stats_ = MCFStats{};
+    last_stats_.mode = mode;
+    auto start = std::chrono::steady_clock::now();
+    Taskpool taskpool;
+    // Order indices are reused once closed, the cache must not outlive a backlog it missed
+    if (mode != SolverMode::INCREMENTAL) {
+        incremental_.clear();
+    }
+    switch (mode) {
+        case SolverMode::DENSE:
+            taskpool = solve_mcf_dense(orders, limit);
+            break;
+        case SolverMode::INCREMENTAL:
+            taskpool = solve_mcf_incremental(orders, limit);
+            break;
+        case SolverMode::PARALLEL:
+            taskpool = solve_mcf_parallel(orders, limit);
+            break;
+        case SolverMode::GREEDY:
+            taskpool = solve_mcf_greedy(orders, limit);
+            break;
+        case SolverMode::FIXED_CHARGE:
+            taskpool = solve_mcf_fixed_charge(orders, limit);
+            break;
+        default:
+            taskpool = solve_mcf_sparse(orders, limit);
+            break;
+    }
+    last_stats_.racks_opened = static_cast<int>(taskpool.size());
+    for (const auto& [rack, faces] : taskpool) {
+        last_stats_.faces_opened += static_cast<int>(faces.size());
+    }
+    if (mode != SolverMode::FIXED_CHARGE) {
+        last_stats_.linear_racks_opened = last_stats_.racks_opened;
+    }
+    // The greedy cost says nothing about what an exact solve would take
+    if (mode != SolverMode::GREEDY && !orders.empty()) {
+        exact_ms_per_order_ = (last_stats_.build_ms + last_stats_.solve_ms) / orders.size();
+    }
+    // A shadow solve runs beside the live one, its times would pass for the live stages
+    if (!shadow_instance_) {
+        record_metrics(elapsed_ms(start));
+    }
+    return taskpool;
+}
 
-    // Orders nodes
-    std::map<OrderID, int> order_nodes;
-    for (const auto& order : orders) {
-        // Map order ID to node index
-        order_nodes[order.order_id] = node_index;
-        node_index++;
-        nodes_names.push_back(order.order_id);
-        items.insert(order.item_id);
-        order_to_item[order.order_id] = order.item_id; // Store order-to-item mapping
-    };
+void ShelfSelection::record_metrics(double total_ms) const {
+    Metrics& metrics = Metrics::global();
+    if (!metrics.enabled()) {
+        return;
+    }
+    // Every engine reports build and solve, whatever else the call did is extraction
+    metrics.record(Stage::BUILD_GRAPH, last_stats_.build_ms);
+    metrics.record(Stage::SOLVE, last_stats_.solve_ms);
+    metrics.record(Stage::EXTRACT, std::max(0.0, total_ms - last_stats_.build_ms - last_stats_.solve_ms));
+    metrics.set(Gauge::NODES, last_stats_.num_nodes);
+    metrics.set(Gauge::ARCS, last_stats_.num_arcs);
+    metrics.set(Gauge::FLOW, last_stats_.assigned_units);
+    metrics.set(Gauge::COST, last_stats_.optimal_cost);
+    metrics.set(Gauge::RACKS_OPENED, last_stats_.racks_opened);
+}
 
-    // Rack_face nodes
-    std::map<std::pair<RackID, FaceID>, int> rack_face_nodes;
-    for (const auto& rack_id : stock_.get_racks()) {
-        for (const auto& face_id : stock_.get_faces()) {
-            // Map (rack_id, face_id) to node index
-            rack_face_nodes[{rack_id, face_id}] = node_index;
-            nodes_names.push_back(rack_id + " " + face_id);
-            node_index++;
-        }
+SolverMode ShelfSelection::choose_mode(size_t num_orders) const {
+    if (deadline_ms_ <= 0 || mode_ == SolverMode::GREEDY) {
+        return mode_;
     }
+    return exact_ms_per_order_ * num_orders > deadline_ms_ ? SolverMode::GREEDY : mode_;
+}
+
+Taskpool ShelfSelection::solve_mcf_dense(const std::vector<Order>& orders, const int& limit) {
+    /**
+     * Flat graph: source -> order -> (rack, face, item) -> sink.
+     * Every order gets its own arc to every location of its item, where SPARSE shares
+     * them through an item node, so the arcs grow with orders x locations. A location
+     * node serves one item only, so both graphs have the same optimum.
+     */
+    auto build_start = std::chrono::steady_clock::now();
 
-    // Items nodes
-    std::map<ItemID, int> item_nodes;
-    for (const auto& item_id : items) {
-        // Map item ID to node index
-        item_nodes[item_id] = node_index;
-        nodes_names.push_back(item_id);
-        node_index++;
+    // Locations of the requested items, in first-seen order
+    std::vector<int> first_location(stock_.get_item_ids().size(), -1);
+    std::vector<StockLocation> locations;
+    std::vector<ItemIdx> location_items;
+    for (const auto& order : orders) {
+        ItemIdx item = order.item_idx;
+        if (item == INVALID_IDX || first_location[item] >= 0) {
+            continue;
+        }
+        first_location[item] = static_cast<int>(locations.size());
+        for (const auto& location : stock_.get_item_locations(item)) {
+            locations.push_back(location);
+            location_items.push_back(item);
+        }
     }
 
-    // Sink node
-    int sink = node_index;
-    node_index++;
-    nodes_names.push_back("sink");
+    // Node layout: source, orders, locations, sink
+    const int num_orders = orders.size();
+    const int source = 0;
+    const int first_order = source + 1;
+    const int first_rack_face = first_order + num_orders;
+    const int sink = first_rack_face + static_cast<int>(locations.size());
 
-    // Instantiate MinCostFlow solver
-    operations_research::SimpleMinCostFlow min_cost_flow;
-    
-    // Add sink supplies
-    min_cost_flow.SetNodeSupply(sink, limit);
-    min_cost_flow.SetNodeSupply(source, -limit);
+    // Reuse the MinCostFlow solver buffers
+    MCFSolver& min_cost_flow = *solver_;
+    min_cost_flow.clear();
+
+    // Add supplies (positive supply at the source, demand at the sink)
+    min_cost_flow.set_node_supply(source, limit);
+    min_cost_flow.set_node_supply(sink, -limit);
 
     // Source to order edges
-    for (const auto& order : orders) {
-        min_cost_flow.AddArcWithCapacityAndUnitCost(
-            source, order_nodes[order.order_id], 1, -order.priority); // start, end, capacity, cost
+    for (int i = 0; i < num_orders; i++) {
+        min_cost_flow.add_arc(
+            source, first_order + i, orders[i].quantity, -orders[i].priority); // start, end, capacity, cost
     }
-    
+
     std::vector<int> relevant_arcs = {};
 
-    // Orders to rack_face edges
+    // Orders to the locations of their item
+    for (int i = 0; i < num_orders; i++) {
+        ItemIdx item = orders[i].item_idx;
+        if (item == INVALID_IDX) {
+            continue;
+        }
+        for (int location = first_location[item];
+             location < static_cast<int>(locations.size()) && location_items[location] == item; location++) {
+            int arc = min_cost_flow.add_arc(
+                        first_order + i, first_rack_face + location,
+                        orders[i].quantity, rack_cost(locations[location].rack)); // start, end, capacity, cost
+            relevant_arcs.push_back(arc);
+        }
+    }
+
+    // Location to sink edges with the stocked quantity as capacity
+    for (size_t location = 0; location < locations.size(); location++) {
+        min_cost_flow.add_arc(
+            first_rack_face + static_cast<int>(location), sink,
+            locations[location].quantity, 0); // start, end, capacity, cost
+    }
+
+    // Source to sink direct edge (for unfulfilled orders)
+    min_cost_flow.add_arc(
+        source, sink, limit, 999999); // start, end, capacity, cost
+
+    last_stats_.num_nodes = sink + 1;
+    last_stats_.num_arcs = min_cost_flow.num_arcs();
+    last_stats_.build_ms = elapsed_ms(build_start);
+
+    // Find the min cost flow.
+    auto solve_start = std::chrono::steady_clock::now();
+    MCFStatus status = min_cost_flow.solve();
+    last_stats_.solve_ms = elapsed_ms(solve_start);
+
+    if (status != MCFStatus::OPTIMAL) {
+        throw std::runtime_error("Error: Solving the min cost flow problem failed.");
+    }
+    last_stats_.optimal_cost = min_cost_flow.optimal_cost();
+
+    // Extract the solution into picks
+    std::vector<Pick> picks;
+    for (int arc : relevant_arcs) {
+        int flow = min_cost_flow.flow(arc);
+        if (flow > 0) {
+            const Order& order = orders[min_cost_flow.tail(arc) - first_order];
+            const StockLocation& location = locations[min_cost_flow.head(arc) - first_rack_face];
+            picks.push_back({order.order_idx, order.item_idx, location.rack, location.face, flow});
+        }
+    }
+    return settle_picks(orders, picks);
+}
+
+Taskpool ShelfSelection::solve_mcf_sparse(const std::vector<Order>& orders, const int& limit) {
+    /**
+     * Layered graph: source -> order -> item -> (rack, face) -> sink.
+     * An order only reaches the faces that stock its item, so the number of arcs
+     * grows with orders + stocked locations instead of orders x racks x faces.
+     */
+    auto build_start = std::chrono::steady_clock::now();
+    const int num_faces = stock_.num_faces();
+
+    // Requested items with stock, in first-seen order
+    std::vector<ItemIdx> items;
+    std::vector<int> item_nodes(stock_.get_item_ids().size(), -1);
+    int node_index = 0;
+    const int source = node_index++;
     for (const auto& order : orders) {
-        for (const auto& rack_id : stock_.get_racks()) {
-            for (const auto& face_id : stock_.get_faces()) {
-                int arc = min_cost_flow.AddArcWithCapacityAndUnitCost(
-                            order_nodes[order.order_id],
-                            rack_face_nodes[{rack_id, face_id}],
-                            1, 0); // start, end, capacity, cost
-                relevant_arcs.push_back(arc);
+        if (order.item_idx != INVALID_IDX && item_nodes[order.item_idx] < 0
+            && !stock_.is_stock_out(order.item_idx)) {
+            item_nodes[order.item_idx] = node_index++;
+            items.push_back(order.item_idx);
+        }
+    }
+
+    // Rack_face nodes, only for faces holding a requested item
+    std::vector<int> rack_face_nodes(stock_.num_racks() * num_faces, -1);
+    std::vector<int> rack_face_slots; // node - first_rack_face -> rack * num_faces + face
+    const int first_rack_face = node_index;
+    for (ItemIdx item : items) {
+        for (const auto& location : stock_.get_item_locations(item)) {
+            int slot = location.rack * num_faces + location.face;
+            if (rack_face_nodes[slot] < 0) {
+                rack_face_nodes[slot] = node_index++;
+                rack_face_slots.push_back(slot);
             }
         }
     }
 
-    // Rack_face to item edges
-    for (const auto& rack_id : stock_.get_racks()) {
-        for (const auto& face_id : stock_.get_faces()) {
-            for (const auto& item_id : items) {
-                int quantity = stock_.get_item_quantity(rack_id, face_id, item_id);
-                int cost;
-                if (stock_.is_rack_hot_[rack_id]) {
-                    cost = -5;
-                } else if (stock_.is_rack_warm_[rack_id]) {
-                    cost = -3;
-                } else {
-                    cost = -1;
-                }
+    const int sink = node_index++;
 
-                if (quantity > 0) {
-                    min_cost_flow.AddArcWithCapacityAndUnitCost(
-                        rack_face_nodes[{rack_id, face_id}],
-                        item_nodes[item_id],
-                        quantity, cost); // start, end, capacity, cost
-                }
-            }
+    MCFSolver& min_cost_flow = *solver_;
+    min_cost_flow.clear();
+    min_cost_flow.set_node_supply(source, limit);
+    min_cost_flow.set_node_supply(sink, -limit);
+
+    // Source -> order -> item edges. Orders whose item has no stock cannot carry flow.
+    std::vector<std::pair<int, size_t>> order_arcs; // (order->item arc, index in orders)
+    for (size_t i = 0; i < orders.size(); i++) {
+        ItemIdx item = orders[i].item_idx;
+        if (item == INVALID_IDX || item_nodes[item] < 0) {
+            continue;
         }
+        int order_node = node_index++;
+        min_cost_flow.add_arc(source, order_node, orders[i].quantity, -orders[i].priority);
+        int arc = min_cost_flow.add_arc(order_node, item_nodes[item], orders[i].quantity, 0);
+        order_arcs.push_back({arc, i});
     }
 
-    // Item to sink edges
-    for (const auto& item_id : items) {
-        min_cost_flow.AddArcWithCapacityAndUnitCost(
-            item_nodes[item_id], sink, limit, 0); // start, end, capacity, cost
+    // Item -> rack_face edges with the stocked quantity as capacity
+    std::vector<int> location_arcs;
+    for (ItemIdx item : items) {
+        for (const auto& location : stock_.get_item_locations(item)) {
+            int arc = min_cost_flow.add_arc(
+                item_nodes[item],
+                rack_face_nodes[location.rack * num_faces + location.face],
+                location.quantity, rack_cost(location.rack));
+            location_arcs.push_back(arc);
+        }
+    }
+
+    // Rack_face -> sink edges
+    for (int node = first_rack_face; node < sink; node++) {
+        min_cost_flow.add_arc(node, sink, limit, 0);
     }
 
     // Source to sink direct edge (for unfulfilled orders)
-    min_cost_flow.AddArcWithCapacityAndUnitCost(
-        source, sink, limit, 999999); // start, end, capacity, cost
-    
-    // Find the min cost flow.
-    int status = min_cost_flow.Solve();
+    min_cost_flow.add_arc(source, sink, limit, 999999);
+
+    last_stats_.num_nodes = node_index;
+    last_stats_.num_arcs = min_cost_flow.num_arcs();
+    last_stats_.build_ms = elapsed_ms(build_start);
+
+    auto solve_start = std::chrono::steady_clock::now();
+    MCFStatus status = min_cost_flow.solve();
+    last_stats_.solve_ms = elapsed_ms(solve_start);
 
-    if (status != operations_research::SimpleMinCostFlow::OPTIMAL) {
+    if (status != MCFStatus::OPTIMAL) {
         throw std::runtime_error("Error: Solving the min cost flow problem failed.");
     }
-    
-    // Extract the solution into taskpool
-    Taskpool taskpool;
+    last_stats_.optimal_cost = min_cost_flow.optimal_cost();
 
-    for (int arc : relevant_arcs) {
-        if (min_cost_flow.Flow(arc) > 0.5) {
-            int order_node = min_cost_flow.Tail(arc);
-            int rack_face_node = min_cost_flow.Head(arc);
+    // Units leaving each item node, per rack_face, in arc order
+    std::vector<std::vector<std::pair<int, int>>> item_outflow(first_rack_face); // item node -> (rack_face node, flow)
+    for (int arc : location_arcs) {
+        int flow = min_cost_flow.flow(arc);
+        if (flow > 0) {
+            item_outflow[min_cost_flow.tail(arc)].push_back({min_cost_flow.head(arc), flow});
+        }
+    }
 
-            // Find corresponding order ID in O(1)
-            OrderID order_id = nodes_names[order_node];
-            
-            // Parse rack_id and face_id from the string "rack_id face_id"
-            std::string rack_face_str = nodes_names[rack_face_node];
-            size_t space_pos = rack_face_str.find(' ');
-            RackID rack_id = rack_face_str.substr(0, space_pos);
-            FaceID face_id = rack_face_str.substr(space_pos + 1);
+    // Match the orders entering each item node with the units leaving it
+    std::vector<Pick> picks;
+    std::vector<size_t> next_outflow(first_rack_face, 0);
+    for (const auto& [arc, index] : order_arcs) {
+        int units = min_cost_flow.flow(arc);
+        int item_node = min_cost_flow.head(arc);
+        auto& outflow = item_outflow[item_node];
+        size_t& next = next_outflow[item_node];
+        while (units > 0) {
+            while (outflow[next].second == 0) {
+                next++;
+            }
+            int taken = std::min(units, outflow[next].second);
+            outflow[next].second -= taken;
+            units -= taken;
 
-            // Add to taskpool
-            taskpool[rack_id][face_id].push_back(order_id);
-            set_rack_warm(rack_id);
+            const Order& order = orders[index];
+            int slot = rack_face_slots[outflow[next].first - first_rack_face];
+            picks.push_back({order.order_idx, order.item_idx,
+                             static_cast<RackIdx>(slot / num_faces), static_cast<FaceIdx>(slot % num_faces), taken});
+        }
+    }
+    return settle_picks(orders, picks);
+}
+
+Taskpool ShelfSelection::solve_mcf_incremental(const std::vector<Order>& orders, const int& limit) {
+    auto build_start = std::chrono::steady_clock::now();
+    incremental_.update(orders, rack_costs());
+    last_stats_.components = incremental_.num_components();
+    last_stats_.rebuilt_components = incremental_.last_rebuilt();
+    last_stats_.build_ms = elapsed_ms(build_start);
+
+    auto solve_start = std::chrono::steady_clock::now();
+    std::vector<Pick> picks = incremental_.solve(limit, last_stats_.optimal_cost);
+    last_stats_.solve_ms = elapsed_ms(solve_start);
+
+    return settle_picks(orders, picks);
+}
+
+Taskpool ShelfSelection::solve_mcf_parallel(const std::vector<Order>& orders, const int& limit) {
+    if (!parallel_) {
+        pool_ = std::make_unique<ThreadPool>(num_threads_);
+        parallel_ = std::make_unique<ParallelMCF>(stock_, *pool_, backend_);
+    }
+
+    auto solve_start = std::chrono::steady_clock::now();
+    std::vector<Pick> picks = parallel_->solve(orders, rack_costs(), limit, last_stats_.optimal_cost);
+    last_stats_.solve_ms = elapsed_ms(solve_start);
+    last_stats_.components = parallel_->num_components();
+    last_stats_.rounds = parallel_->rounds();
+    last_stats_.num_nodes = parallel_->num_nodes();
+    last_stats_.num_arcs = parallel_->num_arcs();
+
+    return settle_picks(orders, picks);
+}
+
+Taskpool ShelfSelection::solve_mcf_greedy(const std::vector<Order>& orders, const int& limit) {
+    poll_shadow();
+
+    auto solve_start = std::chrono::steady_clock::now();
+    std::vector<Pick> picks = greedy_.solve(orders, rack_costs(), limit, deadline_ms_, last_stats_.optimal_cost);
+    last_stats_.solve_ms = elapsed_ms(solve_start);
+    last_stats_.components = greedy_.num_components();
+    last_stats_.timed_out = greedy_.timed_out();
+
+    // The shadow copies the stock before the picks are taken from it
+    if (shadow_every_ > 0 && ++greedy_runs_ % shadow_every_ == 0 && !shadow_.valid()) {
+        start_shadow(orders, limit, last_stats_.optimal_cost);
+    }
+
+    return settle_picks(orders, picks);
+}
+
+Taskpool ShelfSelection::solve_mcf_fixed_charge(const std::vector<Order>& orders, const int& limit) {
+    auto solve_start = std::chrono::steady_clock::now();
+    std::vector<Pick> picks = fixed_charge_.solve(orders, rack_costs(), stock_.is_rack_hot_, limit,
+                                                  last_stats_.optimal_cost);
+    last_stats_.build_ms = fixed_charge_.build_ms();
+    last_stats_.solve_ms = elapsed_ms(solve_start) - last_stats_.build_ms;
+    last_stats_.num_nodes = fixed_charge_.num_nodes();
+    last_stats_.num_arcs = fixed_charge_.num_arcs();
+    last_stats_.iterations = fixed_charge_.iterations();
+    last_stats_.timed_out = fixed_charge_.timed_out();
+    last_stats_.linear_racks_opened = fixed_charge_.linear_racks();
+
+    return settle_picks(orders, picks);
+}
 
-            // Update stock quantities
-            ItemID item_id = order_to_item[order_id]; // Get the item_id for this order
-            stock_.set_item_quantity(rack_id, face_id, item_id, -1);
+void ShelfSelection::poll_shadow() {
+    if (!shadow_.valid() || shadow_.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return;
+    }
+    MCFStats shadow = shadow_.get();
+    last_stats_.shadowed = true;
+    last_stats_.shadow_heuristic_cost = shadow.shadow_heuristic_cost;
+    last_stats_.shadow_optimal_cost = shadow.shadow_optimal_cost;
+    last_stats_.shadow_ms = shadow.shadow_ms;
+    if (shadow_orders_ > 0) {
+        exact_ms_per_order_ = shadow.shadow_ms / shadow_orders_;
+    }
+}
+
+void ShelfSelection::start_shadow(const std::vector<Order>& orders, int limit, long long heuristic_cost) {
+    shadow_orders_ = orders.size();
+    shadow_ = std::async(std::launch::async,
+                         [stock = stock_, orders, limit, heuristic_cost, backend = backend_]() mutable {
+        ShelfSelection exact(stock, SolverMode::SPARSE);
+        exact.shadow_instance_ = true;
+        exact.set_backend(backend);
+        exact.solve_mcf(orders, limit);
+
+        MCFStats shadow;
+        shadow.shadow_heuristic_cost = heuristic_cost;
+        shadow.shadow_optimal_cost = exact.get_last_stats().optimal_cost;
+        shadow.shadow_ms = exact.get_last_stats().build_ms + exact.get_last_stats().solve_ms;
+        return shadow;
+    });
+}
+
+void ShelfSelection::set_backend(MCFBackend backend) {
+    solver_ = make_mcf_solver(backend);
+    backend_ = backend;
+    parallel_.reset();
+    fixed_charge_.set_backend(backend);
+}
+
+void ShelfSelection::set_num_threads(size_t num_threads) {
+    num_threads_ = num_threads;
+    parallel_.reset();
+    pool_.reset();
+}
+
+std::vector<int> ShelfSelection::rack_costs() const {
+    std::vector<int> costs(stock_.num_racks());
+    for (RackIdx rack = 0; rack < costs.size(); rack++) {
+        costs[rack] = rack_cost(rack);
+    }
+    return costs;
+}
+
+Taskpool ShelfSelection::settle_picks(const std::vector<Order>& orders, const std::vector<Pick>& picks) {
+    const bool multi_unit = std::any_of(orders.begin(), orders.end(),
+                                        [](const Order& order) { return order.quantity != 1; });
+    face_units_.clear();
+    Taskpool taskpool;
+    if (!multi_unit) {
+        for (const auto& pick : picks) {
+            apply_pick(pick, taskpool);
         }
+        last_stats_.assigned_orders = static_cast<int>(picks.size());
+    } else {
+        std::unordered_set<OrderIdx> lines;
+        for (const auto& pick : settle_lines(orders, picks)) {
+            apply_pick(pick, taskpool);
+            lines.insert(pick.order);
+        }
+        last_stats_.assigned_orders = static_cast<int>(lines.size());
     }
     reset_hot_racks();
     return taskpool;
 }
 
-void ShelfSelection::set_rack_warm(const RackID& rack_id) {
+std::vector<Pick> ShelfSelection::settle_lines(const std::vector<Order>& orders, const std::vector<Pick>& picks) {
+    /**
+     * The engines route units, so a line of several units may come out partially
+     * routed, or spread over more faces than needed. The units an engine routed to
+     * such an item are pooled per face and handed out again: complete lines first,
+     * largest first, each on the face that fits it most tightly, split over the
+     * fullest faces otherwise. A split costs split_penalty per extra face and is only
+     * made when the line is worth more. Units left over go to lines of the item that
+     * fit on one face, by priority. Items with unit lines only keep their picks.
+     */
+    struct Slot {
+        RackIdx rack;
+        FaceIdx face;
+        int units;
+    };
+
+    std::unordered_map<OrderIdx, size_t> line_of; // order -> index in orders
+    line_of.reserve(orders.size());
+    for (size_t i = 0; i < orders.size(); i++) {
+        line_of[orders[i].order_idx] = i;
+    }
+    std::vector<int> routed(orders.size(), 0);
+    std::vector<bool> repack(stock_.get_item_ids().size(), false);
+    for (const auto& pick : picks) {
+        const size_t line = line_of.at(pick.order);
+        routed[line] += pick.quantity;
+        if (orders[line].quantity > 1 && pick.item != INVALID_IDX) {
+            repack[pick.item] = true;
+        }
+    }
+
+    std::vector<Pick> settled;
+    std::map<ItemIdx, std::vector<Slot>> pools;
+    for (const auto& pick : picks) {
+        if (pick.item == INVALID_IDX || !repack[pick.item]) {
+            settled.push_back(pick);
+            continue;
+        }
+        auto& pool = pools[pick.item];
+        auto it = std::find_if(pool.begin(), pool.end(), [&](const Slot& slot) {
+            return slot.rack == pick.rack && slot.face == pick.face;
+        });
+        if (it != pool.end()) {
+            it->units += pick.quantity;
+        } else {
+            pool.push_back({pick.rack, pick.face, pick.quantity});
+        }
+    }
+    std::map<ItemIdx, std::vector<size_t>> item_lines;
+    for (size_t i = 0; i < orders.size(); i++) {
+        if (orders[i].item_idx != INVALID_IDX && repack[orders[i].item_idx]) {
+            item_lines[orders[i].item_idx].push_back(i);
+        }
+    }
+
+    std::vector<bool> placed(orders.size(), false);
+    for (auto& [item, pool] : pools) {
+        // Hottest faces first among equal fits
+        std::stable_sort(pool.begin(), pool.end(), [&](const Slot& a, const Slot& b) {
+            return rack_cost(a.rack) < rack_cost(b.rack);
+        });
+        auto place = [&, item = item](size_t i, bool allow_split) {
+            const Order& order = orders[i];
+            Slot* best = nullptr;
+            for (Slot& slot : pool) {
+                if (slot.units >= order.quantity && (!best || slot.units < best->units)) {
+                    best = &slot;
+                }
+            }
+            if (best) {
+                best->units -= order.quantity;
+                settled.push_back({order.order_idx, item, best->rack, best->face, order.quantity});
+                placed[i] = true;
+                return;
+            }
+            if (!allow_split) {
+                return;
+            }
+            std::vector<Slot*> fullest;
+            for (Slot& slot : pool) {
+                if (slot.units > 0) {
+                    fullest.push_back(&slot);
+                }
+            }
+            std::stable_sort(fullest.begin(), fullest.end(), [](const Slot* a, const Slot* b) {
+                return a->units > b->units;
+            });
+            int needed = order.quantity;
+            int faces = 0;
+            while (faces < static_cast<int>(fullest.size()) && needed > 0) {
+                needed -= fullest[faces++]->units;
+            }
+            if (needed > 0 || static_cast<long long>(split_penalty_) * (faces - 1)
+                                  > static_cast<long long>(order.priority) * order.quantity) {
+                return;
+            }
+            needed = order.quantity;
+            for (int f = 0; f < faces; f++) {
+                const int taken = std::min(needed, fullest[f]->units);
+                fullest[f]->units -= taken;
+                needed -= taken;
+                settled.push_back({order.order_idx, item, fullest[f]->rack, fullest[f]->face, taken});
+            }
+            placed[i] = true;
+            last_stats_.split_orders++;
+        };
+
+        std::vector<size_t> complete;
+        std::vector<size_t> rest;
+        for (size_t i : item_lines[item]) {
+            (routed[i] == orders[i].quantity ? complete : rest).push_back(i);
+        }
+        std::stable_sort(complete.begin(), complete.end(), [&](size_t a, size_t b) {
+            if (orders[a].quantity != orders[b].quantity) {
+                return orders[a].quantity > orders[b].quantity;
+            }
+            return orders[a].priority > orders[b].priority;
+        });
+        std::stable_sort(rest.begin(), rest.end(), [&](size_t a, size_t b) {
+            return orders[a].priority > orders[b].priority;
+        });
+        for (size_t i : complete) {
+            place(i, true);
+        }
+        for (size_t i : rest) {
+            place(i, false);
+        }
+        for (size_t i : item_lines[item]) {
+            if (routed[i] > 0 && !placed[i]) {
+                last_stats_.dropped_orders++;
+            }
+        }
+    }
+    return settled;
+}
+
+void ShelfSelection::apply_pick(const Pick& pick, Taskpool& taskpool) {
+    taskpool[pick.rack][pick.face].push_back(pick.order);
+    set_rack_warm(pick.rack);
+    last_stats_.assigned_units += pick.quantity;
+    face_units_[{pick.rack, pick.face}] += pick.quantity;
+    if (pick.item != INVALID_IDX) {
+        stock_.set_item_quantity(pick.rack, pick.face, pick.item, -pick.quantity);
+    }
+}
+
+int ShelfSelection::rack_cost(RackIdx rack) const {
+    if (stock_.is_rack_hot_[rack]) {
+        return rack_costs_.hot;
+    }
+    if (stock_.is_rack_warm_[rack]) {
+        return rack_costs_.warm;
+    }
+    return rack_costs_.cold;
+}
+
+void ShelfSelection::set_warm_racks_fraction(double fraction) {
+    warm_racks_limit = static_cast<size_t>(std::max(0.0, fraction) * stock_.num_racks());
+    // Cool the oldest racks down to the new limit
+    while (stock_.warm_racks_.size() > warm_racks_limit) {
+        stock_.is_rack_warm_[stock_.warm_racks_.front()] = false;
+        stock_.warm_racks_.pop_front();
+    }
+}
+
+void ShelfSelection::set_rack_warm(RackIdx rack) {
     // Add rack to warm racks queue
-    warm_racks_.push_back(rack_id);
-    stock_.is_rack_warm_[rack_id] = true;
+    stock_.warm_racks_.push_back(rack);
+    stock_.is_rack_warm_[rack] = true;
 
-    if (warm_racks_.size() > warm_racks_limit) {
+    if (stock_.warm_racks_.size() > warm_racks_limit) {
         // Remove the oldest warm rack
-        RackID oldest_rack = warm_racks_.front();
+        RackIdx oldest_rack = stock_.warm_racks_.front();
         stock_.is_rack_warm_[oldest_rack] = false;
-        warm_racks_.pop_front();
+        stock_.warm_racks_.pop_front();
     }
 }
 
 void ShelfSelection::reset_hot_racks() {
-    hot_racks_.clear();
-    for (const auto& rack_id : stock_.get_racks()) {
-        stock_.is_rack_hot_[rack_id] = false;
+    for (RackIdx rack : hot_racks_) {
+        stock_.is_rack_hot_[rack] = false;
     }
+    hot_racks_.clear();
 }
-} // namespace SS
\ No newline at end of file
+} // namespace SS
@@ -0,0 +1,218 @@
+#include "simulation.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <stdexcept>
+#include <nlohmann/json.hpp>
+#include "utils.h"
+#include "metrics.h"
+
+namespace SS {
+
+namespace {
+
+double elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+Simulation::Simulation(const SimulationConfig& config, const StockManager& stock, const std::vector<Order>& orders)
+    : config_(config),
+      stock_(stock),
+      store_(orders, stock_),
+      shelf_selection_(stock_, config.mode) {
+    if (config.stations > 0) {
+        auto stations = std::make_unique<StationManager>(
+            make_station_layout(config.stations, config.min_capacity, config.max_capacity), config.seed);
+        stations->set_face_units(&shelf_selection_.get_face_units());
+        stations_ = stations.get();
+        task_manager_ = std::move(stations);
+    } else {
+        task_manager_ = std::make_unique<TaskManager>(config.seed, config.min_capacity, config.max_capacity);
+    }
+    store_.set_priority_bands(config.priority_bands);
+    shelf_selection_.set_rack_costs(config.rack_costs);
+    shelf_selection_.set_warm_racks_fraction(config.warm_racks_fraction);
+    shelf_selection_.set_trip_costs(config.trip_costs);
+    shelf_selection_.set_split_penalty(config.split_penalty);
+}
+
+const SimulationMetrics& Simulation::run() {
+    auto wall_start = std::chrono::steady_clock::now();
+    TimePoint last_tick = config_.start_date;
+    while (true) {
+        Trigger trigger;
+        TimePoint date = next_trigger(last_tick, trigger);
+        if (date >= config_.end_date) {
+            break;
+        }
+        tick(date, trigger);
+        last_tick = date;
+    }
+    collect_metrics();
+    metrics_.wall_ms = elapsed_ms(wall_start);
+    return metrics_;
+}
+
+TimePoint Simulation::next_trigger(const TimePoint& last_tick, Trigger& trigger) const {
+    const TriggerPolicy& policy = config_.trigger_policy;
+    trigger = Trigger::TIMER;
+    TimePoint date = last_tick + policy.fallback;
+    if (config_.event_driven) {
+        // Arrivals before last_tick only happen before the first tick, they trigger it right away
+        TimePoint count_date = store_.next_arrival(static_cast<size_t>(std::max(1, policy.min_orders) - 1));
+        if (count_date <= date) {
+            trigger = Trigger::COUNT;
+            date = std::max<TimePoint>(count_date, last_tick);
+        }
+        TimePoint first_arrival = store_.next_arrival();
+        if (first_arrival != TimePoint::max() && first_arrival + policy.max_delay < date) {
+            trigger = Trigger::DELAY;
+            date = std::max<TimePoint>(first_arrival + policy.max_delay, last_tick);
+        }
+    }
+    return date;
+}
+
+void Simulation::tick(const TimePoint& date, Trigger trigger) {
+    SimulationTick record;
+    record.tick = static_cast<int>(ticks_.size()) + 1;
+    record.date = date;
+    record.trigger = trigger;
+
+    // Same steps as the wes.cpp loop
+    store_.expire_orders(date);
+    std::vector<Order> backlog = store_.get_backlog(date);
+    record.backlog_size = backlog.size();
+    Metrics::global().set(Gauge::BACKLOG, static_cast<long long>(backlog.size()));
+
+    // Capacity accrues with simulated time since the previous tick, or since start_date
+    const TimePoint previous = ticks_.empty() ? config_.start_date : ticks_.back().date;
+    record.capacity = task_manager_->accrue_capacity(
+        std::chrono::duration_cast<std::chrono::milliseconds>(date - previous));
+    auto solve_start = std::chrono::steady_clock::now();
+    Taskpool taskpool = shelf_selection_.run(backlog, pending_, record.capacity);
+    record.solve_ms = elapsed_ms(solve_start);
+    const MCFStats& stats = shelf_selection_.get_last_stats();
+    record.assigned_orders = stats.assigned_orders;
+    record.assigned_units = stats.assigned_units;
+    record.cost = stats.optimal_cost;
+    record.racks = taskpool.size();
+    record.faces = stats.faces_opened;
+    record.linear_racks = stats.linear_racks_opened;
+
+    store_.complete_orders(taskpool, date);
+    store_.stock_out_orders(date);
+
+    {
+        ScopedTimer timer(Stage::PROCESS_TASKS);
+        pending_ = task_manager_->process_tasks(taskpool);
+    }
+    if (stations_) {
+        for (const StationStats& station : stations_->get_last_stats()) {
+            record.travel += station.travel;
+        }
+    }
+    for (const auto& [rack, faces] : pending_) {
+        record.pending_tasks += faces.size();
+    }
+    ticks_.push_back(record);
+    Metrics::global().end_tick(record.tick);
+
+    if (config_.snapshot_every > 0 && record.tick % config_.snapshot_every == 0) {
+        write_snapshots(config_.snapshot_dir, "tick_" + std::to_string(record.tick) + "_");
+    }
+}
+
+void Simulation::collect_metrics() {
+    metrics_ = SimulationMetrics{};
+    metrics_.ticks = static_cast<int>(ticks_.size());
+    metrics_.orders = store_.get_orders().size();
+    metrics_.published = store_.num_published();
+    metrics_.open = store_.num_pending();
+
+    double lead_minutes = 0.0;
+    for (const Order& order : store_.get_orders()) {
+        switch (order.status) {
+            case OrderStatus::COMPLETED:
+                metrics_.completed++;
+                lead_minutes += std::chrono::duration<double, std::ratio<60>>(order.closure_date - order.creation_date).count();
+                break;
+            case OrderStatus::EXPIRED:
+                metrics_.expired++;
+                break;
+            case OrderStatus::STOCK_OUT:
+                metrics_.stock_out++;
+                break;
+            default:
+                break;
+        }
+    }
+    if (metrics_.completed > 0) {
+        metrics_.mean_lead_minutes = lead_minutes / metrics_.completed;
+    }
+
+    for (const SimulationTick& record : ticks_) {
+        metrics_.rack_visits += record.racks;
+        metrics_.linear_rack_visits += record.linear_racks;
+        metrics_.travel += record.travel;
+        metrics_.solve_ms_total += record.solve_ms;
+        metrics_.solve_ms_max = std::max(metrics_.solve_ms_max, record.solve_ms);
+    }
+}
+
+void Simulation::write_snapshots(const std::string& output_dir, const std::string& prefix) const {
+    stock_.save_snapshot(output_dir + "/" + prefix + "stock.snap");
+    write_orders_snapshot(output_dir + "/" + prefix + "backlog.snap", store_.get_orders());
+}
+
+void Simulation::write_outputs(const std::string& output_dir) const {
+    nlohmann::json metrics = {
+        {"start_date", format_iso8601(config_.start_date)},
+        {"end_date", format_iso8601(config_.end_date)},
+        {"seed", config_.seed},
+        {"ticks", metrics_.ticks},
+        {"orders", metrics_.orders},
+        {"published", metrics_.published},
+        {"completed", metrics_.completed},
+        {"expired", metrics_.expired},
+        {"stock_out", metrics_.stock_out},
+        {"open", metrics_.open},
+        {"rack_visits", metrics_.rack_visits},
+        {"linear_rack_visits", metrics_.linear_rack_visits},
+        {"orders_per_rack_visit", metrics_.rack_visits > 0
+            ? static_cast<double>(metrics_.completed) / metrics_.rack_visits : 0.0},
+        {"mean_lead_minutes", metrics_.mean_lead_minutes},
+        {"stations", config_.stations},
+        {"travel", metrics_.travel}
+    };
+    std::ofstream metrics_file(output_dir + "/sim_metrics.json");
+    if (!metrics_file.is_open()) {
+        throw std::runtime_error("Could not open output file: " + output_dir + "/sim_metrics.json");
+    }
+    metrics_file << metrics.dump(2) << std::endl;
+
+    std::ofstream ticks_file(output_dir + "/sim_ticks.csv");
+    if (!ticks_file.is_open()) {
+        throw std::runtime_error("Could not open output file: " + output_dir + "/sim_ticks.csv");
+    }
+    ticks_file << "tick,date,trigger,backlog,capacity,assigned,racks,pending_tasks,cost,faces,linear_racks,units,travel\n";
+    for (const SimulationTick& record : ticks_) {
+        ticks_file << record.tick << ','
+                   << format_iso8601(record.date) << ','
+                   << to_string(record.trigger) << ','
+                   << record.backlog_size << ','
+                   << record.capacity << ','
+                   << record.assigned_orders << ','
+                   << record.racks << ','
+                   << record.pending_tasks << ','
+                   << record.cost << ','
+                   << record.faces << ','
+                   << record.linear_racks << ','
+                   << record.assigned_units << ','
+                   << record.travel << '\n';
+    }
+}
+
+}
@@ -0,0 +1,208 @@
+#include "station_manager.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+namespace SS {
+
+namespace {
+
+// Seeds of consecutive stations lie this far apart, a TaskManager advances its seed twice a tick
+constexpr int STATION_SEED_STRIDE = 1 << 20;
+
+// Share i of total split into n parts, the remainder goes to the first ones
+int share(int total, int n, int i) {
+    return total / n + (i < total % n ? 1 : 0);
+}
+
+int count_orders(const std::map<FaceIdx, std::vector<OrderIdx>>& faces) {
+    int orders = 0;
+    for (const auto& [face, face_orders] : faces) {
+        orders += static_cast<int>(face_orders.size());
+    }
+    return orders;
+}
+
+}
+
+StationLayout make_station_layout(int num_stations, int min_capacity, int max_capacity, int grid_columns) {
+    if (num_stations <= 0) {
+        throw std::invalid_argument("A station layout needs at least one station");
+    }
+    StationLayout layout;
+    layout.grid_columns = std::max(1, grid_columns);
+    for (int s = 0; s < num_stations; s++) {
+        StationConfig station;
+        station.min_capacity = share(min_capacity, num_stations, s);
+        station.max_capacity = share(max_capacity, num_stations, s);
+        station.max_pending = share(100, num_stations, s);
+        station.x = (s + 0.5) * layout.grid_columns / num_stations - 0.5;
+        station.y = -1.0;
+        layout.stations.push_back(station);
+    }
+    return layout;
+}
+
+StationManager::StationManager(const StationLayout& layout, int seed, size_t num_threads)
+    : layout_(layout) {
+    if (layout_.stations.empty()) {
+        throw std::invalid_argument("StationManager needs at least one station");
+    }
+    layout_.grid_columns = std::max(1, layout_.grid_columns);
+    for (size_t s = 0; s < layout_.stations.size(); s++) {
+        const StationConfig& station = layout_.stations[s];
+        stations_.emplace_back(seed + static_cast<int>(s) * STATION_SEED_STRIDE,
+                               station.min_capacity, station.max_capacity, station.max_pending);
+    }
+    capacity_.assign(stations_.size(), 0);
+    queues_.resize(stations_.size());
+    queued_units_.assign(stations_.size(), 0);
+    last_stats_.resize(stations_.size());
+
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    pool_ = std::make_unique<ThreadPool>(std::min(num_threads, stations_.size()));
+}
+
+double StationManager::travel(RackIdx rack, size_t station) const {
+    const StationConfig& config = layout_.stations[station];
+    const double x = static_cast<double>(rack % layout_.grid_columns);
+    const double y = static_cast<double>(rack / layout_.grid_columns);
+    return std::abs(x - config.x) + std::abs(y - config.y);
+}
+
+int StationManager::get_available_capacity() {
+    int total = 0;
+    for (size_t s = 0; s < stations_.size(); s++) {
+        capacity_[s] = stations_[s].get_available_capacity();
+        total += capacity_[s];
+    }
+    return total;
+}
+
+int StationManager::accrue_capacity(std::chrono::milliseconds elapsed) {
+    int total = 0;
+    for (size_t s = 0; s < stations_.size(); s++) {
+        capacity_[s] = stations_[s].accrue_capacity(elapsed);
+        total += capacity_[s];
+    }
+    return total;
+}
+
+int StationManager::count_units(RackIdx rack, const std::map<FaceIdx, std::vector<OrderIdx>>& faces) const {
+    int units = 0;
+    for (const auto& [face, orders] : faces) {
+        int face_units = static_cast<int>(orders.size());
+        if (face_units_) {
+            auto it = face_units_->find({rack, face});
+            if (it != face_units_->end()) {
+                face_units = it->second;
+            }
+        }
+        units += face_units;
+    }
+    return units;
+}
+
+std::vector<Taskpool> StationManager::assign(const Taskpool& taskpool) const {
+    const size_t num_stations = stations_.size();
+    std::vector<Taskpool> shares(num_stations);
+    std::vector<double> load(queued_units_.begin(), queued_units_.end());
+
+    // Racks still pending stay where they are, the others heaviest first
+    std::vector<std::pair<int, RackIdx>> racks;
+    for (const auto& [rack, faces] : taskpool) {
+        const int units = count_units(rack, faces);
+        auto queued = std::find_if(queues_.begin(), queues_.end(),
+                                   [rack = rack](const Taskpool& queue) { return queue.count(rack) > 0; });
+        if (queued != queues_.end()) {
+            const size_t s = static_cast<size_t>(queued - queues_.begin());
+            shares[s][rack] = faces;
+            load[s] += units;
+        } else {
+            racks.push_back({units, rack});
+        }
+    }
+    std::sort(racks.begin(), racks.end(), [](const auto& a, const auto& b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+
+    for (const auto& [units, rack] : racks) {
+        // Best station with room, or the one with the most room when none has any
+        size_t best = num_stations;
+        double best_score = std::numeric_limits<double>::max();
+        size_t roomiest = 0;
+        for (size_t s = 0; s < num_stations; s++) {
+            if (capacity_[s] - load[s] > capacity_[roomiest] - load[roomiest]) {
+                roomiest = s;
+            }
+            if (load[s] + units > capacity_[s]) {
+                continue;
+            }
+            const double score = travel(rack, s)
+                + layout_.balance_weight * (load[s] + units) / std::max(1, capacity_[s]);
+            if (score < best_score) {
+                best_score = score;
+                best = s;
+            }
+        }
+        if (best == num_stations) {
+            best = roomiest;
+        }
+        shares[best][rack] = taskpool.at(rack);
+        load[best] += units;
+    }
+    return shares;
+}
+
+Taskpool StationManager::process_tasks(const Taskpool& taskpool) {
+    std::vector<Taskpool> shares = assign(taskpool);
+
+    for (size_t s = 0; s < stations_.size(); s++) {
+        StationStats& stats = last_stats_[s];
+        stats = StationStats{};
+        stats.capacity = capacity_[s];
+        stats.queued_units = queued_units_[s];
+        stats.racks = static_cast<int>(shares[s].size());
+        for (const auto& [rack, faces] : shares[s]) {
+            stats.orders += count_orders(faces);
+            stats.units += count_units(rack, faces);
+            if (queues_[s].count(rack) == 0) {
+                stats.travel += travel(rack, s);
+            }
+        }
+        stats.overflow = stats.queued_units + stats.units > stats.capacity;
+    }
+
+    // Every station draws from its own generator, so the order they run in does not matter
+    // An empty tick only advances the seeds, not worth a trip through the pool
+    auto process = [&](size_t s) {
+        queues_[s] = stations_[s].process_tasks(shares[s]);
+    };
+    if (taskpool.empty()) {
+        for (size_t s = 0; s < stations_.size(); s++) {
+            process(s);
+        }
+    } else {
+        pool_->parallel_for(stations_.size(), process);
+    }
+
+    // Queued units are counted now, the face units belong to this taskpool
+    Taskpool pending;
+    for (size_t s = 0; s < stations_.size(); s++) {
+        queued_units_[s] = 0;
+        for (const auto& [rack, faces] : queues_[s]) {
+            queued_units_[s] += count_units(rack, faces);
+            last_stats_[s].pending_tasks += static_cast<int>(faces.size());
+            for (const auto& [face, orders] : faces) {
+                pending[rack][face] = orders;
+            }
+        }
+    }
+    return pending;
+}
+
+}
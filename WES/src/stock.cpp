@@ -1,32 +1,187 @@
 #include "stock.h"
 #include <fstream>
 #include <stdexcept>
+#include <algorithm>
 #include <nlohmann/json.hpp>
+#include "snapshot.h"
+#ifdef SS_WITH_SIMDJSON
+#include <simdjson.h>
+#endif
 
 namespace SS {
 
-StockManager::StockManager(const std::string& stock_file_path) 
-    : stock_file_path_(stock_file_path) {
-    load_stock();
-    stock_out_items_ = std::vector<ItemID>();
-    racks_ = std::set<RackID>();
+struct StockManager::Staging {
+    // IDs in the order the file lists them
+    struct Names {
+        SymbolTable table;
+
+        // Position of every ID once sorted by name
+        std::vector<uint32_t> ranks() const {
+            std::vector<uint32_t> by_name(table.size());
+            for (uint32_t i = 0; i < by_name.size(); i++) {
+                by_name[i] = i;
+            }
+            std::sort(by_name.begin(), by_name.end(), [this](uint32_t a, uint32_t b) {
+                return table.name(a) < table.name(b);
+            });
+            std::vector<uint32_t> rank(by_name.size());
+            for (uint32_t position = 0; position < by_name.size(); position++) {
+                rank[by_name[position]] = position;
+            }
+            return rank;
+        }
+    };
+
+    // A rack (face == INVALID_IDX), a face (item == INVALID_IDX) or an item quantity
+    struct Row {
+        uint32_t rack;
+        uint32_t face;
+        uint32_t item;
+        int quantity;
+    };
 
-    for (const auto& [rack_id, _] : inventory_) {
-        racks_.insert(rack_id);
+    Names racks;
+    Names faces;
+    SymbolTable items;
+    std::vector<Row> rows;
+    uint32_t rack = INVALID_IDX;
+    uint32_t face = INVALID_IDX;
+
+    void add_rack(const std::string& name) {
+        rack = racks.table.intern(name);
+        face = INVALID_IDX;
+        rows.push_back({rack, INVALID_IDX, INVALID_IDX, 0});
     }
 
-    faces_ = std::set<FaceID>{"Cara_1", "Cara_2", "Cara_3", "Cara_4"};
+    void add_face(const std::string& name) {
+        face = faces.table.intern(name);
+        rows.push_back({rack, face, INVALID_IDX, 0});
+    }
 
-    is_rack_hot_ = std::map<RackID, bool>();
-    is_rack_warm_ = std::map<RackID, bool>();
-    // Initialize rack status maps as false
-    for (const auto& rack_id : racks_) {
-        is_rack_hot_[rack_id] = false;
-        is_rack_warm_[rack_id] = false;
+    void add_item(const std::string& name, int quantity) {
+        rows.push_back({rack, face, items.intern(name), quantity});
     }
+};
+
+namespace {
+
+/**
+ * @brief nlohmann SAX handler for {rack: {face: [{"Inventory ID", "Cantidad"}, ...]}}
+ * Depth 1 is the root object, 2 a rack, 3 a face array, 4 an item
+ */
+template <typename Staging>
+class StockSaxHandler {
+public:
+    StockSaxHandler(Staging& staging, const std::string& file_path)
+        : staging_(staging), file_path_(file_path) {}
+
+    bool null() { return true; }
+    bool boolean(bool) { return true; }
+    bool number_integer(nlohmann::json::number_integer_t value) { return number(value); }
+    bool number_unsigned(nlohmann::json::number_unsigned_t value) { return number(static_cast<long long>(value)); }
+    bool number_float(nlohmann::json::number_float_t, const std::string&) { return true; }
+    bool binary(nlohmann::json::binary_t&) { return true; }
+
+    bool string(std::string& value) {
+        if (depth_ == 4 && key_ == "Inventory ID") {
+            item_id_ = std::move(value);
+            seen_ |= 1;
+        }
+        return true;
+    }
+
+    bool key(std::string& key) {
+        if (depth_ == 1) {
+            staging_.add_rack(key);
+        } else if (depth_ == 2) {
+            staging_.add_face(key);
+        } else if (depth_ == 4) {
+            key_ = std::move(key);
+        }
+        return true;
+    }
+
+    bool start_object(std::size_t) {
+        depth_++;
+        seen_ = 0;
+        return true;
+    }
+
+    bool end_object() {
+        if (depth_ == 4) {
+            if (seen_ != 3) {
+                throw std::runtime_error("Incomplete item in stock file: " + file_path_);
+            }
+            staging_.add_item(item_id_, quantity_);
+        }
+        depth_--;
+        return true;
+    }
+
+    bool start_array(std::size_t) {
+        depth_++;
+        return true;
+    }
+
+    bool end_array() {
+        depth_--;
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex) {
+        throw std::runtime_error("Could not parse stock file " + file_path_ + ": " + ex.what());
+    }
+
+private:
+    bool number(long long value) {
+        if (depth_ == 4 && key_ == "Cantidad") {
+            quantity_ = static_cast<int>(value);
+            seen_ |= 2;
+        }
+        return true;
+    }
+
+    Staging& staging_;
+    const std::string& file_path_;
+    std::string key_;
+    std::string item_id_;
+    int quantity_ = 0;
+    unsigned seen_ = 0;
+    int depth_ = 0;
+};
+
+}
+
+StockManager::StockManager(const std::string& stock_file_path, StockBackend backend, JsonParser parser) 
+    : backend_(backend), parser_(parser), stock_file_path_(stock_file_path) {
+    // Faces are interned first so that Cara_1..Cara_4 get indices 0..3
+    for (const auto& face_id : {"Cara_1", "Cara_2", "Cara_3", "Cara_4"}) {
+        face_ids_.intern(face_id);
+    }
+
+    load_stock();
 }
 
 void StockManager::load_stock() {
+    if (is_snapshot(stock_file_path_)) {
+        load_snapshot();
+        return;
+    }
+    if (!has_json_parser(parser_)) {
+        throw std::runtime_error(std::string("Error: json parser ") + to_string(parser_)
+                                 + " is not available in this build.");
+    }
+    if (parser_ != JsonParser::DOM) {
+        Staging staging;
+        if (parser_ == JsonParser::SIMD) {
+            load_stock_simd(staging);
+        } else {
+            load_stock_sax(staging);
+        }
+        process_staging(staging);
+        return;
+    }
+
     std::ifstream file(stock_file_path_);
     
     if (!file.is_open()) {
@@ -39,6 +194,64 @@ void StockManager::load_stock() {
     process_stock_json(json_data);
 }
 
+void StockManager::load_stock_sax(Staging& staging) const {
+    std::ifstream file(stock_file_path_, std::ios::binary);
+    
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open stock file: " + stock_file_path_);
+    }
+
+    StockSaxHandler<Staging> handler(staging, stock_file_path_);
+    nlohmann::json::sax_parse(file, &handler);
+}
+
+void StockManager::load_stock_simd(Staging& staging) const {
+#ifdef SS_WITH_SIMDJSON
+    simdjson::padded_string json;
+    if (simdjson::padded_string::load(stock_file_path_).get(json)) {
+        throw std::runtime_error("Could not open stock file: " + stock_file_path_);
+    }
+
+    try {
+        simdjson::ondemand::parser parser;
+        simdjson::ondemand::document doc = parser.iterate(json);
+        for (auto rack_field : doc.get_object()) {
+            staging.add_rack(std::string(std::string_view(rack_field.unescaped_key())));
+            for (auto face_field : rack_field.value().get_object()) {
+                staging.add_face(std::string(std::string_view(face_field.unescaped_key())));
+                simdjson::ondemand::value face_data = face_field.value();
+                if (face_data.type() != simdjson::ondemand::json_type::array) {
+                    continue;
+                }
+                for (simdjson::ondemand::object item_json : face_data.get_array()) {
+                    std::string item_id;
+                    int quantity = 0;
+                    unsigned seen = 0;
+                    for (auto field : item_json) {
+                        std::string_view key = field.unescaped_key();
+                        if (key == "Inventory ID") {
+                            item_id = std::string_view(field.value().get_string());
+                            seen |= 1;
+                        } else if (key == "Cantidad") {
+                            quantity = static_cast<int>(int64_t(field.value().get_int64()));
+                            seen |= 2;
+                        }
+                    }
+                    if (seen != 3) {
+                        throw std::runtime_error("Incomplete item in stock file: " + stock_file_path_);
+                    }
+                    staging.add_item(item_id, quantity);
+                }
+            }
+        }
+    } catch (const simdjson::simdjson_error& e) {
+        throw std::runtime_error("Could not parse stock file " + stock_file_path_ + ": " + e.what());
+    }
+#else
+    (void)staging;
+#endif
+}
+
 void StockManager::process_stock_json(const nlohmann::json& json_data) {
     // Clear existing data
     inventory_.clear();
@@ -46,63 +259,388 @@ void StockManager::process_stock_json(const nlohmann::json& json_data) {
     
     // Iterate through racks (top level keys)
     for (auto& [rack_id, rack_data] : json_data.items()) {
-        inventory_[rack_id] = std::map<FaceID, std::map<ItemID, int>>();
+        RackIdx rack = rack_ids_.intern(rack_id);
+        auto& rack_inventory = inventory_[rack];
         
         // Iterate through faces
         for (auto& [face_id, face_data] : rack_data.items()) {
-            inventory_[rack_id][face_id] = std::map<ItemID, int>();
+            auto& face_inventory = rack_inventory[face_ids_.intern(face_id)];
             
             // Check if face_data is an array (not null/empty)
             if (face_data.is_array()) {
                 // Process each item in the face
-                for (const auto& item : face_data) {
-                    std::string item_id = item["Inventory ID"].get<std::string>();
-                    int cantidad = item["Cantidad"].get<int>();
+                for (const auto& item_json : face_data) {
+                    ItemIdx item = item_ids_.intern(item_json["Inventory ID"].get<std::string>());
+                    int cantidad = item_json["Cantidad"].get<int>();
                     
                     // Aggregate quantities for same item (group by Inventory ID)
-                    if (inventory_[rack_id][face_id].find(item_id) == inventory_[rack_id][face_id].end()) {
-                        inventory_[rack_id][face_id][item_id] = 0;
-                    }
-                    inventory_[rack_id][face_id][item_id] += cantidad;
+                    face_inventory[item] += cantidad;
                     
                     // Update total quantity for this item
-                    if (items_quantity_.find(item_id) == items_quantity_.end()) {
-                        items_quantity_[item_id] = 0;
+                    if (items_quantity_.size() <= item) {
+                        items_quantity_.resize(item + 1, 0);
                     }
-                    items_quantity_[item_id] += cantidad;
+                    items_quantity_[item] += cantidad;
                 }
             }
         }
     }
+    finish_load();
 }
 
-int StockManager::get_item_quantity(const RackID& rack_id, const FaceID& face_id, const ItemID& item_id) const {
-    try {
-        return inventory_.at(rack_id).at(face_id).at(item_id);
-    } catch (const std::out_of_range&) {
+void StockManager::process_staging(const Staging& staging) {
+    inventory_.clear();
+    items_quantity_.clear();
+
+    // nlohmann objects iterate keys sorted, so the DOM walk interns racks and faces in name
+    // order and items as they come within that order. Replay the rows the same way
+    std::vector<uint32_t> rack_rank = staging.racks.ranks();
+    std::vector<uint32_t> face_rank = staging.faces.ranks();
+    std::vector<size_t> order(staging.rows.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        const Staging::Row& row_a = staging.rows[a];
+        const Staging::Row& row_b = staging.rows[b];
+        if (row_a.rack != row_b.rack) {
+            return rack_rank[row_a.rack] < rack_rank[row_b.rack];
+        }
+        // The rack marker row (no face) goes first
+        if (row_a.face == INVALID_IDX || row_b.face == INVALID_IDX) {
+            return row_a.face == INVALID_IDX && row_b.face != INVALID_IDX;
+        }
+        return face_rank[row_a.face] < face_rank[row_b.face];
+    });
+
+    for (size_t i : order) {
+        const Staging::Row& row = staging.rows[i];
+        auto& rack_inventory = inventory_[rack_ids_.intern(staging.racks.table.name(row.rack))];
+        if (row.face == INVALID_IDX) {
+            continue;
+        }
+        auto& face_inventory = rack_inventory[face_ids_.intern(staging.faces.table.name(row.face))];
+        if (row.item == INVALID_IDX) {
+            continue;
+        }
+        ItemIdx item = item_ids_.intern(staging.items.name(row.item));
+
+        // Aggregate quantities for same item (group by Inventory ID)
+        face_inventory[item] += row.quantity;
+        if (items_quantity_.size() <= item) {
+            items_quantity_.resize(item + 1, 0);
+        }
+        items_quantity_[item] += row.quantity;
+    }
+    finish_load();
+}
+
+void StockManager::finish_load() {
+    items_quantity_.resize(item_ids_.size(), 0);
+    item_versions_.assign(item_ids_.size(), 0);
+
+    build_item_locations();
+    stock_out_items_.clear();
+
+    // Initialize rack status flags as false
+    is_rack_hot_.assign(num_racks(), false);
+    is_rack_warm_.assign(num_racks(), false);
+
+    if (backend_ == StockBackend::FLAT) {
+        // The nested map is only a staging area for the columnar store
+        flat_.build(inventory_, num_racks(), num_faces());
+        inventory_.clear();
+    }
+}
+
+namespace {
+
+// Stock snapshot sections, string tables take two ids
+enum StockSection : uint32_t {
+    RACK_IDS = 1,
+    FACE_IDS = 3,
+    ITEM_IDS = 5,
+    SLOT_OFFSETS = 7,
+    SLOT_ITEMS = 8,
+    SLOT_QUANTITIES = 9,
+    ITEM_TOTALS = 10,
+    ITEM_VERSIONS = 11,
+    LOCATION_OFFSETS = 12,
+    LOCATIONS = 13,
+    STOCK_OUT_ITEMS = 14,
+    RACK_FLAGS = 15,
+    WARM_RACKS = 16
+};
+
+constexpr uint8_t RACK_HOT = 1;
+constexpr uint8_t RACK_WARM = 2;
+
+void intern_all(SymbolTable& table, const SnapshotStrings& names) {
+    table = SymbolTable();
+    table.reserve(names.size());
+    for (size_t i = 0; i < names.size(); i++) {
+        table.intern(std::string(names[i]));
+    }
+}
+
+void check_snapshot(bool ok, const std::string& path, const char* what) {
+    if (!ok) {
+        throw std::runtime_error(std::string("Corrupt stock snapshot (") + what + "): " + path);
+    }
+}
+
+}
+
+void StockManager::save_snapshot(const std::string& file_path) const {
+    // The MAP backend is written in the FLAT layout too
+    FlatStock map_flat;
+    const FlatStock* flat = &flat_;
+    if (backend_ == StockBackend::MAP) {
+        map_flat.build(inventory_, num_racks(), num_faces());
+        flat = &map_flat;
+    }
+
+    // The inverted index keeps its current order, so set_item_quantity swaps the same entries after a reload
+    std::vector<uint32_t> location_offsets;
+    std::vector<StockLocation> locations;
+    location_offsets.reserve(item_locations_.size() + 1);
+    location_offsets.push_back(0);
+    for (const auto& item_locations : item_locations_) {
+        locations.insert(locations.end(), item_locations.begin(), item_locations.end());
+        location_offsets.push_back(static_cast<uint32_t>(locations.size()));
+    }
+
+    std::vector<uint8_t> rack_flags(num_racks(), 0);
+    for (RackIdx rack = 0; rack < num_racks(); rack++) {
+        if (rack < is_rack_hot_.size() && is_rack_hot_[rack]) {
+            rack_flags[rack] |= RACK_HOT;
+        }
+        if (rack < is_rack_warm_.size() && is_rack_warm_[rack]) {
+            rack_flags[rack] |= RACK_WARM;
+        }
+    }
+
+    SnapshotWriter writer(SnapshotKind::STOCK);
+    writer.add_strings(RACK_IDS, rack_ids_.names());
+    writer.add_strings(FACE_IDS, face_ids_.names());
+    writer.add_strings(ITEM_IDS, item_ids_.names());
+    writer.add(SLOT_OFFSETS, flat->offsets());
+    writer.add(SLOT_ITEMS, flat->items());
+    writer.add(SLOT_QUANTITIES, flat->quantities());
+    writer.add(ITEM_TOTALS, items_quantity_);
+    writer.add(ITEM_VERSIONS, item_versions_);
+    writer.add(LOCATION_OFFSETS, location_offsets);
+    writer.add(LOCATIONS, locations);
+    writer.add(STOCK_OUT_ITEMS, stock_out_items_);
+    writer.add(RACK_FLAGS, rack_flags);
+    writer.add(WARM_RACKS, std::vector<RackIdx>(warm_racks_.begin(), warm_racks_.end()));
+    writer.write(file_path);
+}
+
+void StockManager::load_snapshot() {
+    SnapshotReader snapshot(stock_file_path_, SnapshotKind::STOCK);
+
+    // Names are the only part that has to be rebuilt, the arrays are copied as they are
+    intern_all(rack_ids_, snapshot.strings(RACK_IDS));
+    intern_all(face_ids_, snapshot.strings(FACE_IDS));
+    intern_all(item_ids_, snapshot.strings(ITEM_IDS));
+    const size_t num_items = item_ids_.size();
+
+    SnapshotArray<uint32_t> offsets = snapshot.get<uint32_t>(SLOT_OFFSETS);
+    SnapshotArray<ItemIdx> items = snapshot.get<ItemIdx>(SLOT_ITEMS);
+    SnapshotArray<int32_t> quantities = snapshot.get<int32_t>(SLOT_QUANTITIES);
+    const size_t num_slots = num_racks() * num_faces();
+    check_snapshot(offsets.size == num_slots + 1 && offsets[num_slots] == items.size
+                   && items.size == quantities.size, stock_file_path_, "slots");
+    for (size_t slot = 0; slot < num_slots; slot++) {
+        check_snapshot(offsets[slot] <= offsets[slot + 1], stock_file_path_, "slots");
+    }
+    for (ItemIdx item : items) {
+        check_snapshot(item < num_items, stock_file_path_, "slot items");
+    }
+
+    inventory_.clear();
+    if (backend_ == StockBackend::FLAT) {
+        flat_.assign(num_faces(), offsets.to_vector(), items.to_vector(), quantities.to_vector());
+    } else {
+        flat_ = FlatStock();
+        for (RackIdx rack = 0; rack < num_racks(); rack++) {
+            for (FaceIdx face = 0; face < num_faces(); face++) {
+                const size_t slot = static_cast<size_t>(rack) * num_faces() + face;
+                for (uint32_t pos = offsets[slot]; pos < offsets[slot + 1]; pos++) {
+                    inventory_[rack][face][items[pos]] = quantities[pos];
+                }
+            }
+        }
+    }
+
+    items_quantity_ = snapshot.get<int>(ITEM_TOTALS).to_vector();
+    item_versions_ = snapshot.get<uint32_t>(ITEM_VERSIONS).to_vector();
+    check_snapshot(items_quantity_.size() == num_items && item_versions_.size() == num_items,
+                   stock_file_path_, "item totals");
+
+    SnapshotArray<uint32_t> location_offsets = snapshot.get<uint32_t>(LOCATION_OFFSETS);
+    SnapshotArray<StockLocation> locations = snapshot.get<StockLocation>(LOCATIONS);
+    check_snapshot(location_offsets.size == num_items + 1 && location_offsets[num_items] == locations.size,
+                   stock_file_path_, "item locations");
+    item_locations_.assign(num_items, {});
+    for (ItemIdx item = 0; item < num_items; item++) {
+        check_snapshot(location_offsets[item] <= location_offsets[item + 1], stock_file_path_, "item locations");
+        item_locations_[item].assign(locations.begin() + location_offsets[item],
+                                     locations.begin() + location_offsets[item + 1]);
+    }
+
+    stock_out_items_ = snapshot.get<ItemIdx>(STOCK_OUT_ITEMS).to_vector();
+    SnapshotArray<uint8_t> rack_flags = snapshot.get<uint8_t>(RACK_FLAGS);
+    check_snapshot(rack_flags.size == num_racks(), stock_file_path_, "rack flags");
+    is_rack_hot_.assign(num_racks(), false);
+    is_rack_warm_.assign(num_racks(), false);
+    for (RackIdx rack = 0; rack < num_racks(); rack++) {
+        is_rack_hot_[rack] = (rack_flags[rack] & RACK_HOT) != 0;
+        is_rack_warm_[rack] = (rack_flags[rack] & RACK_WARM) != 0;
+    }
+    SnapshotArray<RackIdx> warm_racks = snapshot.get<RackIdx>(WARM_RACKS);
+    for (RackIdx rack : warm_racks) {
+        check_snapshot(rack < num_racks(), stock_file_path_, "warm racks");
+    }
+    warm_racks_.assign(warm_racks.begin(), warm_racks.end());
+}
+
+void StockManager::build_item_locations() {
+    item_locations_.assign(item_ids_.size(), {});
+    for (const auto& [rack, faces] : inventory_) {
+        for (const auto& [face, items] : faces) {
+            for (const auto& [item, quantity] : items) {
+                if (quantity > 0) {
+                    item_locations_[item].push_back({rack, face, quantity});
+                }
+            }
+        }
+    }
+}
+
+int StockManager::get_item_quantity(RackIdx rack, FaceIdx face, ItemIdx item) const {
+    if (backend_ == StockBackend::FLAT) {
+        return flat_.get(rack, face, item);
+    }
+
+    auto rack_it = inventory_.find(rack);
+    if (rack_it == inventory_.end()) {
         return 0; // Return 0 if not found
     }
+    auto face_it = rack_it->second.find(face);
+    if (face_it == rack_it->second.end()) {
+        return 0;
+    }
+    auto item_it = face_it->second.find(item);
+    if (item_it == face_it->second.end()) {
+        return 0;
+    }
+    return item_it->second;
 }
 
-void StockManager::set_item_quantity(const RackID& rack_id, const FaceID& face_id, const ItemID& item_id, int quantity) {
+void StockManager::set_item_quantity(RackIdx rack, FaceIdx face, ItemIdx item, int quantity) {
+    if (item >= item_ids_.size()) {
+        throw std::out_of_range("Unknown item index: " + std::to_string(item));
+    }
+
     // Update the inventory
-    inventory_[rack_id][face_id][item_id] += quantity;
+    int location_quantity;
+    if (backend_ == StockBackend::FLAT) {
+        location_quantity = flat_.add(rack, face, item, quantity);
+    } else {
+        location_quantity = (inventory_[rack][face][item] += quantity);
+    }
     
+    item_versions_[item]++;
+
     // Update total quantity
-    items_quantity_[item_id] += quantity;
+    const int previous_total = items_quantity_[item];
+    items_quantity_[item] += quantity;
 
-    if (items_quantity_[item_id] <= 0) {
-        // If total quantity is zero or negative, mark as stock out
-        stock_out_items_.push_back(item_id);
+    // Keep the inverted index in sync, it only holds locations with positive quantity
+    auto& locations = item_locations_[item];
+    auto it = std::find_if(locations.begin(), locations.end(), [&](const StockLocation& location) {
+        return location.rack == rack && location.face == face;
+    });
+    if (it != locations.end()) {
+        if (location_quantity > 0) {
+            it->quantity = location_quantity;
+        } else {
+            *it = locations.back();
+            locations.pop_back();
+        }
+    } else if (location_quantity > 0) {
+        locations.push_back({rack, face, location_quantity});
+    }
+
+    if (previous_total > 0 && items_quantity_[item] <= 0) {
+        // If total quantity drops to zero or below, mark as stock out
+        stock_out_items_.push_back(item);
     }
 }
 
-int StockManager::get_total_quantity(const ItemID& item_id) const {
-    auto it = items_quantity_.find(item_id);
-    if (it != items_quantity_.end()) {
-        return it->second;
+int StockManager::get_total_quantity(ItemIdx item) const {
+    if (item < items_quantity_.size()) {
+        return items_quantity_[item];
     }
     return 0;
 }
 
-} // namespace SS
\ No newline at end of file
+void StockManager::get_rack_items(RackIdx rack, std::vector<ItemIdx>& items) const {
+    if (backend_ == StockBackend::FLAT) {
+        for (FaceIdx face = 0; face < num_faces(); face++) {
+            const size_t slot = flat_.slot(rack, face);
+            for (uint32_t pos = flat_.slot_begin(slot); pos < flat_.slot_end(slot); pos++) {
+                if (flat_.quantities()[pos] > 0) {
+                    items.push_back(flat_.items()[pos]);
+                }
+            }
+        }
+        return;
+    }
+
+    auto rack_it = inventory_.find(rack);
+    if (rack_it == inventory_.end()) {
+        return;
+    }
+    for (const auto& [face, face_items] : rack_it->second) {
+        for (const auto& [item, quantity] : face_items) {
+            if (quantity > 0) {
+                items.push_back(item);
+            }
+        }
+    }
+}
+
+size_t StockManager::memory_usage() const {
+    // std::map nodes carry three pointers and a color on top of the value
+    constexpr size_t map_node_overhead = 4 * sizeof(void*);
+
+    size_t bytes = flat_.memory_bytes();
+    for (const auto& [rack, faces] : inventory_) {
+        bytes += map_node_overhead + sizeof(rack) + sizeof(faces);
+        for (const auto& [face, items] : faces) {
+            bytes += map_node_overhead + sizeof(face) + sizeof(items);
+            bytes += items.size() * (map_node_overhead + sizeof(ItemIdx) + sizeof(int));
+        }
+    }
+
+    bytes += items_quantity_.capacity() * sizeof(int);
+    bytes += item_locations_.capacity() * sizeof(std::vector<StockLocation>);
+    for (const auto& locations : item_locations_) {
+        bytes += locations.capacity() * sizeof(StockLocation);
+    }
+    bytes += (is_rack_hot_.capacity() + is_rack_warm_.capacity()) / 8;
+    return bytes;
+}
+
+const std::vector<StockLocation>& StockManager::get_item_locations(ItemIdx item) const {
+    static const std::vector<StockLocation> no_locations;
+    if (item < item_locations_.size()) {
+        return item_locations_[item];
+    }
+    return no_locations;
+}
+
+} // namespace SS
@@ -5,9 +5,9 @@
 
 namespace SS {
 
-TaskManager::TaskManager(int seed) : seed_(seed) {
-    dist1 = std::uniform_int_distribution<int>(0, 100);
-    dist2 = std::uniform_int_distribution<int>(1000, 2000);
+TaskManager::TaskManager(int seed, int min_capacity, int max_capacity, int max_pending) : seed_(seed) {
+    dist1 = std::uniform_int_distribution<int>(0, max_pending);
+    dist2 = std::uniform_int_distribution<int>(min_capacity, max_capacity);
 }
 
 Taskpool TaskManager::process_tasks(const Taskpool& taskpool) {
@@ -15,7 +15,7 @@ Taskpool TaskManager::process_tasks(const Taskpool& taskpool) {
      * Processes the tasks selected by the Shelf Selector and returns pending tasks.
      * In practice, this procedure is not instantaneous.
      * 
-     * Randomly selects K tasks (where K is random from 0-100) to be marked as pending
+     * Randomly selects K tasks (where K is random from 0-max_pending) to be marked as pending
      * (tasks that could not be executed)
      */
     
@@ -26,11 +26,11 @@ Taskpool TaskManager::process_tasks(const Taskpool& taskpool) {
     // Generate random K (number of pending tasks)
     int K = dist1(rng);
     
-    // Collect all keys (rack_id, face_id pairs) from taskpool
-    std::vector<std::pair<RackID, FaceID>> keys;
-    for (const auto& [rack_id, faces] : taskpool) {
-        for (const auto& [face_id, orders] : faces) {
-            keys.push_back({rack_id, face_id});
+    // Collect all keys (rack, face pairs) from taskpool
+    std::vector<std::pair<RackIdx, FaceIdx>> keys;
+    for (const auto& [rack, faces] : taskpool) {
+        for (const auto& [face, orders] : faces) {
+            keys.push_back({rack, face});
         }
     }
     
@@ -43,8 +43,8 @@ Taskpool TaskManager::process_tasks(const Taskpool& taskpool) {
     // Build pending taskpool with the first num_pending keys
     Taskpool pending_taskpool;
     for (int i = 0; i < num_pending; i++) {
-        const auto& [rack_id, face_id] = keys[i];
-        pending_taskpool[rack_id][face_id] = taskpool.at(rack_id).at(face_id);
+        const auto& [rack, face] = keys[i];
+        pending_taskpool[rack][face] = taskpool.at(rack).at(face);
     }
     
     return pending_taskpool;
@@ -55,4 +55,12 @@ int TaskManager::get_available_capacity() {
     seed_ += 1; // Update seed for next call
     return dist2(rng);
 }
+
+int TaskManager::accrue_capacity(std::chrono::milliseconds elapsed) {
+    const double share = std::clamp(std::chrono::duration<double>(elapsed) / CAPACITY_PERIOD, 0.0, 1.0);
+    const double units = get_available_capacity() * share + carry_;
+    const int capacity = static_cast<int>(units);
+    carry_ = units - capacity;
+    return capacity;
+}
 } // namespace SS
@@ -0,0 +1,152 @@
+#include "tick_pipeline.h"
+#include "metrics.h"
+#include <algorithm>
+#include <chrono>
+
+namespace SS {
+
+namespace {
+
+double elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+TickPipeline::TickPipeline(DBConnector& db_connector, OrderManager& order_manager, ShelfSelection& shelf_selection,
+                           TaskExecutor& task_manager, size_t queue_capacity)
+    : db_connector_(db_connector),
+      order_manager_(order_manager),
+      shelf_selection_(shelf_selection),
+      task_manager_(task_manager),
+      queue_(queue_capacity) {
+    writer_ = std::thread([this]() { write_loop(); });
+}
+
+TickPipeline::~TickPipeline() {
+    queue_.close();
+    writer_.join();
+}
+
+const TickStats& TickPipeline::tick(const TimePoint& simulation_date) {
+    rethrow_write_error();
+    TickStats stats;
+    stats.tick = last_stats_.tick + 1;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<Order> backlog;
+    {
+        DBConnector::Lease conn = db_connector_.acquire();
+        backlog = order_manager_.get_backlog_from_db(*conn, simulation_date);
+    }
+    stats.backlog_size = backlog.size();
+    stats.fetch_ms = elapsed_ms(start);
+
+    start = std::chrono::steady_clock::now();
+    // Capacity accrues with simulated time, the first tick gets a full period
+    const std::chrono::milliseconds since_last = stats.tick == 1 ? std::chrono::milliseconds(CAPACITY_PERIOD)
+        : std::chrono::duration_cast<std::chrono::milliseconds>(simulation_date - last_date_);
+    int N = task_manager_.accrue_capacity(since_last);
+    Taskpool taskpool = shelf_selection_.run(backlog, pending_, N);
+    stats.assigned_orders = shelf_selection_.get_last_stats().assigned_orders;
+    stats.solve_ms = elapsed_ms(start);
+
+    // Drop the tick's orders from the cache now, their UPDATE may still be queued
+    WriteBack job{stats.tick, simulation_date,
+                  order_manager_.take_completed_orders(taskpool),
+                  order_manager_.take_stock_out_items(),
+                  order_manager_.take_stock_out_orders(),
+                  order_manager_.get_zone(),
+                  order_manager_.take_unrouted_orders(),
+                  zone_reporter_ ? zone_reporter_->take_report(stats.tick, N, backlog, taskpool) : ZoneReport{}};
+
+    start = std::chrono::steady_clock::now();
+    {
+        // Timed here, a StationManager runs one TaskManager per station
+        ScopedTimer timer(Stage::PROCESS_TASKS);
+        pending_ = task_manager_.process_tasks(taskpool);
+    }
+    stats.tasks_ms = elapsed_ms(start);
+
+    start = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        outstanding_++;
+    }
+    queue_.push(std::move(job));
+    stats.enqueue_ms = elapsed_ms(start);
+    stats.queue_depth = queue_.size();
+    max_queue_depth_ = std::max(max_queue_depth_, stats.queue_depth);
+    stats.max_queue_depth = max_queue_depth_;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats.written_tick = written_tick_;
+        stats.write_ms = write_ms_;
+    }
+    Metrics::global().set(Gauge::QUEUE_DEPTH, static_cast<long long>(stats.queue_depth));
+    Metrics::global().end_tick(stats.tick);
+
+    last_date_ = simulation_date;
+    last_stats_ = stats;
+    return last_stats_;
+}
+
+void TickPipeline::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_cv_.wait(lock, [this]() { return outstanding_ == 0; });
+    lock.unlock();
+    rethrow_write_error();
+}
+
+void TickPipeline::write_loop() {
+    while (std::optional<WriteBack> job = queue_.pop()) {
+        bool failed;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            failed = write_error_ != nullptr;
+        }
+        // After a failure the remaining jobs are dropped, the plan stage rethrows on its next call
+        if (!failed) {
+            auto start = std::chrono::steady_clock::now();
+            try {
+                write(*job);
+                std::lock_guard<std::mutex> lock(mutex_);
+                written_tick_ = job->tick;
+                write_ms_ = elapsed_ms(start);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                write_error_ = std::current_exception();
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            outstanding_--;
+        }
+        idle_cv_.notify_all();
+    }
+}
+
+void TickPipeline::write(const WriteBack& job) {
+    // Same order as the sequential loop: expire, complete, stock out
+    ScopedTimer timer(Stage::WRITE_BACK);
+    DBConnector::Lease conn = db_connector_.acquire();
+    pqxx::work txn(*conn);
+    OrderManager::write_expired_orders(txn, job.simulation_date);
+    OrderManager::write_completed_orders(txn, job.completed);
+    OrderManager::write_stock_out_orders(txn, job.stock_out, job.zone);
+    OrderManager::write_stock_out_order_ids(txn, job.stock_out_orders);
+    OrderManager::write_unrouted_orders(txn, job.unrouted);
+    if (zone_reporter_) {
+        ZoneReporter::write_report(txn, job.report);
+    }
+    txn.commit();
+}
+
+void TickPipeline::rethrow_write_error() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (write_error_) {
+        std::rethrow_exception(write_error_);
+    }
+}
+
+}
@@ -0,0 +1,17 @@
+#include "trigger_policy.h"
+
+namespace SS {
+
+const char* to_string(Trigger trigger) {
+    switch (trigger) {
+        case Trigger::COUNT:
+            return "count";
+        case Trigger::DELAY:
+            return "delay";
+        case Trigger::TIMER:
+            return "timer";
+    }
+    return "unknown";
+}
+
+}
@@ -1,19 +1,47 @@
 #include <iostream>
+#include <algorithm>
 #include <chrono>
+#include <stdexcept>
 #include <thread>
 #include <vector>
+#include <memory>
+#include <string>
 #include "types.h"
 #include "order.h"
 #include "db_connector.h"
 #include "stock.h"
 #include "shelf_selection.h"
 #include "task_manager.h"
+#include "station_manager.h"
 #include "order_manager.h"
+#include "order_listener.h"
+#include "tick_pipeline.h"
+#include "zone_reporter.h"
+#include "zone_router.h"
+#include "metrics.h"
+#include "metrics_server.h"
 #include "utils.h"
 
-int main() {
+// Usage: wes [zone] [num_zones] [stock_file]
+// Without arguments one process owns the whole site. With a zone it runs as that zone's shard:
+// it loads the zone's stock (data/raw/zones/zone_<zone>_stock.json unless given, see wes_zones),
+// solves the orders wes_coordinator routed to it and reports its stock and load back.
+// A shard gets its zone's share of the site's stations and capacity, num_zones as in wes_zones
+int main(int argc, char** argv) {
     try {
+        const int zone = argc > 1 ? std::stoi(argv[1]) : SS::NO_ZONE;
+        const int num_zones = argc > 2 ? std::stoi(argv[2]) : 4;
+        const std::string stock_file = argc > 3 ? argv[3]
+            : zone == SS::NO_ZONE ? "data/raw/stock.json"
+            : "data/raw/zones/zone_" + std::to_string(zone) + "_stock.json";
+        if (zone != SS::NO_ZONE && (zone < 0 || zone >= num_zones)) {
+            throw std::invalid_argument("Zone " + std::to_string(zone) + " outside the "
+                                        + std::to_string(num_zones) + " zones");
+        }
         std::cout << "Starting Shelf Selection Simulation..." << std::endl;
+        if (zone != SS::NO_ZONE) {
+            std::cout << "Zone " << zone << " of " << num_zones << " shard on " << stock_file << std::endl;
+        }
         
         // Configuration
         const int speed_up_factor = 1;
@@ -21,23 +49,90 @@ int main() {
         SS::TimePoint end_time = start_time + std::chrono::hours(24) + std::chrono::minutes(10);
         SS::TimePoint sim_start = std::chrono::system_clock::now();
         const auto MINUTES_5 = std::chrono::minutes(5);
+        const SS::SolverMode solver_mode = SS::SolverMode::INCREMENTAL;
+        const double solve_deadline_ms = 2000.0;
+        const bool event_driven = true; // Wake on WMS notifications instead of polling every 5 minutes
+        const size_t write_back_queue = 2; // Ticks the DB write-back may fall behind
+        const bool metrics_enabled = true; // Stage timers, per-tick JSON lines and /metrics
+        // Shards on one machine get their own file and port
+        const std::string metrics_file = zone == SS::NO_ZONE ? "data/output/wes_ticks.jsonl"
+            : "data/output/wes_ticks_zone_" + std::to_string(zone) + ".jsonl";
+        const int metrics_port = zone == SS::NO_ZONE ? 9464 : 9465 + zone;
+        // Site-wide pick stations (each with its own queue; 0 models the site as one station)
+        // and capacity range per 5 minutes, a shard takes its zone's share of both
+        int num_stations = 12;
+        int min_capacity = 1000;
+        int max_capacity = 2000;
+        if (zone != SS::NO_ZONE) {
+            num_stations = num_stations > 0 ? std::max(1, SS::zone_share(num_stations, num_zones, zone)) : 0;
+            min_capacity = SS::zone_share(min_capacity, num_zones, zone);
+            max_capacity = SS::zone_share(max_capacity, num_zones, zone);
+        }
+        SS::TriggerPolicy trigger_policy;
+        trigger_policy.fallback = std::chrono::duration_cast<std::chrono::milliseconds>(MINUTES_5) / speed_up_factor;
+        
+        // Instrumentation first, so the first fetch is timed too
+        std::unique_ptr<SS::MetricsServer> metrics_server;
+        if (metrics_enabled) {
+            SS::Metrics& metrics = SS::Metrics::global();
+            metrics.set_enabled(true);
+            metrics.open_jsonl(metrics_file);
+            try {
+                metrics_server = std::make_unique<SS::MetricsServer>(metrics, metrics_port);
+                std::cout << "Metrics on http://127.0.0.1:" << metrics_server->port() << "/metrics" << std::endl;
+            } catch (const std::exception& e) {
+                // A busy port only loses the endpoint, the JSON lines are still written
+                std::cerr << "Warning: " << e.what() << std::endl;
+            }
+        }
         
         // Initialize components
         SS::DBConnector db_connector;
-        SS::StockManager stock("data/raw/stock.json");
-        SS::ShelfSelection shelf_selector(stock);
-        SS::TaskManager task_manager(28);
+        SS::StockManager stock(stock_file);
+        SS::ShelfSelection shelf_selector(stock, solver_mode);
+        shelf_selector.set_deadline_ms(solve_deadline_ms);
+        std::unique_ptr<SS::TaskExecutor> task_manager;
+        SS::StationManager* stations = nullptr;
+        if (num_stations > 0) {
+            auto station_manager = std::make_unique<SS::StationManager>(
+                SS::make_station_layout(num_stations, min_capacity, max_capacity), 28);
+            station_manager->set_face_units(&shelf_selector.get_face_units());
+            stations = station_manager.get();
+            task_manager = std::move(station_manager);
+        } else {
+            task_manager = std::make_unique<SS::TaskManager>(28, min_capacity, max_capacity);
+        }
         SS::OrderManager order_manager(db_connector, stock);
+        order_manager.set_zone(zone);
+        std::unique_ptr<SS::ZoneReporter> zone_reporter;
+        if (zone != SS::NO_ZONE) {
+            zone_reporter = std::make_unique<SS::ZoneReporter>(zone, stock);
+        }
         pqxx::connection conn = db_connector.connect();
         
         std::cout << "Database connected successfully" << std::endl;
+        std::unique_ptr<SS::OrderListener> listener;
+        if (event_driven) {
+            // A shard wakes on the coordinator routing orders to it, not on the WMS
+            listener = std::make_unique<SS::OrderListener>(
+                conn, zone == SS::NO_ZONE ? std::string(SS::BACKLOG_CHANNEL) : SS::zone_channel(zone));
+        }
+        
+        // Fetch + solve + tasks on this thread, DB write-back on its own thread and connection
+        SS::TickPipeline pipeline(db_connector, order_manager, shelf_selector, *task_manager, write_back_queue);
+        pipeline.set_zone_reporter(zone_reporter.get());
         
         // Simulation variables
-        SS::Taskpool pending;
         int iteration = 0;
         auto last_check = sim_start;
         
         while (true) {
+            // Event-driven: block until enough orders arrived or a deadline passed
+            std::string trigger = "timer";
+            if (listener) {
+                trigger = SS::to_string(listener->wait(trigger_policy));
+            }
+            
             // Calculate elapsed time
             auto now = std::chrono::system_clock::now();
             auto elapsed_real = now - sim_start;
@@ -50,40 +145,58 @@ int main() {
                 break;
             }
             
-            // Check if 5 minutes have passed
-            auto time_since_check = now - last_check;
-            if (time_since_check >= MINUTES_5 / speed_up_factor) {
+            // Polling: check if 5 minutes have passed
+            if (listener || now - last_check >= MINUTES_5 / speed_up_factor) {
                 iteration++;
                 last_check = now;
                 
                 std::cout << "\n🤖 Shelf Selector iteration " << iteration << " ===========================" << std::endl;
+                if (listener) {
+                    std::cout << "  ├─ Trigger: " << trigger << " (" << listener->get_new_orders() << " new orders)" << std::endl;
+                }
                 auto elapsed_minutes = std::chrono::duration_cast<std::chrono::minutes>(elapsed_time).count();
                 std::cout << "  ├─ Current time: " << elapsed_minutes << " minutes" << std::endl;
                 
-                // Update expired orders in DB
-                order_manager.update_expired_orders(conn, simulation_date);
-                
-                // Fetch pending backlog from DB
-                std::vector<SS::Order> backlog = order_manager.get_backlog_from_db(conn, simulation_date);
-                std::cout << "  ├─ Pending orders: " << backlog.size() << std::endl;
-                
-                // Run shelf selector to get taskpool
-                int N = task_manager.get_available_capacity();
-                SS::Taskpool taskpool = shelf_selector.run(backlog, pending, N);
-                
-                // Update DB with completed tasks
-                order_manager.update_completed_orders(conn, taskpool);
+                // Plan stage here, the DB write-back of this tick overlaps the next one
+                const SS::TickStats& tick = pipeline.tick(simulation_date);
+                std::cout << "  ├─ Pending orders: " << tick.backlog_size << std::endl;
                 
-                // Process tasks and get pending tasks
-                pending = task_manager.process_tasks(taskpool);
+                const SS::MCFStats& stats = shelf_selector.get_last_stats();
+                std::cout << "  ├─ Shelf selection: " << stats.assigned_orders << " orders in "
+                          << stats.build_ms + stats.solve_ms << " ms (build " << stats.build_ms
+                          << " ms, solve " << stats.solve_ms << " ms)"
+                          << (stats.mode == SS::SolverMode::GREEDY ? " [greedy]" : "") << std::endl;
+                std::cout << "  ├─ Racks opened: " << stats.racks_opened << " (" << stats.faces_opened << " faces), "
+                          << (stats.racks_opened > 0 ? static_cast<double>(stats.assigned_orders) / stats.racks_opened : 0.0)
+                          << " orders per rack trip" << std::endl;
+                if (stats.shadowed) {
+                    std::cout << "  ├─ Greedy optimality gap: "
+                              << stats.shadow_heuristic_cost - stats.shadow_optimal_cost
+                              << " (shadow MCF " << stats.shadow_ms << " ms)" << std::endl;
+                }
+                std::cout << "  ├─ Stages: fetch " << tick.fetch_ms << " ms, solve " << tick.solve_ms
+                          << " ms, tasks " << tick.tasks_ms << " ms, enqueue " << tick.enqueue_ms << " ms" << std::endl;
+                std::cout << "  ├─ Write-back: queue depth " << tick.queue_depth << " (max " << tick.max_queue_depth
+                          << "), last write tick " << tick.written_tick << " in " << tick.write_ms << " ms" << std::endl;
+                if (stations) {
+                    std::cout << "  ├─ Stations (racks/units/capacity):";
+                    double travel = 0.0;
+                    for (const SS::StationStats& station : stations->get_last_stats()) {
+                        std::cout << " " << station.racks << "/" << station.units << "/" << station.capacity;
+                        travel += station.travel;
+                    }
+                    std::cout << ", travel " << travel << std::endl;
+                }
                 
-                std::cout << "  └─ Next pending tasks: " << pending.size() << std::endl;
+                std::cout << "  └─ Next pending tasks: " << pipeline.get_pending().size() << std::endl;
             } else {
                 // Sleep for a short duration before checking again
                 std::this_thread::sleep_for(std::chrono::milliseconds(1000 / speed_up_factor));
             }
         }
 
+        pipeline.flush();
+        listener.reset(); // UNLISTEN while the connection is still open
         conn.close();
         std::cout << "Simulation completed successfully." << std::endl;
         return 0;
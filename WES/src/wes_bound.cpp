@@ -0,0 +1,70 @@
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "types.h"
+#include "order.h"
+#include "stock.h"
+#include "batch_bound.h"
+#include "simulation.h"
+#include "utils.h"
+
+// Usage: wes_bound [stock_file] [backlog_file] [output_dir] [seed] [period_minutes]
+// Solves the whole replayed day as one multi-period MCF and compares the bounds with the
+// polling simulation (event_driven off) on the same periods, seed and capacities
+int main(int argc, char** argv) {
+    const std::string stock_file = argc > 1 ? argv[1] : "data/raw/stock.json";
+    const std::string backlog_file = argc > 2 ? argv[2] : "data/raw/backlog.json";
+    const std::string output_dir = argc > 3 ? argv[3] : "data/output";
+    const int seed = argc > 4 ? std::stoi(argv[4]) : 28;
+    const int period_minutes = argc > 5 ? std::stoi(argv[5]) : 5;
+
+    try {
+        // Same window as wes_sim
+        SS::BatchBoundConfig config;
+        config.start_date = SS::parse_iso8601("2025-10-09T00:00:00");
+        config.end_date = config.start_date + std::chrono::hours(24) + std::chrono::minutes(10);
+        config.period = std::chrono::minutes(period_minutes);
+        config.seed = seed;
+
+        const SS::StockManager stock(stock_file);
+        const std::vector<SS::Order> orders = SS::read_orders(backlog_file);
+        std::cout << "Bounding " << orders.size() << " orders on " << stock.num_racks() << " racks" << std::endl;
+
+        SS::BatchBound bound(config, stock, orders);
+        const SS::BatchBoundResult& result = bound.solve();
+        bound.write_outputs(output_dir);
+
+        SS::SimulationConfig sim_config;
+        sim_config.start_date = config.start_date;
+        sim_config.end_date = config.end_date;
+        sim_config.event_driven = false;
+        sim_config.trigger_policy.fallback = config.period;
+        sim_config.seed = seed;
+        sim_config.min_capacity = config.min_capacity;
+        sim_config.max_capacity = config.max_capacity;
+        SS::Simulation simulation(sim_config, stock, orders);
+        const SS::SimulationMetrics& metrics = simulation.run();
+        const size_t sim_unserved = metrics.orders - metrics.completed;
+        long long sim_units = 0;
+        for (const SS::SimulationTick& tick : simulation.get_ticks()) {
+            sim_units += tick.assigned_units;
+        }
+
+        std::cout << "  ├─ Graph: " << result.num_nodes << " nodes, " << result.num_arcs << " arcs, "
+                  << result.groups << " groups over " << result.periods << " periods" << std::endl;
+        std::cout << "  ├─ Build: " << result.build_ms << " ms, solve: " << result.solve_ms << " ms" << std::endl;
+        std::cout << "  ├─ Unserved: bound " << result.min_unserved << " (" << result.unstocked << " unstocked, "
+                  << result.out_of_window << " out of window), online " << sim_unserved << std::endl;
+        std::cout << "  ├─ Completed: bound " << result.served << " orders / " << result.served_units
+                  << " units, online " << metrics.completed << " / " << sim_units << std::endl;
+        std::cout << "  ├─ Rack visits: LP bound " << result.rack_visits_bound << " for " << result.served_units
+                  << " units, online " << metrics.rack_visits << " for " << sim_units << std::endl;
+        std::cout << "  └─ Bounds written to " << output_dir << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,53 @@
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <pqxx/pqxx>
+#include "db_connector.h"
+#include "order_listener.h"
+#include "trigger_policy.h"
+#include "zone_coordinator.h"
+#include "zone_router.h"
+
+// Usage: wes_coordinator [num_zones] [poll_ms] [duration_minutes]
+// Routes the WMS backlog to the zone shards (wes <zone>) through the backlog table.
+// Runs a round whenever the WMS announces orders, and at least every poll_ms so that
+// orders handed back by a shard are routed again; stops after duration_minutes
+int main(int argc, char** argv) {
+    const int num_zones = argc > 1 ? std::stoi(argv[1]) : 4;
+    const int poll_ms = argc > 2 ? std::stoi(argv[2]) : 1000;
+    const int duration_minutes = argc > 3 ? std::stoi(argv[3]) : 24 * 60 + 10;
+
+    try {
+        SS::DBConnector db_connector;
+        SS::ZoneCoordinator coordinator(db_connector, num_zones);
+        pqxx::connection conn = db_connector.connect();
+        SS::OrderListener listener(conn);
+        SS::TriggerPolicy trigger_policy;
+        trigger_policy.fallback = std::chrono::milliseconds(poll_ms);
+        std::cout << "Coordinating " << num_zones << " zones" << std::endl;
+
+        const auto end = std::chrono::steady_clock::now() + std::chrono::minutes(duration_minutes);
+        while (std::chrono::steady_clock::now() < end) {
+            const SS::Trigger trigger = listener.wait(trigger_policy);
+            const SS::CoordinatorStats& stats = coordinator.route_once();
+            if (stats.fetched == 0) {
+                continue;
+            }
+            std::cout << "\n🧭 Routing round " << stats.round << " (" << SS::to_string(trigger) << ")" << std::endl;
+            std::cout << "  ├─ Orders: " << stats.fetched << " fetched, " << stats.routed << " routed, "
+                      << stats.stock_out << " stock out, " << stats.waiting << " waiting for "
+                      << num_zones - static_cast<int>(stats.reported_zones) << " zones" << std::endl;
+            std::cout << "  ├─ Zones (orders/price):";
+            for (int zone = 0; zone < num_zones; zone++) {
+                std::cout << " " << stats.zone_orders[zone] << "/" << coordinator.get_router().price(zone);
+            }
+            std::cout << std::endl;
+            std::cout << "  └─ Round: " << stats.round_ms << " ms" << std::endl;
+        }
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
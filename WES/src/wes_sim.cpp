@@ -0,0 +1,66 @@
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "types.h"
+#include "order.h"
+#include "stock.h"
+#include "simulation.h"
+#include "utils.h"
+
+// Usage: wes_sim [stock_file] [backlog_file] [output_dir] [seed] [snapshot_every] [rack_trip_cost] [stations] [start_date]
+// Replays the backlog through the WES loop on a virtual clock, no database needed
+// Stock and backlog may be json files or snapshots, snapshot_every > 0 also writes
+// tick_<n>_stock.snap and tick_<n>_backlog.snap to output_dir every that many ticks
+// rack_trip_cost > 0 solves with FIXED_CHARGE, charging that much per rack opened
+// stations > 0 splits the capacity over that many pick stations, see StationManager
+// start_date restarts from tick_<n> snapshots at that tick's date (sim_ticks.csv), the run still ends with the day
+int main(int argc, char** argv) {
+    const std::string stock_file = argc > 1 ? argv[1] : "data/raw/stock.json";
+    const std::string backlog_file = argc > 2 ? argv[2] : "data/raw/backlog.json";
+    const std::string output_dir = argc > 3 ? argv[3] : "data/output";
+    const int seed = argc > 4 ? std::stoi(argv[4]) : 28;
+    const int snapshot_every = argc > 5 ? std::stoi(argv[5]) : 0;
+    const int rack_trip_cost = argc > 6 ? std::stoi(argv[6]) : 0;
+    const int stations = argc > 7 ? std::stoi(argv[7]) : 0;
+    const std::string start_date = argc > 8 ? argv[8] : "2025-10-09T00:00:00";
+
+    try {
+        // Same window and policy as wes.cpp
+        SS::SimulationConfig config;
+        config.start_date = SS::parse_iso8601(start_date);
+        const auto day = std::chrono::floor<std::chrono::duration<int64_t, std::ratio<86400>>>(config.start_date);
+        config.end_date = day + std::chrono::hours(24) + std::chrono::minutes(10);
+        config.mode = rack_trip_cost > 0 ? SS::SolverMode::FIXED_CHARGE : SS::SolverMode::INCREMENTAL;
+        config.trip_costs.rack = rack_trip_cost;
+        config.seed = seed;
+        config.stations = stations;
+        config.snapshot_every = snapshot_every;
+        config.snapshot_dir = output_dir;
+
+        const SS::StockManager stock(stock_file);
+        const std::vector<SS::Order> orders = SS::read_orders(backlog_file);
+        std::cout << "Replaying " << orders.size() << " orders on " << stock.num_racks() << " racks" << std::endl;
+
+        SS::Simulation simulation(config, stock, orders);
+        const SS::SimulationMetrics& metrics = simulation.run();
+        simulation.write_outputs(output_dir);
+
+        std::cout << "  ├─ Ticks: " << metrics.ticks << std::endl;
+        std::cout << "  ├─ Published: " << metrics.published << " / " << metrics.orders << std::endl;
+        std::cout << "  ├─ Completed: " << metrics.completed << ", expired: " << metrics.expired
+                  << ", stock out: " << metrics.stock_out << ", open: " << metrics.open << std::endl;
+        std::cout << "  ├─ Rack visits: " << metrics.rack_visits << " (" << metrics.linear_rack_visits
+                  << " without trip costs), mean lead time: " << metrics.mean_lead_minutes << " min" << std::endl;
+        if (stations > 0) {
+            std::cout << "  ├─ Stations: " << stations << ", rack travel: " << metrics.travel << std::endl;
+        }
+        std::cout << "  ├─ Solve: " << metrics.solve_ms_total << " ms total, " << metrics.solve_ms_max << " ms max" << std::endl;
+        std::cout << "  └─ Wall time: " << metrics.wall_ms << " ms, metrics written to " << output_dir << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
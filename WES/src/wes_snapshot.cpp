@@ -0,0 +1,100 @@
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "types.h"
+#include "order.h"
+#include "stock.h"
+
+namespace {
+
+double elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool same_stock(const SS::StockManager& a, const SS::StockManager& b) {
+    if (a.get_rack_ids().names() != b.get_rack_ids().names()
+        || a.get_face_ids().names() != b.get_face_ids().names()
+        || a.get_item_ids().names() != b.get_item_ids().names()) {
+        return false;
+    }
+    for (SS::ItemIdx item = 0; item < a.get_item_ids().size(); item++) {
+        const auto& locations_a = a.get_item_locations(item);
+        const auto& locations_b = b.get_item_locations(item);
+        if (a.get_total_quantity(item) != b.get_total_quantity(item) || locations_a.size() != locations_b.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < locations_a.size(); i++) {
+            if (locations_a[i].rack != locations_b[i].rack || locations_a[i].face != locations_b[i].face
+                || locations_a[i].quantity != locations_b[i].quantity
+                || b.get_item_quantity(locations_a[i].rack, locations_a[i].face, item) != locations_a[i].quantity) {
+                return false;
+            }
+        }
+    }
+    return a.is_rack_hot_ == b.is_rack_hot_ && a.is_rack_warm_ == b.is_rack_warm_
+        && a.warm_racks_ == b.warm_racks_
+        && a.stock_out_items_ == b.stock_out_items_;
+}
+
+bool same_orders(const std::vector<SS::Order>& a, const std::vector<SS::Order>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].order_id != b[i].order_id || a[i].item_id != b[i].item_id || a[i].quantity != b[i].quantity
+            || a[i].creation_date != b[i].creation_date || a[i].due_date != b[i].due_date
+            || a[i].closure_date != b[i].closure_date || a[i].status != b[i].status
+            || a[i].priority != b[i].priority) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+// Usage: wes_snapshot [stock_file] [backlog_file] [output_dir]
+// Converts the json stock and backlog into output_dir/stock.snap and output_dir/backlog.snap,
+// then loads both back, checks they match and reports the load times
+int main(int argc, char** argv) {
+    const std::string stock_file = argc > 1 ? argv[1] : "data/raw/stock.json";
+    const std::string backlog_file = argc > 2 ? argv[2] : "data/raw/backlog.json";
+    const std::string output_dir = argc > 3 ? argv[3] : "data/raw";
+    const std::string stock_snapshot = output_dir + "/stock.snap";
+    const std::string backlog_snapshot = output_dir + "/backlog.snap";
+
+    try {
+        auto start = std::chrono::steady_clock::now();
+        const SS::StockManager stock(stock_file);
+        const double stock_json_ms = elapsed_ms(start);
+        start = std::chrono::steady_clock::now();
+        const std::vector<SS::Order> orders = SS::read_orders_json(backlog_file);
+        const double backlog_json_ms = elapsed_ms(start);
+
+        stock.save_snapshot(stock_snapshot);
+        SS::write_orders_snapshot(backlog_snapshot, orders);
+
+        start = std::chrono::steady_clock::now();
+        const SS::StockManager stock_copy(stock_snapshot);
+        const double stock_snapshot_ms = elapsed_ms(start);
+        start = std::chrono::steady_clock::now();
+        const std::vector<SS::Order> orders_copy = SS::read_orders_snapshot(backlog_snapshot);
+        const double backlog_snapshot_ms = elapsed_ms(start);
+
+        const bool stock_ok = same_stock(stock, stock_copy);
+        const bool orders_ok = same_orders(orders, orders_copy);
+        std::cout << "Stock: " << stock.num_racks() << " racks, " << stock.get_item_ids().size() << " items -> "
+                  << stock_snapshot << std::endl;
+        std::cout << "  ├─ Load: json " << stock_json_ms << " ms, snapshot " << stock_snapshot_ms << " ms" << std::endl;
+        std::cout << "  └─ Round trip: " << (stock_ok ? "identical" : "MISMATCH") << std::endl;
+        std::cout << "Backlog: " << orders.size() << " orders -> " << backlog_snapshot << std::endl;
+        std::cout << "  ├─ Load: json " << backlog_json_ms << " ms, snapshot " << backlog_snapshot_ms << " ms" << std::endl;
+        std::cout << "  └─ Round trip: " << (orders_ok ? "identical" : "MISMATCH") << std::endl;
+        return stock_ok && orders_ok ? 0 : 1;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,48 @@
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "types.h"
+#include "order.h"
+#include "stock.h"
+#include "simulation.h"
+#include "parameter_sweep.h"
+#include "utils.h"
+
+// Usage: wes_sweep [sweep_file] [stock_file] [backlog_file] [output_file] [threads]
+// Runs one offline simulation per parameter point of the sweep file, in parallel
+int main(int argc, char** argv) {
+    const std::string sweep_file = argc > 1 ? argv[1] : "data/sweep_example.json";
+    const std::string stock_file = argc > 2 ? argv[2] : "data/raw/stock.json";
+    const std::string backlog_file = argc > 3 ? argv[3] : "data/raw/backlog.json";
+    const std::string output_file = argc > 4 ? argv[4] : "data/output/sweep_results.csv";
+    const size_t num_threads = argc > 5 ? std::stoul(argv[5]) : 0;
+
+    try {
+        // Same window and policy as wes_sim, the sweep overrides the parameters
+        SS::SimulationConfig base;
+        base.start_date = SS::parse_iso8601("2025-10-09T00:00:00");
+        base.end_date = base.start_date + std::chrono::hours(24) + std::chrono::minutes(10);
+        base.mode = SS::SolverMode::INCREMENTAL;
+
+        const SS::SweepSpec spec = SS::SweepSpec::from_json_file(sweep_file);
+        const std::vector<SS::SimulationConfig> configs = spec.expand(base);
+        const SS::StockManager stock(stock_file);
+        const std::vector<SS::Order> orders = SS::read_orders(backlog_file);
+        std::cout << "Sweeping " << configs.size() << " configurations over " << orders.size() << " orders" << std::endl;
+
+        auto start = std::chrono::steady_clock::now();
+        SS::ParameterSweep sweep(stock, orders);
+        std::vector<SS::SimulationMetrics> results = sweep.run(configs, num_threads);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        SS::ParameterSweep::write_csv(output_file, configs, results);
+
+        std::cout << "Done in " << seconds << " s (" << (seconds > 0 ? configs.size() / seconds : 0.0)
+                  << " runs/sec), results written to " << output_file << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,47 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include "types.h"
+#include "stock.h"
+#include "zone_router.h"
+
+// Usage: wes_zones [stock_file] [num_zones] [output_dir]
+// Splits the stock into output_dir/zone_<z>_stock.json, one per WES shard (wes <z> <num_zones>),
+// then loads every zone back and checks the racks and item quantities add up to the site
+int main(int argc, char** argv) {
+    const std::string stock_file = argc > 1 ? argv[1] : "data/raw/stock.json";
+    const int num_zones = argc > 2 ? std::stoi(argv[2]) : 4;
+    const std::string output_dir = argc > 3 ? argv[3] : "data/raw/zones";
+
+    try {
+        const SS::StockManager stock(stock_file);
+        const std::vector<std::string> paths = SS::write_zone_stock_files(stock, num_zones, output_dir);
+
+        size_t racks = 0;
+        std::vector<long long> quantities(stock.get_item_ids().size(), 0);
+        std::cout << "Site: " << stock.num_racks() << " racks, " << stock.get_item_ids().size() << " items, "
+                  << stock.memory_usage() / 1024 << " KiB" << std::endl;
+        for (int zone = 0; zone < num_zones; zone++) {
+            const SS::StockManager zone_stock(paths[zone]);
+            racks += zone_stock.num_racks();
+            for (SS::ItemIdx item = 0; item < zone_stock.get_item_ids().size(); item++) {
+                quantities[stock.get_item_ids().find(zone_stock.get_item_ids().name(item))]
+                    += zone_stock.get_total_quantity(item);
+            }
+            std::cout << (zone + 1 < num_zones ? "  ├─ " : "  └─ ") << "Zone " << zone << ": "
+                      << zone_stock.num_racks() << " racks, " << zone_stock.get_item_ids().size() << " items, "
+                      << zone_stock.memory_usage() / 1024 << " KiB -> " << paths[zone] << std::endl;
+        }
+
+        bool same = racks == stock.num_racks();
+        for (SS::ItemIdx item = 0; item < stock.get_item_ids().size(); item++) {
+            same = same && quantities[item] == stock.get_total_quantity(item);
+        }
+        std::cout << "Split: " << (same ? "complete" : "MISMATCH") << std::endl;
+        return same ? 0 : 1;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,95 @@
+#include "zone_coordinator.h"
+#include <chrono>
+#include <string>
+#include "order.h"
+#include "utils.h"
+
+namespace SS {
+
+namespace {
+
+double elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+ZoneCoordinator::ZoneCoordinator(DBConnector& db_connector, int num_zones, const ZoneRouterOptions& options,
+                                 int batch_size)
+    : db_connector_(db_connector), router_(num_zones, options), num_zones_(num_zones), batch_size_(batch_size) {
+    db_connector_.enable_zone_statements();
+}
+
+const CoordinatorStats& ZoneCoordinator::route_once() {
+    auto start = std::chrono::steady_clock::now();
+    CoordinatorStats stats;
+    stats.round = last_stats_.round + 1;
+    stats.zone_orders.assign(num_zones_, 0);
+
+    DBConnector::Lease conn = db_connector_.acquire();
+    pqxx::work txn(*conn);
+
+    // Zone reports, rows of zones outside this deployment are ignored
+    std::vector<bool> reported(num_zones_, false);
+    for (const auto& row : txn.exec_prepared(FETCH_ZONE_STATUS_STMT)) {
+        const int zone = row["zone"].as<int>();
+        if (zone >= 0 && zone < num_zones_) {
+            router_.set_load(zone, row["capacity"].as<int>(), row["open_units"].as<long long>());
+            reported[zone] = true;
+            stats.reported_zones++;
+        }
+    }
+    for (const auto& row : txn.exec_prepared(FETCH_ZONE_STOCK_STMT)) {
+        const int zone = row["zone"].as<int>();
+        if (zone >= 0 && zone < num_zones_) {
+            router_.set_stock(zone, row["item_id"].as<std::string>(), row["quantity"].as<int>(),
+                              row["claimed"].as<int>());
+        }
+    }
+
+    std::vector<Order> orders;
+    for (const auto& row : txn.exec_prepared(FETCH_UNROUTED_STMT, batch_size_)) {
+        orders.push_back(Order{row["order_id"].as<std::string>(), row["item_id"].as<std::string>(),
+                               row["quantity"].as<int>(), TimePoint(), TimePoint()});
+    }
+    stats.fetched = orders.size();
+
+    const std::vector<int> zones = router_.route(orders);
+    const bool all_reported = stats.reported_zones == static_cast<size_t>(num_zones_);
+    std::vector<std::string> routed_ids;
+    std::vector<int> routed_zones;
+    std::vector<std::string> stock_out_ids;
+    for (size_t i = 0; i < orders.size(); i++) {
+        if (zones[i] != NO_ZONE) {
+            routed_ids.push_back(orders[i].order_id);
+            routed_zones.push_back(zones[i]);
+            stats.zone_orders[zones[i]]++;
+        } else if (all_reported) {
+            stock_out_ids.push_back(orders[i].order_id);
+        } else {
+            stats.waiting++;
+        }
+    }
+    stats.routed = routed_ids.size();
+    stats.stock_out = stock_out_ids.size();
+
+    if (!routed_ids.empty()) {
+        txn.exec_prepared(ROUTE_ORDERS_STMT, routed_ids, routed_zones);
+    }
+    if (!stock_out_ids.empty()) {
+        txn.exec_prepared(STOCK_OUT_ORDER_IDS_STMT, format_iso8601(std::chrono::system_clock::now()), stock_out_ids);
+    }
+    // Delivered on commit, after the rows are visible to the shards
+    for (int zone = 0; zone < num_zones_; zone++) {
+        if (stats.zone_orders[zone] > 0) {
+            txn.exec_prepared(NOTIFY_BACKLOG_STMT, zone_channel(zone), std::to_string(stats.zone_orders[zone]));
+        }
+    }
+    txn.commit();
+
+    stats.round_ms = elapsed_ms(start);
+    last_stats_ = stats;
+    return last_stats_;
+}
+
+}
@@ -0,0 +1,55 @@
+#include "zone_reporter.h"
+#include <unordered_set>
+#include "db_connector.h"
+
+namespace SS {
+
+ZoneReporter::ZoneReporter(int zone, const StockManager& stock)
+    : zone_(zone),
+      stock_(stock),
+      reported_quantity_(stock.get_item_ids().size(), -1),
+      reported_claimed_(stock.get_item_ids().size(), -1) {
+}
+
+ZoneReport ZoneReporter::take_report(int tick, int capacity, const std::vector<Order>& backlog,
+                                     const Taskpool& taskpool) {
+    ZoneReport report;
+    report.zone = zone_;
+    report.tick = tick;
+    report.capacity = capacity;
+
+    std::unordered_set<OrderIdx> completed;
+    for (const auto& [rack, faces] : taskpool) {
+        for (const auto& [face, orders] : faces) {
+            completed.insert(orders.begin(), orders.end());
+        }
+    }
+    std::vector<int> claimed(stock_.get_item_ids().size(), 0);
+    for (const Order& order : backlog) {
+        if (order.item_idx != INVALID_IDX && completed.count(order.order_idx) == 0) {
+            claimed[order.item_idx] += order.quantity;
+            report.open_units += order.quantity;
+        }
+    }
+
+    for (ItemIdx item = 0; item < claimed.size(); item++) {
+        const int quantity = stock_.get_total_quantity(item);
+        if (quantity != reported_quantity_[item] || claimed[item] != reported_claimed_[item]) {
+            report.item_ids.push_back(stock_.get_item_ids().name(item));
+            report.quantities.push_back(quantity);
+            report.claimed.push_back(claimed[item]);
+            reported_quantity_[item] = quantity;
+            reported_claimed_[item] = claimed[item];
+        }
+    }
+    return report;
+}
+
+void ZoneReporter::write_report(pqxx::work& txn, const ZoneReport& report) {
+    if (!report.item_ids.empty()) {
+        txn.exec_prepared(UPSERT_ZONE_STOCK_STMT, report.zone, report.item_ids, report.quantities, report.claimed);
+    }
+    txn.exec_prepared(UPSERT_ZONE_STATUS_STMT, report.zone, report.tick, report.capacity, report.open_units);
+}
+
+}
@@ -0,0 +1,143 @@
+#include "zone_router.h"
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <nlohmann/json.hpp>
+
+namespace SS {
+
+int rack_zone(RackIdx rack, size_t num_racks, int num_zones) {
+    if (num_zones <= 1 || num_racks == 0) {
+        return 0;
+    }
+    return static_cast<int>(static_cast<unsigned long long>(rack) * num_zones / num_racks);
+}
+
+std::vector<std::string> write_zone_stock_files(const StockManager& stock, int num_zones,
+                                                const std::string& output_dir) {
+    if (num_zones <= 0) {
+        throw std::invalid_argument("Zone split needs at least one zone");
+    }
+    std::vector<nlohmann::json> zones(num_zones, nlohmann::json::object());
+    std::vector<ItemIdx> items;
+    for (RackIdx rack = 0; rack < stock.num_racks(); rack++) {
+        items.clear();
+        stock.get_rack_items(rack, items);
+        std::sort(items.begin(), items.end());
+        items.erase(std::unique(items.begin(), items.end()), items.end());
+
+        // Every face is kept, empty ones too, so the zones intern the same faces
+        nlohmann::json rack_json = nlohmann::json::object();
+        for (FaceIdx face = 0; face < stock.num_faces(); face++) {
+            nlohmann::json face_json = nlohmann::json::array();
+            for (ItemIdx item : items) {
+                const int quantity = stock.get_item_quantity(rack, face, item);
+                if (quantity > 0) {
+                    face_json.push_back({{"Inventory ID", stock.get_item_ids().name(item)}, {"Cantidad", quantity}});
+                }
+            }
+            rack_json[stock.get_face_ids().name(face)] = std::move(face_json);
+        }
+        zones[rack_zone(rack, stock.num_racks(), num_zones)][stock.get_rack_ids().name(rack)] = std::move(rack_json);
+    }
+
+    std::vector<std::string> paths;
+    for (int zone = 0; zone < num_zones; zone++) {
+        paths.push_back(output_dir + "/zone_" + std::to_string(zone) + "_stock.json");
+        std::ofstream file(paths.back());
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open output file: " + paths.back());
+        }
+        file << zones[zone].dump() << std::endl;
+    }
+    return paths;
+}
+
+std::string zone_channel(int zone) {
+    return "backlog_zone_" + std::to_string(zone);
+}
+
+int zone_share(int total, int num_zones, int zone) {
+    num_zones = std::max(1, num_zones);
+    return total / num_zones + (zone < total % num_zones ? 1 : 0);
+}
+
+ZoneRouter::ZoneRouter(int num_zones, const ZoneRouterOptions& options)
+    : options_(options),
+      capacity_(std::max(1, num_zones), 0),
+      open_units_(std::max(1, num_zones), 0),
+      prices_(std::max(1, num_zones), 0.0) {
+}
+
+void ZoneRouter::set_stock(int zone, const std::string& item_id, int quantity, int claimed) {
+    const ItemIdx item = item_ids_.intern(item_id);
+    if (item >= item_zones_.size()) {
+        item_zones_.resize(item + 1);
+    }
+    std::vector<ZoneStock>& zones = item_zones_[item];
+    auto it = std::find_if(zones.begin(), zones.end(), [zone](const ZoneStock& stock) { return stock.zone == zone; });
+    if (it == zones.end()) {
+        zones.push_back({zone, quantity, claimed});
+    } else {
+        it->quantity = quantity;
+        it->claimed = claimed;
+    }
+}
+
+void ZoneRouter::set_load(int zone, int capacity, long long open_units) {
+    capacity_[zone] = capacity;
+    open_units_[zone] = open_units;
+}
+
+long long ZoneRouter::total_quantity(const std::string& item_id) const {
+    const ItemIdx item = item_ids_.find(item_id);
+    if (item == INVALID_IDX || item >= item_zones_.size()) {
+        return 0;
+    }
+    long long total = 0;
+    for (const ZoneStock& stock : item_zones_[item]) {
+        total += stock.quantity;
+    }
+    return total;
+}
+
+std::vector<int> ZoneRouter::route(const std::vector<Order>& orders) {
+    // Price step on last round's load, zones that never reported keep their price
+    for (size_t zone = 0; zone < prices_.size(); zone++) {
+        if (capacity_[zone] > 0) {
+            const double overload = static_cast<double>(open_units_[zone]) / capacity_[zone] - 1.0;
+            prices_[zone] = std::max(0.0, prices_[zone] + options_.price_step * overload);
+        }
+    }
+
+    std::vector<int> zones(orders.size(), NO_ZONE);
+    for (size_t i = 0; i < orders.size(); i++) {
+        const Order& order = orders[i];
+        const ItemIdx item = item_ids_.find(order.item_id);
+        if (item == INVALID_IDX || item >= item_zones_.size()) {
+            continue;
+        }
+        ZoneStock* best = nullptr;
+        double best_bid = std::numeric_limits<double>::max();
+        for (ZoneStock& stock : item_zones_[item]) {
+            if (stock.quantity <= 0) {
+                continue;
+            }
+            const double scarcity = static_cast<double>(stock.claimed + order.quantity) / stock.quantity;
+            const double bid = prices_[stock.zone] + options_.scarcity_weight * scarcity;
+            if (bid < best_bid || (bid == best_bid && stock.zone < best->zone)) {
+                best_bid = bid;
+                best = &stock;
+            }
+        }
+        if (best) {
+            best->claimed += order.quantity;
+            open_units_[best->zone] += order.quantity;
+            zones[i] = best->zone;
+        }
+    }
+    return zones;
+}
+
+}
@@ -1,8 +1,7 @@
 #include "publisher.h"
-#include <fstream>
+#include <algorithm>
 #include <thread>
 #include <memory>
-#include <nlohmann/json.hpp>
 #include <chrono>
 #include <iostream>
 #include "utils.h"
@@ -24,118 +23,125 @@ Publisher::Publisher(
 }
 
 void Publisher::read_backlog_from_file() {
-    // Implementation for reading the backlog from a json file
-    std::ifstream file(backlog_file_path_);
-    
-    if (!file.is_open()) {
-        throw std::runtime_error("Could not open backlog file: " + backlog_file_path_);
-    }
-
-    nlohmann::json json_data;
-    file >> json_data;  // Read the JSON from the file
-    
-    // Parse orders
-    if (json_data.contains("orders")) {
-        for (const auto &order_json : json_data["orders"]) {
-            std::string creation_date_str = order_json["creation_date"].get<std::string>();
-            std::string due_date_str = order_json["due_date"].get<std::string>();
-            
-            TimePoint creation_date = parse_iso8601(creation_date_str);
-            TimePoint due_date = parse_iso8601(due_date_str);
-            
-            Order order{
-                order_json["order_id"].get<std::string>(),
-                order_json["item_id"].get<std::string>(),
-                order_json["quantity"].get<int>(),
-                creation_date,
-                due_date
-            };
-            
-            this->backlog_.push_back(order);
-        }
-    }
+    backlog_ = read_orders(backlog_file_path_);
 }
 
 void Publisher::publish() {
-    // Implementation for publishing an order to the database
+    // Implementation for publishing the due orders to the database
     try {
         std::cout << "Publisher starting with " << backlog_.size() << " orders in backlog" << std::endl;
         
         // Connect to the database using DBConnector
-        pqxx::connection conn = db_connector_.connect();
+        DBConnector::Lease conn = db_connector_.acquire();
         std::cout << "Database connected successfully" << std::endl;
 
-        // Calculate simulation time
-        TimePoint simulation_date;
-
-        int published_count = 0;
-        int batch_count = 0;
-        const int BATCH_SIZE = 1000; // Commit every 1000 orders
+        auto publish_start = std::chrono::steady_clock::now();
+        size_t published_count = 0;
         
-        // Use a unique_ptr for transaction management
-        std::unique_ptr<pqxx::work> txn = std::make_unique<pqxx::work>(conn);
-        
-        for (const auto &order : backlog_) {
-            std::cout << "Checking order " << order.order_id << std::endl;
-            while (true)
-            {
+        while (published_count < backlog_.size()) {
+            // Calculate simulation time
             auto elapsed_time = std::chrono::system_clock::now() - this->simulation_start_date_;
             elapsed_time *= this->speed_up_factor_;
-            simulation_date = this->start_date_ + elapsed_time;
+            TimePoint simulation_date = this->start_date_ + elapsed_time;
             
-            //std::cout << "  Order creation: " << format_iso8601(order.creation_date) << std::endl;
-            //std::cout << "  Simulation date: " << format_iso8601(simulation_date) << std::endl;
-            //std::cout << "  Condition (creation <= sim): " << (order.creation_date <= simulation_date) << std::endl;
+            // Time slice: the following orders created up to the simulation date, in file order
+            size_t slice_end = published_count;
+            while (slice_end < backlog_.size() && backlog_[slice_end].creation_date <= simulation_date) {
+                slice_end++;
+            }
             
-            if (order.creation_date <= simulation_date) {
-                // Convert timestamps to strings for database insertion
-                std::string creation_date_str = format_iso8601(order.creation_date);
-                std::string due_date_str = format_iso8601(order.due_date);
-                
-                // Insert order into database
-                txn->exec(
-                    "INSERT INTO backlog (order_id, item_id, quantity, creation_date, due_date) "
-                    "VALUES ($1, $2, $3, $4, $5)",
-                    pqxx::params(
-                        order.order_id,
-                        order.item_id,
-                        order.quantity,
-                        creation_date_str,
-                        due_date_str
-                    )
-                );
-                published_count++;
-                batch_count++;
-                //std::cout << "  -> Order published! (Total: " << published_count << ")" << std::endl;
-                
-                // Commit in batches to avoid losing all data on interruption
-                if (batch_count >= BATCH_SIZE) {
-                    txn->commit();
-                    std::cout << "  >> Batch committed (" << published_count << " orders saved)" << std::endl;
-                    txn = std::make_unique<pqxx::work>(conn); // Create new transaction
-                    batch_count = 0;
+            if (slice_end > published_count) {
+                // One transaction per slice, so an interruption only loses the current slice
+                pqxx::work txn(*conn);
+                if (slice_end - published_count < COPY_MIN_ORDERS) {
+                    insert_orders(txn, published_count, slice_end);
+                } else {
+                    copy_orders(txn, published_count, slice_end);
                 }
-                
-                break; // Exit the while loop to proceed to the next order
+                notify_published(txn, slice_end - published_count);
+                txn.commit();
+                published_count = slice_end;
             } else {
                 // Sleep for a short duration before checking again
                 std::this_thread::sleep_for(std::chrono::milliseconds(1000 / this->speed_up_factor_));
             }
-            }
         }
         
-        // Commit any remaining orders in the last batch
-        if (batch_count > 0) {
-            txn->commit();
-            std::cout << "  >> Final batch committed" << std::endl;
+        report_throughput(published_count, publish_start);
+
+    } catch (const std::exception &e) {
+        throw std::runtime_error("Failed to publish orders: " + std::string(e.what()));
+    }
+}
+
+void Publisher::publish_all() {
+    try {
+        std::cout << "Publisher ingesting " << backlog_.size() << " orders" << std::endl;
+        
+        DBConnector::Lease conn = db_connector_.acquire();
+        std::cout << "Database connected successfully" << std::endl;
+
+        auto publish_start = std::chrono::steady_clock::now();
+        const size_t BATCH_SIZE = 50000; // Commit every 50000 orders
+        
+        for (size_t begin = 0; begin < backlog_.size(); begin += BATCH_SIZE) {
+            size_t end = std::min(begin + BATCH_SIZE, backlog_.size());
+            pqxx::work txn(*conn);
+            copy_orders(txn, begin, end);
+            notify_published(txn, end - begin);
+            txn.commit();
+            std::cout << "  >> Batch committed (" << end << " orders saved)" << std::endl;
         }
         
-        std::cout << "Published " << published_count << " orders total" << std::endl;
-        conn.close(); // Close the connection
+        report_throughput(backlog_.size(), publish_start);
 
     } catch (const std::exception &e) {
         throw std::runtime_error("Failed to publish orders: " + std::string(e.what()));
     }
 }
 
+void Publisher::copy_orders(pqxx::work& txn, size_t begin, size_t end) const {
+    auto stream = pqxx::stream_to::table(
+        txn, {"backlog"}, {"order_id", "item_id", "quantity", "creation_date", "due_date"});
+    // Dates are formatted into stack buffers, no string per row
+    char creation_date[ISO8601_MAX_LENGTH];
+    char due_date[ISO8601_MAX_LENGTH];
+    for (size_t i = begin; i < end; i++) {
+        const Order& order = backlog_[i];
+        stream.write_values(
+            order.order_id,
+            order.item_id,
+            order.quantity,
+            std::string_view(creation_date, format_iso8601(order.creation_date, creation_date)),
+            std::string_view(due_date, format_iso8601(order.due_date, due_date))
+        );
+    }
+    stream.complete();
+}
+
+void Publisher::insert_orders(pqxx::work& txn, size_t begin, size_t end) const {
+    for (size_t i = begin; i < end; i++) {
+        const Order& order = backlog_[i];
+        txn.exec_prepared(
+            INSERT_ORDER_STMT,
+            order.order_id,
+            order.item_id,
+            order.quantity,
+            format_iso8601(order.creation_date),
+            format_iso8601(order.due_date)
+        );
+    }
+}
+
+void Publisher::notify_published(pqxx::work& txn, size_t count) const {
+    // Delivered to the listeners when txn commits, together with the rows
+    txn.exec_prepared(NOTIFY_BACKLOG_STMT, BACKLOG_CHANNEL, std::to_string(count));
+}
+
+void Publisher::report_throughput(size_t published_count, std::chrono::steady_clock::time_point start) const {
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Published " << published_count << " orders total in " << seconds << " s ("
+              << (seconds > 0 ? published_count / seconds : 0.0) << " orders/sec)" << std::endl;
+}
+
 }  // namespace SS
\ No newline at end of file
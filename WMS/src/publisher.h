@@ -30,12 +30,31 @@ public:
     // Generate backlog_ from a file
     void read_backlog_from_file();
 
-    // Publish orders to the database
+    // Publish orders to the database as they become due in simulation time
+    // Every time slice is written with a single COPY, or the prepared INSERT when it is small
     void publish();
 
+    // Publish the whole backlog immediately, as fast as the database accepts it
+    void publish_all();
+
     std::vector<Order> get_backlog() const { return backlog_; }
     
 private:
+    // COPY backlog_[begin, end) into the backlog table within txn
+    void copy_orders(pqxx::work& txn, size_t begin, size_t end) const;
+
+    // INSERT backlog_[begin, end) row by row with the prepared statement, cheaper than COPY for a few rows
+    void insert_orders(pqxx::work& txn, size_t begin, size_t end) const;
+
+    // Tell WES that count orders were published in txn
+    void notify_published(pqxx::work& txn, size_t count) const;
+
+    // Print the ingestion throughput
+    void report_throughput(size_t published_count, std::chrono::steady_clock::time_point start) const;
+
+    // Slices below this size skip the COPY setup
+    static constexpr size_t COPY_MIN_ORDERS = 16;
+
     const int speed_up_factor_;
     TimePoint start_date_;
     TimePoint end_date_;
@@ -1,13 +1,21 @@
 #include "publisher.h"
 #include "utils.h"
 #include <chrono>
+#include <string>
 
-int main() {
+// Usage: wms [--bulk]
+// --bulk ingests the whole backlog at once instead of replaying it in simulation time
+int main(int argc, char** argv) {
+    const bool bulk = argc > 1 && std::string(argv[1]) == "--bulk";
     SS::TimePoint start_time = SS::parse_iso8601("2025-10-09T00:00:00");
     SS::TimePoint end_time = start_time + std::chrono::hours(24) + std::chrono::minutes(10);
     SS::TimePoint sim_start = std::chrono::system_clock::now();
     SS::Publisher publisher(1, start_time, end_time, sim_start, "data/raw/backlog.json");
     publisher.read_backlog_from_file();
-    publisher.publish();
+    if (bulk) {
+        publisher.publish_all();
+    } else {
+        publisher.publish();
+    }
     return 0;
 }
\ No newline at end of file
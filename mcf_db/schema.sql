@@ -5,5 +5,30 @@ CREATE TABLE backlog (
 	creation_date TIMESTAMP,
 	due_date TIMESTAMP,
 	closure_date TIMESTAMP DEFAULT NULL,
-	status VARCHAR(11) DEFAULT 'PENDING'
+	status VARCHAR(11) DEFAULT 'PENDING',
+	seq BIGSERIAL, -- insertion order, WES fetches the rows above its watermark
+	zone INTEGER DEFAULT NULL, -- WES shard owning the order, NULL until the coordinator routes it
+	zone_seq BIGINT DEFAULT NULL -- routing order, shards fetch the rows of their zone above their watermark
+);
+
+CREATE INDEX backlog_seq_idx ON backlog (seq);
+CREATE INDEX backlog_zone_seq_idx ON backlog (zone, zone_seq);
+CREATE INDEX backlog_unrouted_idx ON backlog (seq) WHERE zone IS NULL AND status = 'PENDING';
+CREATE SEQUENCE backlog_zone_seq;
+
+-- Sharded WES: what every zone holds and claims, and its load, read by the coordinator
+CREATE TABLE zone_stock (
+	zone INTEGER,
+	item_id CHAR(17),
+	quantity INTEGER, -- units on the zone's racks
+	claimed INTEGER, -- units of the zone's open orders
+	PRIMARY KEY (zone, item_id)
+);
+
+CREATE TABLE zone_status (
+	zone INTEGER PRIMARY KEY,
+	tick INTEGER,
+	capacity INTEGER, -- capacity of the zone's last tick
+	open_units INTEGER, -- units of its open orders after that tick
+	updated_at TIMESTAMP DEFAULT now()
 );
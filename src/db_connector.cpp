@@ -1,8 +1,10 @@
 #include "db_connector.h"
+#include <algorithm>
 #include <cstdlib>
 #include <stdexcept>
 #include <fstream>
 #include <sstream>
+#include <thread>
 
 namespace SS {
 
@@ -57,6 +59,12 @@ void DBConnector::load_env_config() {
     db_host_ = env_host;
     db_port_ = env_port;
     db_password_ = env_password ? env_password : "";
+
+    // Optional, PoolOptions default otherwise
+    const char* env_pool_size = std::getenv("DB_POOL_SIZE");
+    if (env_pool_size) {
+        pool_options_.max_size = std::max(1, std::stoi(env_pool_size));
+    }
 }
 
 std::string DBConnector::get_connection_string() const {
@@ -76,4 +84,179 @@ pqxx::connection DBConnector::connect() const {
     return pqxx::connection(get_connection_string());
 }
 
+DBConnector::Lease DBConnector::acquire() {
+    std::unique_lock<std::mutex> lock(pool_mutex_);
+    pool_cv_.wait(lock, [this]() { return !idle_.empty() || open_ < pool_options_.max_size; });
+
+    std::unique_ptr<pqxx::connection> conn;
+    bool check = false;
+    const bool zone_statements = zone_statements_;
+    if (!idle_.empty()) {
+        // Most recently used first, it is the least likely to have been dropped by the server
+        check = std::chrono::steady_clock::now() - idle_.back().since >= pool_options_.health_check_idle;
+        conn = std::move(idle_.back().conn);
+        idle_.pop_back();
+    } else {
+        open_++;
+    }
+    lock.unlock();
+
+    // Network round trips happen outside the lock
+    try {
+        if (conn && check && !is_healthy(*conn)) {
+            conn.reset();
+        }
+        if (!conn) {
+            conn = open_pooled(zone_statements);
+        }
+    } catch (...) {
+        lock.lock();
+        open_--;
+        lock.unlock();
+        pool_cv_.notify_one();
+        throw;
+    }
+    return Lease(this, std::move(conn));
+}
+
+void DBConnector::release(std::unique_ptr<pqxx::connection> conn) {
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        if (conn->is_open()) {
+            idle_.push_back({std::move(conn), std::chrono::steady_clock::now()});
+        } else {
+            open_--; // reopened on demand by the next acquire
+        }
+    }
+    pool_cv_.notify_one();
+}
+
+std::unique_ptr<pqxx::connection> DBConnector::open_pooled(bool zone_statements) const {
+    std::chrono::milliseconds backoff = pool_options_.backoff;
+    for (int attempt = 0;; attempt++) {
+        try {
+            auto conn = std::make_unique<pqxx::connection>(get_connection_string());
+            prepare_statements(*conn);
+            if (zone_statements) {
+                prepare_zone_statements(*conn);
+            }
+            return conn;
+        } catch (const pqxx::broken_connection& e) {
+            if (attempt >= pool_options_.max_retries) {
+                throw std::runtime_error(
+                    "Could not connect to the database after " + std::to_string(attempt + 1) +
+                    " attempts: " + e.what()
+                );
+            }
+            std::this_thread::sleep_for(backoff);
+            backoff = std::min(backoff * 2, pool_options_.max_backoff);
+        }
+    }
+}
+
+bool DBConnector::is_healthy(pqxx::connection& conn) {
+    if (!conn.is_open()) {
+        return false;
+    }
+    try {
+        pqxx::nontransaction txn(conn);
+        txn.exec("SELECT 1");
+        return true;
+    } catch (const pqxx::failure&) {
+        return false;
+    }
+}
+
+void DBConnector::set_pool_options(const PoolOptions& options) {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    pool_options_ = options;
+    pool_options_.max_size = std::max<size_t>(1, pool_options_.max_size);
+}
+
+void DBConnector::enable_zone_statements() {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    if (zone_statements_) {
+        return;
+    }
+    zone_statements_ = true;
+    open_ -= idle_.size();
+    idle_.clear();
+}
+
+void DBConnector::prepare_statements(pqxx::connection& conn) {
+    // Delta since the seq watermark, see OrderManager::get_backlog_from_db
+    conn.prepare(FETCH_BACKLOG_STMT,
+        "SELECT seq, order_id, item_id, quantity, creation_date, due_date "
+        "FROM backlog WHERE status = 'PENDING' AND seq > $1 ORDER BY seq");
+    conn.prepare(EXPIRE_ORDERS_STMT,
+        "UPDATE backlog SET status = 'EXPIRED', closure_date = $1 "
+        "WHERE status = 'PENDING' AND due_date < $1");
+    // IDs travel as one array parameter, bpchar[] keeps the comparisons on CHAR and the primary key index usable
+    conn.prepare(COMPLETE_ORDERS_STMT,
+        "UPDATE backlog SET status = 'COMPLETED', closure_date = $1 WHERE order_id = ANY($2::bpchar[])");
+    conn.prepare(STOCK_OUT_ORDERS_STMT,
+        "UPDATE backlog SET status = 'STOCK_OUT', closure_date = $1 "
+        "WHERE status = 'PENDING' AND item_id = ANY($2::bpchar[])");
+    conn.prepare(INSERT_ORDER_STMT,
+        "INSERT INTO backlog (order_id, item_id, quantity, creation_date, due_date) "
+        "VALUES ($1, $2, $3, $4, $5)");
+    conn.prepare(NOTIFY_BACKLOG_STMT, "SELECT pg_notify($1, $2)");
+    conn.prepare(STOCK_OUT_ORDER_IDS_STMT,
+        "UPDATE backlog SET status = 'STOCK_OUT', closure_date = $1 "
+        "WHERE status = 'PENDING' AND order_id = ANY($2::bpchar[])");
+}
+
+void DBConnector::prepare_zone_statements(pqxx::connection& conn) {
+    // Zones, see ZoneCoordinator. zone_seq is drawn when the coordinator routes a row, so a
+    // shard's watermark on it works like the seq watermark of the unsharded fetch
+    conn.prepare(FETCH_ZONE_BACKLOG_STMT,
+        "SELECT zone_seq AS seq, order_id, item_id, quantity, creation_date, due_date "
+        "FROM backlog WHERE status = 'PENDING' AND zone = $2 AND zone_seq > $1 ORDER BY zone_seq");
+    conn.prepare(UNROUTE_ORDERS_STMT,
+        "UPDATE backlog SET zone = NULL, zone_seq = NULL "
+        "WHERE status = 'PENDING' AND order_id = ANY($1::bpchar[])");
+    conn.prepare(UNROUTE_ITEMS_STMT,
+        "UPDATE backlog SET zone = NULL, zone_seq = NULL "
+        "WHERE status = 'PENDING' AND zone = $1 AND item_id = ANY($2::bpchar[])");
+    conn.prepare(UPSERT_ZONE_STOCK_STMT,
+        "INSERT INTO zone_stock (zone, item_id, quantity, claimed) "
+        "SELECT $1, * FROM unnest($2::bpchar[], $3::int[], $4::int[]) "
+        "ON CONFLICT (zone, item_id) DO UPDATE SET quantity = EXCLUDED.quantity, claimed = EXCLUDED.claimed");
+    conn.prepare(UPSERT_ZONE_STATUS_STMT,
+        "INSERT INTO zone_status (zone, tick, capacity, open_units) VALUES ($1, $2, $3, $4) "
+        "ON CONFLICT (zone) DO UPDATE SET tick = EXCLUDED.tick, capacity = EXCLUDED.capacity, "
+        "open_units = EXCLUDED.open_units, updated_at = now()");
+    conn.prepare(FETCH_UNROUTED_STMT,
+        "SELECT order_id, item_id, quantity FROM backlog "
+        "WHERE status = 'PENDING' AND zone IS NULL ORDER BY seq LIMIT $1");
+    conn.prepare(ROUTE_ORDERS_STMT,
+        "UPDATE backlog SET zone = routed.zone, zone_seq = nextval('backlog_zone_seq') "
+        "FROM unnest($1::bpchar[], $2::int[]) AS routed(order_id, zone) "
+        "WHERE backlog.order_id = routed.order_id AND backlog.status = 'PENDING' AND backlog.zone IS NULL");
+    conn.prepare(FETCH_ZONE_STOCK_STMT,
+        "SELECT zone, item_id, quantity, claimed FROM zone_stock");
+    conn.prepare(FETCH_ZONE_STATUS_STMT, "SELECT zone, capacity, open_units FROM zone_status");
+}
+
+DBConnector::Lease::Lease(DBConnector* owner, std::unique_ptr<pqxx::connection> conn)
+    : owner_(owner), conn_(std::move(conn)) {
+}
+
+DBConnector::Lease& DBConnector::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        if (conn_) {
+            owner_->release(std::move(conn_));
+        }
+        owner_ = other.owner_;
+        conn_ = std::move(other.conn_);
+    }
+    return *this;
+}
+
+DBConnector::Lease::~Lease() {
+    if (conn_) {
+        owner_->release(std::move(conn_));
+    }
+}
+
 }
@@ -1,25 +1,110 @@
 #ifndef DB_CONNECTOR_H
 #define DB_CONNECTOR_H
 
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 #include <pqxx/pqxx>
 
 namespace SS {
 
+// NOTIFY channel the WMS publisher signals after committing new backlog rows
+// Payload: number of orders in the batch
+constexpr const char* BACKLOG_CHANNEL = "backlog_published";
+
+// Statements prepared on every pooled connection, see DBConnector::prepare_statements
+constexpr const char* FETCH_BACKLOG_STMT = "fetch_backlog";        // $1 seq watermark
+constexpr const char* EXPIRE_ORDERS_STMT = "expire_orders";        // $1 simulation date
+constexpr const char* COMPLETE_ORDERS_STMT = "complete_orders";    // $1 closure date, $2 order IDs
+constexpr const char* STOCK_OUT_ORDERS_STMT = "stock_out_orders";  // $1 closure date, $2 item IDs
+constexpr const char* INSERT_ORDER_STMT = "insert_order";          // $1..$5 order columns
+constexpr const char* NOTIFY_BACKLOG_STMT = "notify_backlog";      // $1 channel, $2 payload
+constexpr const char* STOCK_OUT_ORDER_IDS_STMT = "stock_out_order_ids";  // $1 closure date, $2 order IDs
+// Sharded deployment: the coordinator routes orders to zones, every WES shard owns one zone.
+// Prepared only once DBConnector::enable_zone_statements is called
+constexpr const char* FETCH_ZONE_BACKLOG_STMT = "fetch_zone_backlog";  // $1 zone_seq watermark, $2 zone
+constexpr const char* UNROUTE_ORDERS_STMT = "unroute_orders";          // $1 order IDs
+constexpr const char* UNROUTE_ITEMS_STMT = "unroute_items";            // $1 zone, $2 item IDs
+constexpr const char* UPSERT_ZONE_STOCK_STMT = "upsert_zone_stock";    // $1 zone, $2 item IDs, $3 quantities, $4 claimed
+constexpr const char* UPSERT_ZONE_STATUS_STMT = "upsert_zone_status";  // $1 zone, $2 tick, $3 capacity, $4 open units
+constexpr const char* FETCH_UNROUTED_STMT = "fetch_unrouted";          // $1 row limit
+constexpr const char* ROUTE_ORDERS_STMT = "route_orders";              // $1 order IDs, $2 zones
+constexpr const char* FETCH_ZONE_STOCK_STMT = "fetch_zone_stock";
+constexpr const char* FETCH_ZONE_STATUS_STMT = "fetch_zone_status";
+
+/**
+ * @brief Connection pool settings
+ */
+struct PoolOptions {
+    size_t max_size = 4;                                // Open connections at most (DB_POOL_SIZE)
+    std::chrono::milliseconds health_check_idle{30000}; // Ping connections idle longer than this before lending them
+    int max_retries = 5;                                // Reconnect attempts before giving up
+    std::chrono::milliseconds backoff{100};             // First reconnect delay, doubled every attempt
+    std::chrono::milliseconds max_backoff{5000};
+};
+
 /**
  * @brief Database connector for PostgreSQL
  * Reads configuration from environment variables
+ *
+ * Besides plain connections it keeps a thread-safe pool. Pooled connections are opened
+ * lazily up to PoolOptions::max_size, carry the prepared statements above and go back
+ * to the pool when their Lease is destroyed; broken ones are dropped and reopened with
+ * exponential backoff.
  */
 class DBConnector {
 public:
+    /**
+     * @brief Pooled connection, returned to the pool on destruction
+     * Must not outlive the DBConnector it came from
+     */
+    class Lease {
+    public:
+        Lease(Lease&& other) noexcept = default;
+        Lease& operator=(Lease&& other) noexcept;
+        ~Lease();
+
+        pqxx::connection& operator*() const { return *conn_; }
+        pqxx::connection* operator->() const { return conn_.get(); }
+
+    private:
+        friend class DBConnector;
+        Lease(DBConnector* owner, std::unique_ptr<pqxx::connection> conn);
+
+        DBConnector* owner_;
+        std::unique_ptr<pqxx::connection> conn_;
+    };
+
     // Constructor - loads config from environment variables
     DBConnector();
+
+    DBConnector(const DBConnector&) = delete;
+    DBConnector& operator=(const DBConnector&) = delete;
     
     // Get connection string
     std::string get_connection_string() const;
     
-    // Create a connection
+    // Create a connection outside the pool, without prepared statements
     pqxx::connection connect() const;
+
+    // Borrow a pooled connection, blocks while max_size connections are lent
+    Lease acquire();
+
+    // Register the *_STMT statements on conn. The backlog table must already exist,
+    // statements resolve it when they are prepared
+    static void prepare_statements(pqxx::connection& conn);
+    // The zone statements, they need the zone tables and backlog_zone_seq
+    static void prepare_zone_statements(pqxx::connection& conn);
+
+    // Coordinator and shards: pooled connections also carry the zone statements. Idle
+    // connections are closed and reopened with them, call it before lending any
+    void enable_zone_statements();
+
+    void set_pool_options(const PoolOptions& options);
+    const PoolOptions& get_pool_options() const { return pool_options_; }
     
     // Getters for configuration
     std::string get_dbname() const { return dbname_; }
@@ -33,6 +118,27 @@ private:
     std::string db_host_;
     std::string db_port_;
     std::string db_password_;
+
+    struct IdleConnection {
+        std::unique_ptr<pqxx::connection> conn;
+        std::chrono::steady_clock::time_point since;
+    };
+
+    PoolOptions pool_options_;
+    std::mutex pool_mutex_;
+    std::condition_variable pool_cv_;
+    std::vector<IdleConnection> idle_; // most recently returned last
+    size_t open_ = 0;                  // idle + lent
+    bool zone_statements_ = false;
+    
+    // Open a pooled connection, retrying with backoff while the server is unreachable
+    std::unique_ptr<pqxx::connection> open_pooled(bool zone_statements) const;
+
+    // Cheap round trip to check an idle connection is still usable
+    static bool is_healthy(pqxx::connection& conn);
+
+    // Take back a lent connection, broken ones are closed
+    void release(std::unique_ptr<pqxx::connection> conn);
     
     // Load .env file into environment
     void load_env_file();
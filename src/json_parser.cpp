@@ -0,0 +1,36 @@
+#include "json_parser.h"
+
+namespace SS {
+
+JsonParser default_json_parser() {
+#ifdef SS_WITH_SIMDJSON
+    return JsonParser::SIMD;
+#else
+    return JsonParser::SAX;
+#endif
+}
+
+bool has_json_parser(JsonParser parser) {
+    if (parser == JsonParser::SIMD) {
+#ifdef SS_WITH_SIMDJSON
+        return true;
+#else
+        return false;
+#endif
+    }
+    return true;
+}
+
+const char* to_string(JsonParser parser) {
+    switch (parser) {
+        case JsonParser::DOM:
+            return "dom";
+        case JsonParser::SAX:
+            return "sax";
+        case JsonParser::SIMD:
+            return "simd";
+    }
+    return "unknown";
+}
+
+}
@@ -0,0 +1,25 @@
+#ifndef JSON_PARSER_H
+#define JSON_PARSER_H
+
+namespace SS {
+
+/**
+ * @brief How the stock and backlog json files are read
+ */
+enum class JsonParser {
+    DOM,   // Whole nlohmann::json document first, then walked
+    SAX,   // nlohmann SAX events fill the target structures while the file streams in
+    SIMD   // simdjson On-Demand over the file buffer (SS_WITH_SIMDJSON builds only)
+};
+
+// SIMD when compiled in, SAX otherwise
+JsonParser default_json_parser();
+
+// Whether the parser was compiled in
+bool has_json_parser(JsonParser parser);
+
+const char* to_string(JsonParser parser);
+
+}
+
+#endif // JSON_PARSER_H
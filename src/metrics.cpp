@@ -0,0 +1,151 @@
+#include "metrics.h"
+#include <sstream>
+#include <stdexcept>
+#include <nlohmann/json.hpp>
+
+namespace SS {
+
+const char* to_string(Stage stage) {
+    switch (stage) {
+        case Stage::FETCH_BACKLOG:
+            return "fetch_backlog";
+        case Stage::BUILD_GRAPH:
+            return "build_graph";
+        case Stage::SOLVE:
+            return "solve";
+        case Stage::EXTRACT:
+            return "extract";
+        case Stage::COMPLETE_ORDERS:
+            return "complete_orders";
+        case Stage::PROCESS_TASKS:
+            return "process_tasks";
+        case Stage::WRITE_BACK:
+            return "write_back";
+        default:
+            return "unknown";
+    }
+}
+
+const char* to_string(Gauge gauge) {
+    switch (gauge) {
+        case Gauge::BACKLOG:
+            return "backlog_orders";
+        case Gauge::NODES:
+            return "graph_nodes";
+        case Gauge::ARCS:
+            return "graph_arcs";
+        case Gauge::FLOW:
+            return "flow";
+        case Gauge::COST:
+            return "cost";
+        case Gauge::QUEUE_DEPTH:
+            return "write_queue_depth";
+        case Gauge::RACKS_OPENED:
+            return "racks_opened";
+        default:
+            return "unknown";
+    }
+}
+
+void Histogram::observe(double ms) {
+    size_t i = 0;
+    while (i < BOUNDS_MS.size() && ms > BOUNDS_MS[i]) {
+        i++;
+    }
+    buckets_[i].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_ns_.fetch_add(static_cast<uint64_t>(ms > 0 ? ms * 1e6 : 0), std::memory_order_relaxed);
+}
+
+Metrics& Metrics::global() {
+    static Metrics metrics;
+    return metrics;
+}
+
+void Metrics::record(Stage stage, double ms) {
+    if (!enabled()) {
+        return;
+    }
+    const size_t i = static_cast<size_t>(stage);
+    histograms_[i].observe(ms);
+    tick_ns_[i].fetch_add(static_cast<uint64_t>(ms > 0 ? ms * 1e6 : 0), std::memory_order_relaxed);
+}
+
+void Metrics::set(Gauge gauge, long long value) {
+    if (!enabled()) {
+        return;
+    }
+    gauges_[static_cast<size_t>(gauge)].store(value, std::memory_order_relaxed);
+}
+
+void Metrics::open_jsonl(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jsonl_ = std::ofstream(path, std::ios::trunc);
+    if (!jsonl_.is_open()) {
+        throw std::runtime_error("Could not open metrics file: " + path);
+    }
+}
+
+void Metrics::end_tick(int tick) {
+    if (!enabled()) {
+        return;
+    }
+    TickRecord record;
+    record.tick = tick;
+    for (size_t i = 0; i < NUM_STAGES; i++) {
+        record.stage_ms[i] = tick_ns_[i].exchange(0, std::memory_order_relaxed) / 1e6;
+    }
+    for (size_t i = 0; i < NUM_GAUGES; i++) {
+        record.gauges[i] = gauges_[i].load(std::memory_order_relaxed);
+    }
+    ticks_.fetch_add(1, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    last_tick_ = record;
+    if (jsonl_.is_open()) {
+        nlohmann::json line = {{"tick", tick}};
+        for (size_t i = 0; i < NUM_STAGES; i++) {
+            line[std::string(to_string(static_cast<Stage>(i))) + "_ms"] = record.stage_ms[i];
+        }
+        for (size_t i = 0; i < NUM_GAUGES; i++) {
+            line[to_string(static_cast<Gauge>(i))] = record.gauges[i];
+        }
+        // Flushed per tick, so a tail -f or a crash sees every closed tick
+        jsonl_ << line.dump() << std::endl;
+    }
+}
+
+TickRecord Metrics::last_tick() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return last_tick_;
+}
+
+std::string Metrics::prometheus_text() const {
+    std::ostringstream out;
+    out << "# HELP wes_stage_ms Wall time of a WES stage in milliseconds\n"
+        << "# TYPE wes_stage_ms histogram\n";
+    for (size_t i = 0; i < NUM_STAGES; i++) {
+        const Histogram& histogram = histograms_[i];
+        const char* stage = to_string(static_cast<Stage>(i));
+        uint64_t cumulative = 0;
+        for (size_t b = 0; b < Histogram::BOUNDS_MS.size(); b++) {
+            cumulative += histogram.bucket(b);
+            out << "wes_stage_ms_bucket{stage=\"" << stage << "\",le=\"" << Histogram::BOUNDS_MS[b] << "\"} "
+                << cumulative << "\n";
+        }
+        cumulative += histogram.bucket(Histogram::BOUNDS_MS.size());
+        out << "wes_stage_ms_bucket{stage=\"" << stage << "\",le=\"+Inf\"} " << cumulative << "\n"
+            << "wes_stage_ms_sum{stage=\"" << stage << "\"} " << histogram.sum_ms() << "\n"
+            << "wes_stage_ms_count{stage=\"" << stage << "\"} " << histogram.count() << "\n";
+    }
+    for (size_t i = 0; i < NUM_GAUGES; i++) {
+        const char* gauge = to_string(static_cast<Gauge>(i));
+        out << "# TYPE wes_" << gauge << " gauge\n"
+            << "wes_" << gauge << " " << gauges_[i].load(std::memory_order_relaxed) << "\n";
+    }
+    out << "# TYPE wes_ticks_total counter\n"
+        << "wes_ticks_total " << ticks() << "\n";
+    return out.str();
+}
+
+}
@@ -0,0 +1,158 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+namespace SS {
+
+/**
+ * @brief Timed sections of a WES tick
+ */
+enum class Stage {
+    FETCH_BACKLOG,    // OrderManager::get_backlog_from_db
+    BUILD_GRAPH,      // MCF graph construction, delta application for INCREMENTAL
+    SOLVE,            // Min cost flow solve
+    EXTRACT,          // Solution extraction and stock decrements
+    COMPLETE_ORDERS,  // Completed orders written back
+    PROCESS_TASKS,    // TaskExecutor::process_tasks, once per tick
+    WRITE_BACK,       // Whole write-back transaction
+    COUNT
+};
+
+/**
+ * @brief Last value of a per-tick quantity
+ */
+enum class Gauge {
+    BACKLOG,          // Orders fetched
+    NODES,            // MCF nodes, 0 for the engines without an explicit graph
+    ARCS,             // MCF arcs, same
+    FLOW,             // Units assigned by the solve
+    COST,             // MCF objective
+    QUEUE_DEPTH,      // Write-backs waiting
+    RACKS_OPENED,     // Distinct racks in the taskpool of the solve
+    COUNT
+};
+
+constexpr size_t NUM_STAGES = static_cast<size_t>(Stage::COUNT);
+constexpr size_t NUM_GAUGES = static_cast<size_t>(Gauge::COUNT);
+
+const char* to_string(Stage stage);
+const char* to_string(Gauge gauge);
+
+/**
+ * @brief Lock-free latency histogram with fixed millisecond buckets
+ */
+class Histogram {
+public:
+    // Upper bounds in ms, the last bucket is +Inf
+    static constexpr std::array<double, 15> BOUNDS_MS = {
+        0.1, 0.25, 0.5, 1, 2.5, 5, 10, 25, 50, 100, 250, 500, 1000, 2500, 5000};
+
+    void observe(double ms);
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    double sum_ms() const { return sum_ns_.load(std::memory_order_relaxed) / 1e6; }
+
+    // Observations in bucket i alone, i == BOUNDS_MS.size() is the +Inf bucket
+    uint64_t bucket(size_t i) const { return buckets_[i].load(std::memory_order_relaxed); }
+
+private:
+    std::array<std::atomic<uint64_t>, BOUNDS_MS.size() + 1> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_ns_{0};
+};
+
+/**
+ * @brief Stage times and gauges of one tick
+ */
+struct TickRecord {
+    int tick = 0;
+    std::array<double, NUM_STAGES> stage_ms{};
+    std::array<long long, NUM_GAUGES> gauges{};
+};
+
+/**
+ * @brief Process-wide instrumentation of the WES hot path
+ *
+ * Stage times go into a histogram each and add up into the open tick; end_tick()
+ * closes the tick and appends it as one JSON line to the sink, if any. Recording is
+ * lock-free, so the plan and write-back threads can both report. Disabled by default:
+ * a ScopedTimer then costs one relaxed load and no clock read.
+ * A write-back is counted in the tick during which it finished.
+ */
+class Metrics {
+public:
+    static Metrics& global();
+
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+    void set_enabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+
+    void record(Stage stage, double ms);
+    void set(Gauge gauge, long long value);
+
+    // Append the tick records to path as JSON lines, truncating it
+    void open_jsonl(const std::string& path);
+
+    // Close the open tick as number tick and start the next one
+    void end_tick(int tick);
+
+    // Last closed tick
+    TickRecord last_tick() const;
+
+    const Histogram& histogram(Stage stage) const { return histograms_[static_cast<size_t>(stage)]; }
+    uint64_t ticks() const { return ticks_.load(std::memory_order_relaxed); }
+
+    // Prometheus text exposition of the histograms, gauges and tick counter
+    std::string prometheus_text() const;
+
+private:
+    Metrics() = default;
+
+    std::atomic<bool> enabled_{false};
+    std::array<Histogram, NUM_STAGES> histograms_;
+    std::array<std::atomic<long long>, NUM_GAUGES> gauges_{};
+    std::array<std::atomic<uint64_t>, NUM_STAGES> tick_ns_{};   // Open tick
+    std::atomic<uint64_t> ticks_{0};
+
+    mutable std::mutex mutex_;   // Guards the sink and last_tick_
+    std::ofstream jsonl_;
+    TickRecord last_tick_;
+};
+
+/**
+ * @brief Records the time until the end of the scope as a stage, if metrics are enabled
+ */
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Stage stage) : stage_(stage), active_(Metrics::global().enabled()) {
+        if (active_) {
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~ScopedTimer() {
+        if (active_) {
+            Metrics::global().record(stage_, std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start_).count());
+        }
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Stage stage_;
+    bool active_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+}
+
+#endif // METRICS_H
@@ -0,0 +1,104 @@
+#include "metrics_server.h"
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace SS {
+
+namespace {
+
+// How often the listener checks for shutdown
+constexpr int POLL_TIMEOUT_MS = 200;
+
+void send_all(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            return;
+        }
+        sent += static_cast<size_t>(n);
+    }
+}
+
+}
+
+MetricsServer::MetricsServer(const Metrics& metrics, int port) : metrics_(metrics) {
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) {
+        throw std::runtime_error("Could not create the metrics socket");
+    }
+    int reuse = 1;
+    ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0
+        || ::listen(listen_fd_, 8) != 0) {
+        ::close(listen_fd_);
+        throw std::runtime_error("Could not listen for metrics on port " + std::to_string(port));
+    }
+    socklen_t length = sizeof(addr);
+    ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &length);
+    port_ = ntohs(addr.sin_port);
+
+    thread_ = std::thread([this]() { serve(); });
+}
+
+MetricsServer::~MetricsServer() {
+    stop_ = true;
+    thread_.join();
+    ::close(listen_fd_);
+}
+
+void MetricsServer::serve() {
+    pollfd listener{listen_fd_, POLLIN, 0};
+    while (!stop_) {
+        listener.revents = 0;
+        if (::poll(&listener, 1, POLL_TIMEOUT_MS) <= 0) {
+            continue;
+        }
+        int client = ::accept(listen_fd_, nullptr, nullptr);
+        if (client < 0) {
+            continue;
+        }
+        handle(client);
+        ::close(client);
+    }
+}
+
+void MetricsServer::handle(int client) const {
+    // Only the request line matters, a scrape request fits in one read
+    char request[1024];
+    pollfd readable{client, POLLIN, 0};
+    if (::poll(&readable, 1, POLL_TIMEOUT_MS) <= 0) {
+        return;
+    }
+    ssize_t n = ::recv(client, request, sizeof(request) - 1, 0);
+    if (n <= 0) {
+        return;
+    }
+    request[n] = '\0';
+
+    std::string status = "200 OK";
+    std::string body;
+    if (std::strncmp(request, "GET /metrics ", 13) == 0 || std::strncmp(request, "GET / ", 6) == 0) {
+        body = metrics_.prometheus_text();
+    } else {
+        status = "404 Not Found";
+        body = "Not found\n";
+    }
+    send_all(client, "HTTP/1.1 " + status + "\r\n"
+                     "Content-Type: text/plain; version=0.0.4\r\n"
+                     "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                     "Connection: close\r\n\r\n" + body);
+}
+
+}
@@ -0,0 +1,42 @@
+#ifndef METRICS_SERVER_H
+#define METRICS_SERVER_H
+
+#include <atomic>
+#include <thread>
+#include "metrics.h"
+
+namespace SS {
+
+/**
+ * @brief Minimal HTTP listener serving Metrics::prometheus_text() on GET /metrics
+ *
+ * Bound to 127.0.0.1 only, one connection at a time on its own thread. Scrapes are
+ * rare and small, anything fancier would cost more than it saves.
+ */
+class MetricsServer {
+public:
+    // Listen on port, 0 picks a free one
+    MetricsServer(const Metrics& metrics, int port);
+
+    // Stops the listener thread
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    int port() const { return port_; }
+
+private:
+    void serve();
+    void handle(int client) const;
+
+    const Metrics& metrics_;
+    int listen_fd_ = -1;
+    int port_ = 0;
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
+
+}
+
+#endif // METRICS_SERVER_H
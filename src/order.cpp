@@ -1,7 +1,321 @@
 #include "order.h"
+#include <fstream>
+#include <stdexcept>
+#include <nlohmann/json.hpp>
+#ifdef SS_WITH_SIMDJSON
+#include <simdjson.h>
+#endif
+#include "snapshot.h"
+#include "symbol_table.h"
+#include "utils.h"
 
 namespace SS {
 
-// Implementation will go here
+namespace {
+
+// Field values of the order being read by a streaming parser
+struct OrderFields {
+    enum : unsigned { ORDER_ID = 1, ITEM_ID = 2, QUANTITY = 4, CREATION_DATE = 8, DUE_DATE = 16, ALL = 31 };
+
+    std::string order_id;
+    std::string item_id;
+    int quantity = 0;
+    std::string creation_date;
+    std::string due_date;
+    unsigned seen = 0;
+
+    void push_to(std::vector<Order>& orders, const std::string& file_path) {
+        if (seen != ALL) {
+            throw std::runtime_error("Incomplete order #" + std::to_string(orders.size()) + " in backlog file: " + file_path);
+        }
+        orders.push_back(Order{order_id, item_id, quantity, parse_iso8601(creation_date), parse_iso8601(due_date)});
+        seen = 0;
+    }
+};
+
+/**
+ * @brief nlohmann SAX handler for {"orders": [{...}, ...]}
+ * Depth 1 is the root object, 2 the orders array, 3 an order; anything else is skipped
+ */
+class OrderSaxHandler {
+public:
+    OrderSaxHandler(std::vector<Order>& orders, const std::string& file_path)
+        : orders_(orders), file_path_(file_path) {}
+
+    bool null() { return true; }
+    bool boolean(bool) { return true; }
+    bool number_integer(nlohmann::json::number_integer_t value) { return number(value); }
+    bool number_unsigned(nlohmann::json::number_unsigned_t value) { return number(static_cast<long long>(value)); }
+    bool number_float(nlohmann::json::number_float_t, const std::string&) { return true; }
+    bool binary(nlohmann::json::binary_t&) { return true; }
+
+    bool string(std::string& value) {
+        if (in_order()) {
+            if (key_ == "order_id") {
+                fields_.order_id = std::move(value);
+                fields_.seen |= OrderFields::ORDER_ID;
+            } else if (key_ == "item_id") {
+                fields_.item_id = std::move(value);
+                fields_.seen |= OrderFields::ITEM_ID;
+            } else if (key_ == "creation_date") {
+                fields_.creation_date = std::move(value);
+                fields_.seen |= OrderFields::CREATION_DATE;
+            } else if (key_ == "due_date") {
+                fields_.due_date = std::move(value);
+                fields_.seen |= OrderFields::DUE_DATE;
+            }
+        }
+        return true;
+    }
+
+    bool key(std::string& key) {
+        if (depth_ == 1) {
+            in_orders_key_ = key == "orders";
+        } else if (in_order()) {
+            key_ = std::move(key);
+        }
+        return true;
+    }
+
+    bool start_object(std::size_t) {
+        depth_++;
+        return true;
+    }
+
+    bool end_object() {
+        if (in_order()) {
+            fields_.push_to(orders_, file_path_);
+        }
+        depth_--;
+        return true;
+    }
+
+    bool start_array(std::size_t) {
+        depth_++;
+        if (depth_ == 2 && in_orders_key_) {
+            in_orders_ = true;
+        }
+        return true;
+    }
+
+    bool end_array() {
+        if (depth_ == 2) {
+            in_orders_ = false;
+        }
+        depth_--;
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex) {
+        throw std::runtime_error("Could not parse backlog file " + file_path_ + ": " + ex.what());
+    }
+
+private:
+    bool in_order() const { return in_orders_ && depth_ == 3; }
+
+    bool number(long long value) {
+        if (in_order() && key_ == "quantity") {
+            fields_.quantity = static_cast<int>(value);
+            fields_.seen |= OrderFields::QUANTITY;
+        }
+        return true;
+    }
+
+    std::vector<Order>& orders_;
+    const std::string& file_path_;
+    OrderFields fields_;
+    std::string key_;
+    int depth_ = 0;
+    bool in_orders_key_ = false;
+    bool in_orders_ = false;
+};
+
+std::vector<Order> read_orders_dom(const std::string& file_path) {
+    std::ifstream file(file_path);
+    
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open backlog file: " + file_path);
+    }
+
+    nlohmann::json json_data;
+    file >> json_data;  // Read the JSON from the file
+    
+    std::vector<Order> orders;
+    if (json_data.contains("orders")) {
+        orders.reserve(json_data["orders"].size());
+        for (const auto &order_json : json_data["orders"]) {
+            std::string creation_date_str = order_json["creation_date"].get<std::string>();
+            std::string due_date_str = order_json["due_date"].get<std::string>();
+            
+            orders.push_back(Order{
+                order_json["order_id"].get<std::string>(),
+                order_json["item_id"].get<std::string>(),
+                order_json["quantity"].get<int>(),
+                parse_iso8601(creation_date_str),
+                parse_iso8601(due_date_str)
+            });
+        }
+    }
+    return orders;
+}
+
+std::vector<Order> read_orders_sax(const std::string& file_path) {
+    std::ifstream file(file_path, std::ios::binary);
+    
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open backlog file: " + file_path);
+    }
+
+    std::vector<Order> orders;
+    OrderSaxHandler handler(orders, file_path);
+    nlohmann::json::sax_parse(file, &handler);
+    return orders;
+}
+
+#ifdef SS_WITH_SIMDJSON
+std::vector<Order> read_orders_simd(const std::string& file_path) {
+    simdjson::padded_string json;
+    if (simdjson::padded_string::load(file_path).get(json)) {
+        throw std::runtime_error("Could not open backlog file: " + file_path);
+    }
+
+    std::vector<Order> orders;
+    try {
+        simdjson::ondemand::parser parser;
+        simdjson::ondemand::document doc = parser.iterate(json);
+        simdjson::ondemand::array orders_json;
+        if (doc["orders"].get_array().get(orders_json)) {
+            return orders; // No orders array, same as the DOM path
+        }
+        OrderFields fields;
+        for (simdjson::ondemand::object order_json : orders_json) {
+            for (auto field : order_json) {
+                std::string_view key = field.unescaped_key();
+                if (key == "order_id") {
+                    fields.order_id = std::string_view(field.value().get_string());
+                    fields.seen |= OrderFields::ORDER_ID;
+                } else if (key == "item_id") {
+                    fields.item_id = std::string_view(field.value().get_string());
+                    fields.seen |= OrderFields::ITEM_ID;
+                } else if (key == "quantity") {
+                    fields.quantity = static_cast<int>(int64_t(field.value().get_int64()));
+                    fields.seen |= OrderFields::QUANTITY;
+                } else if (key == "creation_date") {
+                    fields.creation_date = std::string_view(field.value().get_string());
+                    fields.seen |= OrderFields::CREATION_DATE;
+                } else if (key == "due_date") {
+                    fields.due_date = std::string_view(field.value().get_string());
+                    fields.seen |= OrderFields::DUE_DATE;
+                }
+            }
+            fields.push_to(orders, file_path);
+        }
+    } catch (const simdjson::simdjson_error& e) {
+        throw std::runtime_error("Could not parse backlog file " + file_path + ": " + e.what());
+    }
+    return orders;
+}
+#endif
+
+}
+
+namespace {
+
+// Backlog snapshot sections, string tables take two ids
+enum BacklogSection : uint32_t {
+    ORDER_IDS = 1,
+    ITEM_IDS = 3,
+    ORDER_RECORDS = 5
+};
+
+// Fixed-size part of an order, item is an index into ITEM_IDS
+struct OrderRecord {
+    int64_t creation_ns;
+    int64_t due_ns;
+    int64_t closure_ns;
+    int32_t quantity;
+    int32_t priority;
+    uint32_t item;
+    uint32_t status;
+};
+
+int64_t to_ns(const TimePoint& date) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(date.time_since_epoch()).count();
+}
+
+TimePoint from_ns(int64_t ns) {
+    return TimePoint(std::chrono::duration_cast<TimePoint::duration>(std::chrono::nanoseconds(ns)));
+}
+
+}
+
+void write_orders_snapshot(const std::string& file_path, const std::vector<Order>& orders) {
+    std::vector<std::string> order_ids;
+    std::vector<OrderRecord> records;
+    SymbolTable item_ids;
+    order_ids.reserve(orders.size());
+    records.reserve(orders.size());
+    for (const auto& order : orders) {
+        order_ids.push_back(order.order_id);
+        records.push_back({to_ns(order.creation_date), to_ns(order.due_date), to_ns(order.closure_date),
+                           order.quantity, order.priority, item_ids.intern(order.item_id),
+                           static_cast<uint32_t>(order.status)});
+    }
+
+    SnapshotWriter writer(SnapshotKind::BACKLOG);
+    writer.add_strings(ORDER_IDS, order_ids);
+    writer.add_strings(ITEM_IDS, item_ids.names());
+    writer.add(ORDER_RECORDS, records);
+    writer.write(file_path);
+}
+
+std::vector<Order> read_orders_snapshot(const std::string& file_path) {
+    SnapshotReader snapshot(file_path, SnapshotKind::BACKLOG);
+    SnapshotStrings order_ids = snapshot.strings(ORDER_IDS);
+    SnapshotStrings item_ids = snapshot.strings(ITEM_IDS);
+    SnapshotArray<OrderRecord> records = snapshot.get<OrderRecord>(ORDER_RECORDS);
+    if (records.size != order_ids.size()) {
+        throw std::runtime_error("Corrupt backlog snapshot (orders): " + file_path);
+    }
+
+    std::vector<Order> orders;
+    orders.reserve(records.size);
+    for (size_t i = 0; i < records.size; i++) {
+        const OrderRecord& record = records[i];
+        if (record.item >= item_ids.size() || record.status > static_cast<uint32_t>(OrderStatus::STOCK_OUT)) {
+            throw std::runtime_error("Corrupt backlog snapshot (order #" + std::to_string(i) + "): " + file_path);
+        }
+        orders.push_back(Order{std::string(order_ids[i]), std::string(item_ids[record.item]), record.quantity,
+                               from_ns(record.creation_ns), from_ns(record.due_ns)});
+        Order& order = orders.back();
+        order.priority = record.priority;
+        order.closure_date = from_ns(record.closure_ns);
+        order.status = static_cast<OrderStatus>(record.status);
+    }
+    return orders;
+}
+
+std::vector<Order> read_orders(const std::string& file_path, JsonParser parser) {
+    if (is_snapshot(file_path)) {
+        return read_orders_snapshot(file_path);
+    }
+    return read_orders_json(file_path, parser);
+}
+
+std::vector<Order> read_orders_json(const std::string& file_path, JsonParser parser) {
+    switch (parser) {
+        case JsonParser::DOM:
+            return read_orders_dom(file_path);
+        case JsonParser::SAX:
+            return read_orders_sax(file_path);
+#ifdef SS_WITH_SIMDJSON
+        case JsonParser::SIMD:
+            return read_orders_simd(file_path);
+#endif
+        default:
+            throw std::runtime_error(std::string("Error: json parser ") + to_string(parser)
+                                     + " is not available in this build.");
+    }
+}
 
 }
@@ -2,7 +2,10 @@
 #define ORDER_H
 
 #include <map>
+#include <string>
+#include <vector>
 #include "types.h"
+#include "json_parser.h"
 
 namespace SS {
 
@@ -15,8 +18,9 @@ constexpr const char* PENDING = "Pending";
 constexpr const char* PROCESSING = "Processing";
 constexpr const char* COMPLETED = "Completed";
 constexpr const char* EXPIRED = "Expired";
+constexpr const char* STOCK_OUT = "Stock out";
 
-enum class OrderStatus { PENDING, PROCESSING, COMPLETED, EXPIRED };
+enum class OrderStatus { PENDING, PROCESSING, COMPLETED, EXPIRED, STOCK_OUT };
 
 // Order structure
 struct Order
@@ -29,10 +33,24 @@ struct Order
     int priority = 0;
     TimePoint closure_date = {};
     OrderStatus status = OrderStatus::PENDING;
+    OrderIdx order_idx = INVALID_IDX; // Interned order ID
+    ItemIdx item_idx = INVALID_IDX; // Interned item ID, INVALID_IDX if the item is not stocked
 };
 
 // Map of OrderID to Order
 using Orders = std::map<OrderID, Order>;
+
+// Read the "orders" array of a backlog json file, in file order
+std::vector<Order> read_orders_json(const std::string& file_path, JsonParser parser = default_json_parser());
+
+// Write orders as a binary backlog snapshot, statuses, priorities and closure dates included
+void write_orders_snapshot(const std::string& file_path, const std::vector<Order>& orders);
+
+// Read a backlog snapshot written by write_orders_snapshot, in the same order
+std::vector<Order> read_orders_snapshot(const std::string& file_path);
+
+// Read a backlog json file or snapshot, whichever file_path holds
+std::vector<Order> read_orders(const std::string& file_path, JsonParser parser = default_json_parser());
 }
 
 #endif // ORDER_H
@@ -0,0 +1,204 @@
+#include "snapshot.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace SS {
+
+namespace {
+
+constexpr char SNAPSHOT_MAGIC[8] = {'S', 'S', 'S', 'N', 'A', 'P', '\0', '\0'};
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+constexpr uint64_t SECTION_ALIGNMENT = 8;
+
+uint64_t align_up(uint64_t offset) {
+    return (offset + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1);
+}
+
+}
+
+bool is_snapshot(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    char magic[sizeof(SNAPSHOT_MAGIC)] = {};
+    if (!file.read(magic, sizeof(magic))) {
+        return false;
+    }
+    return std::memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) == 0;
+}
+
+MappedFile::MappedFile(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Could not open snapshot file: " + path);
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Could not stat snapshot file: " + path);
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ > 0) {
+        void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Could not map snapshot file: " + path);
+        }
+        data_ = static_cast<const uint8_t*>(addr);
+        // Loads walk every section front to back
+        ::madvise(addr, size_, MADV_SEQUENTIAL);
+    }
+    // The mapping stays valid after the descriptor is closed
+    ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+    unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept : data_(other.data_), size_(other.size_) {
+    other.data_ = nullptr;
+    other.size_ = 0;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        data_ = other.data_;
+        size_ = other.size_;
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+    return *this;
+}
+
+void MappedFile::unmap() {
+    if (data_) {
+        ::munmap(const_cast<uint8_t*>(data_), size_);
+        data_ = nullptr;
+        size_ = 0;
+    }
+}
+
+void SnapshotWriter::add_strings(uint32_t id, const std::vector<std::string>& strings) {
+    std::vector<uint32_t> offsets;
+    offsets.reserve(strings.size() + 1);
+    std::string chars;
+    offsets.push_back(0);
+    for (const auto& value : strings) {
+        chars += value;
+        if (chars.size() > UINT32_MAX) {
+            throw std::runtime_error("String table too large for a snapshot");
+        }
+        offsets.push_back(static_cast<uint32_t>(chars.size()));
+    }
+    add(id, offsets);
+    add(id + 1, chars.data(), chars.size());
+}
+
+void SnapshotWriter::write(const std::string& path) const {
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = SNAPSHOT_VERSION;
+    header.kind = static_cast<uint32_t>(kind_);
+    header.byte_order = BYTE_ORDER_MARK;
+    header.num_sections = static_cast<uint32_t>(sections_.size());
+
+    std::vector<SnapshotSection> table;
+    uint64_t offset = align_up(sizeof(SnapshotHeader) + sections_.size() * sizeof(SnapshotSection));
+    for (const Section& section : sections_) {
+        table.push_back({section.id, section.elem_size, offset, section.count});
+        offset = align_up(offset + section.bytes.size());
+    }
+    header.file_size = offset;
+
+    const std::string tmp_path = path + ".tmp";
+    std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open snapshot file: " + tmp_path);
+    }
+    const char padding[SECTION_ALIGNMENT] = {};
+    auto pad_to = [&](uint64_t target) {
+        const uint64_t position = static_cast<uint64_t>(file.tellp());
+        file.write(padding, static_cast<std::streamsize>(target - position));
+    };
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(SnapshotSection));
+    for (size_t i = 0; i < sections_.size(); i++) {
+        pad_to(table[i].offset);
+        file.write(reinterpret_cast<const char*>(sections_[i].bytes.data()), sections_[i].bytes.size());
+    }
+    pad_to(header.file_size);
+    file.close();
+    if (!file) {
+        throw std::runtime_error("Could not write snapshot file: " + tmp_path);
+    }
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Could not rename snapshot file to: " + path);
+    }
+}
+
+SnapshotReader::SnapshotReader(const std::string& path, SnapshotKind kind) : path_(path), file_(path) {
+    if (file_.size() < sizeof(SnapshotHeader)) {
+        throw std::runtime_error("Snapshot file is truncated: " + path);
+    }
+    SnapshotHeader header;
+    std::memcpy(&header, file_.data(), sizeof(header));
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+        throw std::runtime_error("Not a snapshot file: " + path);
+    }
+    if (header.version != SNAPSHOT_VERSION) {
+        throw std::runtime_error("Unsupported snapshot version " + std::to_string(header.version) + ": " + path);
+    }
+    if (header.byte_order != BYTE_ORDER_MARK) {
+        throw std::runtime_error("Snapshot written with another byte order: " + path);
+    }
+    if (header.kind != static_cast<uint32_t>(kind)) {
+        throw std::runtime_error("Snapshot holds another kind of data: " + path);
+    }
+    if (header.file_size != file_.size()
+        || sizeof(SnapshotHeader) + static_cast<uint64_t>(header.num_sections) * sizeof(SnapshotSection) > file_.size()) {
+        throw std::runtime_error("Snapshot file is truncated: " + path);
+    }
+
+    sections_ = reinterpret_cast<const SnapshotSection*>(file_.data() + sizeof(SnapshotHeader));
+    num_sections_ = header.num_sections;
+    for (uint32_t i = 0; i < num_sections_; i++) {
+        const SnapshotSection& section = sections_[i];
+        if (section.offset % SECTION_ALIGNMENT != 0 || section.offset > file_.size()
+            || (section.elem_size > 0 && section.count > (file_.size() - section.offset) / section.elem_size)) {
+            throw std::runtime_error("Snapshot section " + std::to_string(section.id) + " is out of bounds: " + path);
+        }
+    }
+}
+
+const SnapshotSection& SnapshotReader::find(uint32_t id, size_t elem_size) const {
+    for (uint32_t i = 0; i < num_sections_; i++) {
+        if (sections_[i].id == id) {
+            if (sections_[i].elem_size != elem_size) {
+                throw std::runtime_error("Snapshot section " + std::to_string(id) + " has an unexpected layout: " + path_);
+            }
+            return sections_[i];
+        }
+    }
+    throw std::runtime_error("Snapshot section " + std::to_string(id) + " is missing: " + path_);
+}
+
+SnapshotStrings SnapshotReader::strings(uint32_t id) const {
+    SnapshotStrings strings{get<uint32_t>(id), get<char>(id + 1)};
+    if (strings.offsets.size == 0 || strings.offsets[0] != 0) {
+        throw std::runtime_error("Snapshot string table " + std::to_string(id) + " is corrupt: " + path_);
+    }
+    for (size_t i = 1; i < strings.offsets.size; i++) {
+        if (strings.offsets[i] < strings.offsets[i - 1] || strings.offsets[i] > strings.chars.size) {
+            throw std::runtime_error("Snapshot string table " + std::to_string(id) + " is corrupt: " + path_);
+        }
+    }
+    return strings;
+}
+
+}
@@ -0,0 +1,163 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace SS {
+
+/**
+ * @brief What a snapshot file holds
+ */
+enum class SnapshotKind : uint32_t {
+    STOCK = 1,    // StockManager state
+    BACKLOG = 2   // Orders
+};
+
+// Bumped on any layout change, other versions are rejected
+constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+// File layout: header, section table, then the sections, each 8-byte aligned
+struct SnapshotHeader {
+    char magic[8];           // "SSSNAP\0\0"
+    uint32_t version;
+    uint32_t kind;           // SnapshotKind
+    uint32_t byte_order;     // 0x01020304 as written by the producer
+    uint32_t num_sections;
+    uint64_t file_size;
+};
+
+struct SnapshotSection {
+    uint32_t id;
+    uint32_t elem_size;
+    uint64_t offset;         // From the start of the file
+    uint64_t count;          // Elements
+};
+
+// True if the file starts with the snapshot magic, false for json or unreadable files
+bool is_snapshot(const std::string& path);
+
+/**
+ * @brief Read-only mmap of a whole file
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    void unmap();
+
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+/**
+ * @brief Array section viewed in place in the mapping
+ */
+template <typename T>
+struct SnapshotArray {
+    const T* data = nullptr;
+    size_t size = 0;
+
+    const T* begin() const { return data; }
+    const T* end() const { return data + size; }
+    const T& operator[](size_t i) const { return data[i]; }
+    std::vector<T> to_vector() const { return std::vector<T>(begin(), end()); }
+};
+
+/**
+ * @brief String table section: size()+1 offsets into a character blob
+ */
+struct SnapshotStrings {
+    SnapshotArray<uint32_t> offsets;
+    SnapshotArray<char> chars;
+
+    size_t size() const { return offsets.size > 0 ? offsets.size - 1 : 0; }
+    std::string_view operator[](size_t i) const {
+        return std::string_view(chars.data + offsets[i], offsets[i + 1] - offsets[i]);
+    }
+};
+
+/**
+ * @brief Collects sections and writes them as one snapshot file
+ */
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(SnapshotKind kind) : kind_(kind) {}
+
+    template <typename T>
+    void add(uint32_t id, const T* data, size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot sections hold plain data");
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+        sections_.push_back({id, static_cast<uint32_t>(sizeof(T)), count,
+                             std::vector<uint8_t>(bytes, bytes + count * sizeof(T))});
+    }
+
+    template <typename T>
+    void add(uint32_t id, const std::vector<T>& values) {
+        add(id, values.data(), values.size());
+    }
+
+    // Uses ids id (offsets) and id + 1 (characters)
+    void add_strings(uint32_t id, const std::vector<std::string>& strings);
+
+    // Written to path.tmp and renamed, a crash never leaves a torn snapshot behind
+    void write(const std::string& path) const;
+
+private:
+    struct Section {
+        uint32_t id;
+        uint32_t elem_size;
+        uint64_t count;
+        std::vector<uint8_t> bytes;
+    };
+
+    SnapshotKind kind_;
+    std::vector<Section> sections_;
+};
+
+/**
+ * @brief Maps a snapshot file and hands out its sections without copying them
+ * The header, the byte order and every section bound are checked before use
+ */
+class SnapshotReader {
+public:
+    SnapshotReader(const std::string& path, SnapshotKind kind);
+
+    template <typename T>
+    SnapshotArray<T> get(uint32_t id) const {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot sections hold plain data");
+        const SnapshotSection& section = find(id, sizeof(T));
+        return {reinterpret_cast<const T*>(file_.data() + section.offset), static_cast<size_t>(section.count)};
+    }
+
+    // Reads the pair of sections written by SnapshotWriter::add_strings
+    SnapshotStrings strings(uint32_t id) const;
+
+    const std::string& path() const { return path_; }
+
+private:
+    const SnapshotSection& find(uint32_t id, size_t elem_size) const;
+
+    std::string path_;
+    MappedFile file_;
+    const SnapshotSection* sections_ = nullptr;
+    uint32_t num_sections_ = 0;
+};
+
+}
+
+#endif // SNAPSHOT_H
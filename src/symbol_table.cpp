@@ -0,0 +1,51 @@
+#include "symbol_table.h"
+#include <stdexcept>
+
+namespace SS {
+
+SymbolIdx SymbolTable::intern(const std::string& name) {
+    auto it = index_.find(name);
+    if (it != index_.end()) {
+        return it->second;
+    }
+
+    if (!free_.empty()) {
+        SymbolIdx idx = free_.back();
+        free_.pop_back();
+        names_[idx] = name;
+        index_.emplace(name, idx);
+        return idx;
+    }
+
+    if (names_.size() >= INVALID_IDX) {
+        throw std::runtime_error("Symbol table is full, cannot intern: " + name);
+    }
+
+    SymbolIdx idx = static_cast<SymbolIdx>(names_.size());
+    names_.push_back(name);
+    index_.emplace(name, idx);
+    return idx;
+}
+
+SymbolIdx SymbolTable::find(const std::string& name) const {
+    auto it = index_.find(name);
+    if (it != index_.end()) {
+        return it->second;
+    }
+    return INVALID_IDX;
+}
+
+void SymbolTable::release(SymbolIdx idx) {
+    if (idx >= names_.size() || index_.erase(names_[idx]) == 0) {
+        return;
+    }
+    names_[idx].clear();
+    free_.push_back(idx);
+}
+
+void SymbolTable::reserve(size_t n) {
+    index_.reserve(n);
+    names_.reserve(n);
+}
+
+}
@@ -0,0 +1,47 @@
+#ifndef SYMBOL_TABLE_H
+#define SYMBOL_TABLE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "types.h"
+
+namespace SS {
+
+/**
+ * @brief Interns external string IDs into dense 32-bit indices
+ * Indices are assigned in insertion order starting at 0 and never change,
+ * unless the ID is released: its index then goes to the next new ID
+ */
+class SymbolTable {
+public:
+    // Return the index of name, adding it if it was not seen before
+    SymbolIdx intern(const std::string& name);
+
+    // Return the index of name, or INVALID_IDX if it is unknown
+    SymbolIdx find(const std::string& name) const;
+
+    // Get the external ID of an index
+    const std::string& name(SymbolIdx idx) const { return names_[idx]; }
+
+    // Forget the ID at idx and hand idx to the next new ID
+    void release(SymbolIdx idx);
+
+    // Number of indices in use or free for reuse
+    size_t size() const { return names_.size(); }
+
+    // All external IDs, ordered by index, released ones empty
+    const std::vector<std::string>& names() const { return names_; }
+
+    // Reserve room for n IDs
+    void reserve(size_t n);
+
+private:
+    std::unordered_map<std::string, SymbolIdx> index_;
+    std::vector<std::string> names_;
+    std::vector<SymbolIdx> free_;
+};
+
+}
+
+#endif // SYMBOL_TABLE_H
@@ -0,0 +1,60 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace SS {
+
+/**
+ * @brief Fixed-size pool of worker threads fed from a FIFO task queue
+ */
+class ThreadPool {
+public:
+    // Constructor - 0 threads means one per hardware thread
+    explicit ThreadPool(size_t num_threads = 0);
+
+    // Waits for queued tasks to finish, then joins the workers
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Queue a task and get a future for its result
+    template <typename F>
+    std::future<std::invoke_result_t<F>> submit(F&& task) {
+        using Result = std::invoke_result_t<F>;
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+        std::future<Result> future = packaged->get_future();
+        enqueue([packaged]() { (*packaged)(); });
+        return future;
+    }
+
+    // Run fn(i) for every i in [0, n) on the pool and wait for all of them
+    // Exceptions thrown by fn are rethrown here
+    void parallel_for(size_t n, const std::function<void(size_t)>& fn);
+
+    // Number of worker threads
+    size_t size() const { return workers_.size(); }
+
+private:
+    void enqueue(std::function<void()> task);
+    void worker_loop();
+
+    std::vector<std::thread> workers_;
+    std::queue<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+};
+
+}
+
+#endif // THREAD_POOL_H
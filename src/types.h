@@ -5,18 +5,32 @@
 #include <vector>
 #include <chrono>
 #include <map>
+#include <cstdint>
+#include <limits>
+#include <utility>
 
 namespace SS {
 // Type aliases for commonly used types in the shelf selection system
+// External IDs, only used at the DB/JSON boundary
 using RackID = std::string; // e.g., Rack_00001, Rack_00001, etc.
 using FaceID = std::string; // Cara_1, Cara_2, Cara_3, Cara_4.
 using ItemID = std::string; // e.g., 0N9X97RYEKKHWE1, LXJY4YBSWCX3KBF, etc.
 using OrderID = std::string; // e.g., ORD_013387_LXJY4YBS_000, ORD_013387_LXJY4YBS_001, etc.
 using TimePoint = std::chrono::system_clock::time_point;
 
-// Map from RackID and FaceID to list of OrderIDs assigned there
-using Taskpool = std::map<RackID, std::map<FaceID, std::vector<OrderID>>>;
-using Stock = std::map<RackID, std::map<FaceID, std::map<ItemID, int>>>;
+// Interned IDs, dense indices assigned by a SymbolTable at load time
+using SymbolIdx = std::uint32_t;
+using RackIdx = SymbolIdx;
+using FaceIdx = SymbolIdx;
+using ItemIdx = SymbolIdx;
+using OrderIdx = SymbolIdx;
+constexpr SymbolIdx INVALID_IDX = std::numeric_limits<SymbolIdx>::max();
+
+// Map from RackIdx and FaceIdx to list of OrderIdx assigned there
+using Taskpool = std::map<RackIdx, std::map<FaceIdx, std::vector<OrderIdx>>>;
+// Units picked at each (rack, face) of a taskpool
+using FaceUnits = std::map<std::pair<RackIdx, FaceIdx>, int>;
+using Stock = std::map<RackIdx, std::map<FaceIdx, std::map<ItemIdx, int>>>;
 }
 
-#endif // TYPES_H
\ No newline at end of file
+#endif // TYPES_H
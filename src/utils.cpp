@@ -1,28 +1,193 @@
 #include "utils.h"
-#include <sstream>
-#include <iomanip>
 #include <chrono>
+#include <stdexcept>
 
 namespace SS {
 
-TimePoint parse_iso8601(const std::string& date_str) {
-    std::tm tm = {};
-    std::istringstream ss(date_str);
-    ss >> std::get_time(&tm, "%Y-%m-%dT%H:%M:%S");
-    
-    if (ss.fail()) {
-        throw std::runtime_error("Failed to parse date string: " + date_str);
+namespace {
+
+// Days since 1970-01-01 of a proleptic Gregorian date (H. Hinnant's days_from_civil)
+int64_t days_from_civil(int64_t year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned year_of_era = static_cast<unsigned>(year - era * 400);
+    const unsigned day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const unsigned day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return era * 146097 + static_cast<int64_t>(day_of_era) - 719468;
+}
+
+// Inverse of days_from_civil
+void civil_from_days(int64_t days, int64_t& year, unsigned& month, unsigned& day) {
+    days += 719468;
+    const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const unsigned day_of_era = static_cast<unsigned>(days - era * 146097);
+    const unsigned year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+    const unsigned day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    const unsigned month_part = (5 * day_of_year + 2) / 153;
+    day = day_of_year - (153 * month_part + 2) / 5 + 1;
+    month = month_part < 10 ? month_part + 3 : month_part - 9;
+    year = static_cast<int64_t>(year_of_era) + era * 400 + (month <= 2);
+}
+
+bool is_leap(int64_t year) {
+    return year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+}
+
+unsigned days_in_month(int64_t year, unsigned month) {
+    static constexpr unsigned DAYS[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return month == 2 && is_leap(year) ? 29 : DAYS[month - 1];
+}
+
+[[noreturn]] void parse_failure(std::string_view date_str) {
+    throw std::runtime_error("Failed to parse date string: " + std::string(date_str));
+}
+
+// Read exactly count digits at pos
+bool read_digits(std::string_view str, size_t& pos, size_t count, unsigned& value) {
+    if (pos + count > str.size()) {
+        return false;
+    }
+    value = 0;
+    for (size_t i = 0; i < count; i++) {
+        const char c = str[pos + i];
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        value = value * 10 + static_cast<unsigned>(c - '0');
+    }
+    pos += count;
+    return true;
+}
+
+bool expect(std::string_view str, size_t& pos, char c) {
+    if (pos < str.size() && str[pos] == c) {
+        pos++;
+        return true;
+    }
+    return false;
+}
+
+// Write value as count digits, zero padded
+char* write_digits(char* out, unsigned value, size_t count) {
+    for (size_t i = count; i > 0; i--) {
+        out[i - 1] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+    return out + count;
+}
+
+}
+
+TimePoint parse_iso8601(std::string_view date_str) {
+    size_t pos = 0;
+    unsigned year, month, day, hour, minute, second;
+    if (!read_digits(date_str, pos, 4, year) || !expect(date_str, pos, '-')
+        || !read_digits(date_str, pos, 2, month) || !expect(date_str, pos, '-')
+        || !read_digits(date_str, pos, 2, day)
+        || !(expect(date_str, pos, 'T') || expect(date_str, pos, ' '))
+        || !read_digits(date_str, pos, 2, hour) || !expect(date_str, pos, ':')
+        || !read_digits(date_str, pos, 2, minute) || !expect(date_str, pos, ':')
+        || !read_digits(date_str, pos, 2, second)) {
+        parse_failure(date_str);
+    }
+    // A leap second rolls over into the next minute, as mktime did
+    if (month < 1 || month > 12 || day < 1 || day > days_in_month(year, month)
+        || hour > 23 || minute > 59 || second > 60) {
+        parse_failure(date_str);
+    }
+
+    int64_t nanoseconds = 0;
+    if (expect(date_str, pos, '.')) {
+        size_t digits = 0;
+        int64_t scale = 1000000000;
+        while (pos < date_str.size() && date_str[pos] >= '0' && date_str[pos] <= '9') {
+            if (++digits > 9) {
+                parse_failure(date_str);
+            }
+            scale /= 10;
+            nanoseconds += (date_str[pos] - '0') * scale;
+            pos++;
+        }
+        if (digits == 0) {
+            parse_failure(date_str);
+        }
+    }
+
+    int64_t offset_seconds = 0;
+    if (pos < date_str.size() && (date_str[pos] == '+' || date_str[pos] == '-')) {
+        const int sign = date_str[pos] == '-' ? -1 : 1;
+        pos++;
+        unsigned offset_hours, offset_minutes = 0;
+        if (!read_digits(date_str, pos, 2, offset_hours)) {
+            parse_failure(date_str);
+        }
+        if (pos < date_str.size()) {
+            expect(date_str, pos, ':');
+            if (!read_digits(date_str, pos, 2, offset_minutes)) {
+                parse_failure(date_str);
+            }
+        }
+        if (offset_hours > 23 || offset_minutes > 59) {
+            parse_failure(date_str);
+        }
+        offset_seconds = sign * static_cast<int64_t>(offset_hours * 3600 + offset_minutes * 60);
+    } else {
+        expect(date_str, pos, 'Z');
+    }
+    if (pos != date_str.size()) {
+        parse_failure(date_str);
+    }
+
+    const int64_t seconds = days_from_civil(year, month, day) * 86400
+        + hour * 3600 + minute * 60 + second - offset_seconds;
+    const std::chrono::nanoseconds since_epoch = std::chrono::seconds(seconds) + std::chrono::nanoseconds(nanoseconds);
+    return TimePoint(std::chrono::duration_cast<TimePoint::duration>(since_epoch));
+}
+
+size_t format_iso8601(const TimePoint& tp, char* buffer) {
+    const int64_t microseconds = std::chrono::duration_cast<std::chrono::microseconds>(tp.time_since_epoch()).count();
+    // Floor division, so dates before 1970 keep a positive time of day
+    int64_t seconds = microseconds / 1000000;
+    int64_t fraction = microseconds % 1000000;
+    if (fraction < 0) {
+        fraction += 1000000;
+        seconds--;
+    }
+    int64_t days = seconds / 86400;
+    int64_t second_of_day = seconds % 86400;
+    if (second_of_day < 0) {
+        second_of_day += 86400;
+        days--;
+    }
+    int64_t year;
+    unsigned month, day;
+    civil_from_days(days, year, month, day);
+    if (year < 0 || year > 9999) {
+        throw std::out_of_range("Date out of the YYYY range: " + std::to_string(year));
+    }
+
+    char* out = buffer;
+    out = write_digits(out, static_cast<unsigned>(year), 4);
+    *out++ = '-';
+    out = write_digits(out, month, 2);
+    *out++ = '-';
+    out = write_digits(out, day, 2);
+    *out++ = ' ';
+    out = write_digits(out, static_cast<unsigned>(second_of_day / 3600), 2);
+    *out++ = ':';
+    out = write_digits(out, static_cast<unsigned>(second_of_day / 60 % 60), 2);
+    *out++ = ':';
+    out = write_digits(out, static_cast<unsigned>(second_of_day % 60), 2);
+    if (fraction != 0) {
+        *out++ = '.';
+        out = write_digits(out, static_cast<unsigned>(fraction), 6);
     }
-    
-    return std::chrono::system_clock::from_time_t(std::mktime(&tm));
+    return static_cast<size_t>(out - buffer);
 }
 
 std::string format_iso8601(const TimePoint& tp) {
-    auto time = std::chrono::system_clock::to_time_t(tp);
-    std::tm tm = *std::localtime(&time);
-    std::ostringstream oss;
-    oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
-    return oss.str();
+    char buffer[ISO8601_MAX_LENGTH];
+    return std::string(buffer, format_iso8601(tp, buffer));
 }
 
 }
@@ -1,17 +1,29 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <cstddef>
 #include <string>
+#include <string_view>
 #include "types.h"
 
 namespace SS {
 
-//Parse ISO8601 date string to TimePoint
-TimePoint parse_iso8601(const std::string& date_str);
+// Longest format_iso8601 output, "YYYY-MM-DD HH:MM:SS.ffffff"
+constexpr size_t ISO8601_MAX_LENGTH = 26;
 
-// Format TimePoint to ISO8601 date string
+// Parse an ISO8601 date string to TimePoint, as UTC
+// Accepts "YYYY-MM-DDTHH:MM:SS" or a space instead of T, optional fractional seconds
+// (nanosecond digits at most) and an optional Z or +HH[:MM] / -HH[:MM] offset.
+// Locale and timezone free, does not allocate unless it throws
+TimePoint parse_iso8601(std::string_view date_str);
+
+// Format TimePoint to ISO8601 date string, as UTC: "YYYY-MM-DD HH:MM:SS" plus ".ffffff"
+// when the microseconds are not zero
 std::string format_iso8601(const TimePoint& tp);
 
+// Same into buffer, which must hold ISO8601_MAX_LENGTH chars; returns the length written
+size_t format_iso8601(const TimePoint& tp, char* buffer);
+
 }
 
 #endif // UTILS_H